@@ -0,0 +1,5 @@
+#include "bvh.h"
+#include "bvh.tcc"
+
+template class BoundingVolumeHierarchy<float, 3u>;
+template class BoundingVolumeHierarchy<float, 3u, Sphere<float, 3u>>;
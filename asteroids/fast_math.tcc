@@ -0,0 +1,141 @@
+#ifndef FAST_MATH_TCC
+#define FAST_MATH_TCC
+
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "fast_math.h"
+
+// sin/cos: the angle is reduced to [-PI/4, PI/4] by subtracting a multiple k of PI/2,
+// the polynomials are evaluated there and the quadrant k mod 4 selects and negates the results
+// the accurate tier subtracts k * PI/2 in three parts (Cody-Waite), so that the reduction stays exact
+// for large angles, and uses the minimax polynomials of the Cephes library
+template <class FLOAT_TYPE, Accuracy ACCURACY>
+void FastMath<FLOAT_TYPE, ACCURACY>::sincos(FLOAT_TYPE angle, FLOAT_TYPE & sine, FLOAT_TYPE & cosine) {
+  if constexpr (! APPROXIMATED) {
+    using std::sin, std::cos;
+    sine = sin(angle);
+    cosine = cos(angle);
+  } else {
+    FLOAT_TYPE scaled = angle * FLOAT_TYPE(0.636619772367581343); // 2 / PI
+    int quadrant = static_cast<int>( scaled + (scaled >= 0 ? FLOAT_TYPE(0.5) : FLOAT_TYPE(-0.5)) );
+    FLOAT_TYPE k = static_cast<FLOAT_TYPE>(quadrant);
+    FLOAT_TYPE x;
+    if constexpr (ACCURACY == Accuracy::accurate) {
+      x = ((angle - k * FLOAT_TYPE(1.5703125)) - k * FLOAT_TYPE(4.837512969970703125e-4)) - k * FLOAT_TYPE(7.54978995489188216e-8);
+    } else {
+      x = angle - k * FLOAT_TYPE(1.57079632679489662);
+    }
+    FLOAT_TYPE x2 = x * x;
+    FLOAT_TYPE s, c;
+    if constexpr (ACCURACY == Accuracy::accurate) {
+      s = x + x * x2 * (FLOAT_TYPE(-1.6666654611e-1) + x2 * (FLOAT_TYPE(8.3321608736e-3) + x2 * FLOAT_TYPE(-1.9515295891e-4)));
+      c = FLOAT_TYPE(1.0) - FLOAT_TYPE(0.5) * x2
+          + x2 * x2 * (FLOAT_TYPE(4.166664568298827e-2) + x2 * (FLOAT_TYPE(-1.388731625493765e-3) + x2 * FLOAT_TYPE(2.443315711809948e-5)));
+    } else {
+      s = x + x * x2 * (FLOAT_TYPE(-1.666067e-1) + x2 * FLOAT_TYPE(8.12e-3));
+      c = FLOAT_TYPE(1.0) + x2 * (FLOAT_TYPE(-4.998e-1) + x2 * FLOAT_TYPE(4.052e-2));
+    }
+    bool swap = quadrant & 1;
+    sine = (swap ? c : s);
+    cosine = (swap ? s : c);
+    sine = (quadrant & 2) ? -sine : sine;
+    cosine = ((quadrant + 1) & 2) ? -cosine : cosine;
+  }
+}
+
+// atan2: the quotient t = min(|x|, |y|) / max(|x|, |y|) in [0, 1] is mapped to the arc tangent in [0, PI/4],
+// the signs of x and y and which of them is larger select the octant of the result
+// the accurate tier additionally reduces t to [0, tan(PI/8)] with atan(t) = PI/4 + atan((t - 1) / (t + 1))
+template <class FLOAT_TYPE, Accuracy ACCURACY>
+FLOAT_TYPE FastMath<FLOAT_TYPE, ACCURACY>::atan2(FLOAT_TYPE y, FLOAT_TYPE x) {
+  if constexpr (! APPROXIMATED) {
+    using std::atan2;
+    return atan2(y, x);
+  } else {
+    constexpr FLOAT_TYPE PI_4 = FLOAT_TYPE(0.785398163397448310);
+    FLOAT_TYPE abs_x = std::fabs(x);
+    FLOAT_TYPE abs_y = std::fabs(y);
+    FLOAT_TYPE maximum = abs_x > abs_y ? abs_x : abs_y;
+    FLOAT_TYPE minimum = abs_x > abs_y ? abs_y : abs_x;
+    // any positive divisor works for x = y = 0, but a division by 1 would be optimized into a branch
+    FLOAT_TYPE t = minimum / (maximum > FLOAT_TYPE(0.0) ? maximum : std::numeric_limits<FLOAT_TYPE>::min());
+    FLOAT_TYPE angle;
+    if constexpr (ACCURACY == Accuracy::accurate) {
+      // reduced is 1 for t >= tan(PI/8) and 0 otherwise, computed by truncation because
+      // a selection would be split into two branches by the optimizer
+      FLOAT_TYPE reduced = static_cast<FLOAT_TYPE>( static_cast<int>(t + FLOAT_TYPE(0.585786437626904951)) );
+      FLOAT_TYPE offset = reduced * PI_4;
+      t = (t - reduced) / (reduced * t + FLOAT_TYPE(1.0));
+      FLOAT_TYPE t2 = t * t;
+      angle = offset + t + t * t2 * (FLOAT_TYPE(-3.33329491539e-1) + t2 * (FLOAT_TYPE(1.99777106478e-1)
+                                     + t2 * (FLOAT_TYPE(-1.38776856032e-1) + t2 * FLOAT_TYPE(8.05374449538e-2))));
+    } else {
+      angle = PI_4 * t - t * (t - FLOAT_TYPE(1.0)) * (FLOAT_TYPE(0.2447) + FLOAT_TYPE(0.0663) * t);
+    }
+    // the conditional operations are written as selections of operands (e.g. offset + sign * angle),
+    // because the compiler does not speculate conditional floating point operations and would keep the branches
+    bool steep = abs_y > abs_x;
+    angle = (steep ? FLOAT_TYPE(2.0) * PI_4 : FLOAT_TYPE(0.0)) + (steep ? FLOAT_TYPE(-1.0) : FLOAT_TYPE(1.0)) * angle;
+    bool left = x < FLOAT_TYPE(0.0);
+    angle = (left ? FLOAT_TYPE(4.0) * PI_4 : FLOAT_TYPE(0.0)) + (left ? FLOAT_TYPE(-1.0) : FLOAT_TYPE(1.0)) * angle;
+    return std::copysign(angle, y);
+  }
+}
+
+// rsqrt: the initial guess halves the exponent by an integer shift of the bit pattern,
+// every Newton step y = y * (1.5 - 0.5 * value * y * y) roughly squares the relative error
+template <class FLOAT_TYPE, Accuracy ACCURACY>
+FLOAT_TYPE FastMath<FLOAT_TYPE, ACCURACY>::rsqrt(FLOAT_TYPE value) {
+  if constexpr (! APPROXIMATED) {
+    using std::sqrt;
+    return FLOAT_TYPE(1.0) / sqrt(value);
+  } else {
+    static_assert(std::is_same_v<FLOAT_TYPE, float> || std::is_same_v<FLOAT_TYPE, double>);
+    FLOAT_TYPE y;
+    if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+      y = std::bit_cast<float>( std::uint32_t(0x5f375a86) - (std::bit_cast<std::uint32_t>(value) >> 1) );
+    } else {
+      y = std::bit_cast<double>( std::uint64_t(0x5fe6eb50c7b537a9) - (std::bit_cast<std::uint64_t>(value) >> 1) );
+    }
+    constexpr int iterations = ACCURACY == Accuracy::fast ? 1 : (std::is_same_v<FLOAT_TYPE, float> ? 3 : 4);
+    FLOAT_TYPE half = FLOAT_TYPE(0.5) * value;
+    for (int i = 0; i < iterations; i++) {
+      y = y * (FLOAT_TYPE(1.5) - half * y * y);
+    }
+    return y;
+  }
+}
+
+template <class FLOAT_TYPE, Accuracy ACCURACY>
+void FastMath<FLOAT_TYPE, ACCURACY>::sincos(std::span<const FLOAT_TYPE> angles, std::span<FLOAT_TYPE> sines, std::span<FLOAT_TYPE> cosines) {
+  assert(sines.size() >= angles.size() && cosines.size() >= angles.size());
+  FLOAT_TYPE * sine = sines.data();
+  FLOAT_TYPE * cosine = cosines.data();
+  for (size_t i = 0u; i < angles.size(); i++) {
+    sincos(angles[i], sine[i], cosine[i]);
+  }
+}
+
+template <class FLOAT_TYPE, Accuracy ACCURACY>
+void FastMath<FLOAT_TYPE, ACCURACY>::atan2(std::span<const FLOAT_TYPE> y, std::span<const FLOAT_TYPE> x, std::span<FLOAT_TYPE> angles) {
+  assert(x.size() == y.size() && angles.size() >= y.size());
+  FLOAT_TYPE * angle = angles.data();
+  for (size_t i = 0u; i < y.size(); i++) {
+    angle[i] = atan2(y[i], x[i]);
+  }
+}
+
+template <class FLOAT_TYPE, Accuracy ACCURACY>
+void FastMath<FLOAT_TYPE, ACCURACY>::rsqrt(std::span<const FLOAT_TYPE> values, std::span<FLOAT_TYPE> results) {
+  assert(results.size() >= values.size());
+  FLOAT_TYPE * result = results.data();
+  for (size_t i = 0u; i < values.size(); i++) {
+    result[i] = rsqrt(values[i]);
+  }
+}
+
+#endif
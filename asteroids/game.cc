@@ -1,14 +1,32 @@
 #include "game.h"
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+#include <random>
 
 const int SCREEN_WIDTH = 1024;
 const int SCREEN_HEIGHT = (SCREEN_WIDTH * 3) / 4;
 
-void displacement_fix(Body2df * body, float seconds) {
-  float x = body->get_position()[0];
-  float y = body->get_position()[1];
-  Vector2df new_position = body->get_position();
+// one engine for the whole game, which Game(unsigned seed) seeds
+static std::mt19937 gen{std::random_device{}()};
+
+// returns a random number in [0, 0.99) as GameFloat, so that the arithmetic with it is done in GameFloat,
+// it is made from the upper 16 bits of gen instead of with a std::uniform_real_distribution,
+// whose algorithm differs between the standard libraries
+GameFloat random_number() {
+  std::uint32_t bits = gen() >> 16u;
+#ifdef GAME_FIXED_POINT
+  GameFloat fraction = GameFloat::from_raw(static_cast<std::int64_t>(bits) << 16u); // bits / 2^16 in Q32.32
+#else
+  GameFloat fraction = bits / 65536.0f;
+#endif
+  return GameFloat(0.99) * fraction;
+}
+
+void displacement_fix(GameBody * body, GameFloat seconds) {
+  GameFloat x = body->get_position()[0];
+  GameFloat y = body->get_position()[1];
+  GameVector new_position = body->get_position();
   
   if ( x < 0 ) {
     new_position[0] = SCREEN_WIDTH;
@@ -28,26 +46,26 @@ void displacement_fix(Body2df * body, float seconds) {
 
 Asteroid::Asteroid(short size)
   : TypedBody( BodyType::asteroid,
-               Body2df{ BoundingVolume2df{ Vector2df{ 128.0f + 768.0f * dis(gen), 64.0f + 640.0f * dis(gen) }, size * 11.0f },
-                         Vector2df{ 0.5f - dis(gen), 0.5f - dis(gen) },
+               GameBody{ GameBoundingVolume{ GameVector{ 128.0f + 768.0f * random_number(), 64.0f + 640.0f * random_number() }, size * 11.0f },
+                         GameVector{ 0.5f - random_number(), 0.5f - random_number() },
                          348.0, 0.0, 0.0, displacement_fix } ),
     size(size),
-    rock_type( std::trunc(4 * dis(gen)) )
+    rock_type( static_cast<short>(gen() >> 30u) ) // the upper two bits
   {
 
     velocity /= velocity.length();
     if (size == 3) { /* 5 - 10 s to cross the screen */
-      velocity *= 768.0f / 10.0f +  768.0f / 10.0f * dis(gen);
+      velocity *= 768.0f / 10.0f +  768.0f / 10.0f * random_number();
     } else if (size == 2) { /* 4 - 8s */
-      velocity *= 768.0f / 8.0f +  768.0f / 8.0f * dis(gen);
+      velocity *= 768.0f / 8.0f +  768.0f / 8.0f * random_number();
     } else if (size == 1) { /* 3 - 6s */
-      velocity *= 768.0f / 6.0f +  768.0f / 6.0f * dis(gen);
+      velocity *= 768.0f / 6.0f +  768.0f / 6.0f * random_number();
     }
 
   }
 
 
-Asteroid::Asteroid(short size, Vector2df position ) : Asteroid(size) {
+Asteroid::Asteroid(short size, GameVector position ) : Asteroid(size) {
   set_position(position);
 }
   
@@ -59,13 +77,13 @@ short Asteroid::get_rock_type() const {
   return rock_type;
 }
 
-bool Spaceship::shoot(Physics2df & physics) {
+bool Spaceship::shoot(GamePhysics & physics) {
   if (shoot_cooldown.get_time() <= 0.0 && ! is_marked_for_deletion() && ! in_hyperspace) {
     size_t i = 0;
     for ( ; i < torpedos.size() && ! torpedos[i].is_marked_for_deletion(); i++ );
     
     if ( i < torpedos.size() ) {
-      torpedos[i] = Torpedo{ get_position(), get_angle(), get_velocity()};
+      torpedos[i] = Torpedo{ get_position(), get_direction(), get_velocity()};
       physics.add_body(&torpedos[i]);
       shoot_cooldown.set_time(0.1);
       return true;
@@ -87,7 +105,7 @@ bool Spaceship::can_accelerate(float tick_time) {
 void Spaceship::accelerate(float tick_time) {
   if (can_accelerate(tick_time) ) {
     accelerate_timer = 0.25f - tick_time;
-    Body2df::accelerate(MAX_SPEED, std::min(0.25f, tick_time) );
+    GameBody::accelerate(MAX_SPEED, std::min(0.25f, tick_time) );
   }
 }
 
@@ -96,9 +114,9 @@ void Spaceship::deaccelerate(float tick_time) {
   if (! is_accelerating() && ! is_marked_for_deletion() && ! in_hyperspace) {
     // jede s ein 1/16 von der maximalen Geschwindigkeit abziehen
     const float speed = MAX_SPEED / 16.0f;
-    float current_speed = velocity.length();
+    GameFloat current_speed = velocity.length();
     if (current_speed > 0.0) {
-      float deaccelerate_factor = tick_time * speed;
+      GameFloat deaccelerate_factor = tick_time * speed;
       set_velocity(velocity - deaccelerate_factor * (1.0f / current_speed) * velocity );
     }
   }
@@ -120,10 +138,10 @@ void Spaceship::turn_right(float tick_time) {
   }
 }
 
-void Spaceship::spaceship_fix(Body2df * body, float seconds) {
+void Spaceship::spaceship_fix(GameBody * body, GameFloat seconds) {
   displacement_fix(body, seconds);
   Spaceship * ship = static_cast<Spaceship *>(body);
-  ship->pass_time(seconds);
+  ship->pass_time(static_cast<float>(seconds));
 }
 
 void Spaceship::pass_time(float seconds) {
@@ -132,7 +150,7 @@ void Spaceship::pass_time(float seconds) {
   }
   shoot_cooldown.tick(seconds);
   if (accelerate_timer > 0.0) {
-    Body2df::accelerate(MAX_SPEED, seconds);
+    GameBody::accelerate(MAX_SPEED, seconds);
     accelerate_timer -= seconds;
   }
   if (turn_timer > 0.0) {
@@ -147,8 +165,8 @@ bool Spaceship::is_in_hyperspace() {
 void Spaceship::jump_into_hyperspace(Game & game) {
   if ( ! in_hyperspace ) {
     set_velocity({0.0f, 0.0f});
-    set_position({512.0f + 348.0f * (0.5f - dis(gen)) , 368.0f + 256.0f * (0.5f - dis(gen)) });
-    if ( dis(gen) < 0.25f ||  game.no_of_asteroids > (dis(gen) * 15.0f + 4.0f) ) {
+    set_position({512.0f + 348.0f * (0.5f - random_number()) , 368.0f + 256.0f * (0.5f - random_number()) });
+    if ( random_number() < 0.25f ||  game.no_of_asteroids > (random_number() * 15.0f + 4.0f) ) {
       game.destroy_spaceship(); 
     } else {
       in_hyperspace = true;
@@ -159,7 +177,7 @@ void Spaceship::jump_into_hyperspace(Game & game) {
 
 void Spaceship::jump_out_of_hyperspace(Game & game) {
   if ( in_hyperspace && hyperspace_delay <= 0.0 && ! is_marked_for_deletion() ) {
-    BoundingVolume2df bounding{ get_position(), 50.0f };
+    GameBoundingVolume bounding{ get_position(), 50.0f };
     if  ( game.area_free_of_asteroids( &bounding ) ) {
       in_hyperspace = false;
     }
@@ -167,7 +185,7 @@ void Spaceship::jump_out_of_hyperspace(Game & game) {
 }
 
 bool Saucer::shoot(Game & game) {
-  float direction_angle;
+  GameFloat direction_angle;
   if (shoot_cooldown.get_time() <= 0.0 && ! is_marked_for_deletion()) {
     size_t i = 0;
     for ( ; i < torpedos.size() && ! torpedos[i].is_marked_for_deletion(); i++ );
@@ -176,11 +194,11 @@ bool Saucer::shoot(Game & game) {
       if ( size == 0 && precise_shoot_counter <= 0 && ! game.ship.is_marked_for_deletion() ) {
         auto direct_shot = ( game.ship.get_position() - this->get_position() );
         direct_shot *= 1.0f /  direct_shot.length();
-        torpedos[i] = Torpedo{ get_position(), direct_shot.angle(0.0f,1.0f), get_velocity() };
+        torpedos[i] = Torpedo{ get_position(), direct_shot, get_velocity() };
         precise_shoot_counter = 6;
       } else {
-        direction_angle = PI * (1.0f - 2.0f * static_cast<float>(dis(gen)));
-        torpedos[i] = Torpedo{ get_position(), direction_angle, get_velocity()};
+        direction_angle = GameFloat(PI) * (1.0f - 2.0f * random_number());
+        torpedos[i] = Torpedo{ get_position(), GameVector(direction_angle), get_velocity()};
         precise_shoot_counter--;
       }
       game.physics.add_body(&torpedos[i]);
@@ -195,7 +213,7 @@ bool Saucer::shoot(Game & game) {
 
 void Saucer::change_direction() {
   if ( change_direction_cooldown.get_time() < 0.0f && ! is_marked_for_deletion()) {
-    float random = dis(gen);
+    GameFloat random = random_number();
     if ( random < 0.33 ) {
       velocity[1] = 0.0f;
     } else if (random < 0.66) {
@@ -221,9 +239,9 @@ void Saucer::pass_time(float seconds, Game & game) {
 
 
 
-void Game::saucer_fix(Body2df * body, float seconds) {
+void Game::saucer_fix(GameBody * body, GameFloat seconds) {
   Saucer * saucer = static_cast<Saucer *>(body);
-  float x = saucer->get_position()[0];
+  GameFloat x = saucer->get_position()[0];
   
   if ( x > SCREEN_WIDTH || x < 0.0f ) {
     saucer->mark_for_deletion();
@@ -232,7 +250,7 @@ void Game::saucer_fix(Body2df * body, float seconds) {
     displacement_fix(body, seconds);
   }
 
-  saucer->pass_time(seconds, *this);
+  saucer->pass_time(static_cast<float>(seconds), *this);
 }
 
 short Saucer::get_size() const {
@@ -250,6 +268,10 @@ Game::Game() {
   ship.mark_for_deletion();
 }
 
+Game::Game(unsigned seed) : Game() {
+  gen.seed(seed);
+}
+
 void Game::spawn_asteroids() {
   saucer.clear_torpedos();
   next_asteroid = 0;
@@ -258,20 +280,20 @@ void Game::spawn_asteroids() {
     asteroid = Asteroid{};
   }
   for (size_t i = 0; i < no_of_asteroids; i++) {
-    Vector2df position = {0, 0};
-    float random = dis(gen);
+    GameVector position = {0, 0};
+    GameFloat random = random_number();
     if ( random < 0.25 ) {
-      position[0] = 128.0f * dis(gen);
-      position[1] = 768.0f * dis(gen);
+      position[0] = 128.0f * random_number();
+      position[1] = 768.0f * random_number();
     } else if ( random < 0.5) {
-      position[0] = 1024.0f - 128.0f * dis(gen);
-      position[1] = 768.0f * dis(gen);
+      position[0] = 1024.0f - 128.0f * random_number();
+      position[1] = 768.0f * random_number();
     } else if ( random < 0.75 ) {
-      position[0] = 1024.0f * dis(gen);
-      position[1] = 98.0f * dis(gen);
+      position[0] = 1024.0f * random_number();
+      position[1] = 98.0f * random_number();
     } else {
-      position[0] = 1024.0f * dis(gen);
-      position[1] = 768.0f - 98.0f * dis(gen);      
+      position[0] = 1024.0f * random_number();
+      position[1] = 768.0f - 98.0f * random_number();      
     }
     asteroids[next_asteroid] = Asteroid{3, position};
     physics.add_body(&asteroids[next_asteroid++]);
@@ -287,7 +309,7 @@ void Game::spawn_asteroids() {
   game_events.push_back(GameEvent::next_level_started);
 }
 
-Physics2df & Game::get_physics() {
+GamePhysics & Game::get_physics() {
   return physics;
 }
 
@@ -407,9 +429,9 @@ Spaceship & Game::get_ship() {
   return ship;
 }
 
-bool Game::area_free_of_asteroids(BoundingVolume2df * bounding) {
+bool Game::area_free_of_asteroids(GameBoundingVolume * bounding) {
   return physics.is_area_free_of_bodies(bounding,
-     [bounding](Body2df * body) -> bool { TypedBody * typed_body = static_cast<TypedBody *>(body);  
+     [bounding](GameBody * body) -> bool { TypedBody * typed_body = static_cast<TypedBody *>(body);  
                                           return ! typed_body->is_marked_for_deletion()
                                                     && typed_body->get_type() == BodyType::asteroid;
                                         });                                
@@ -417,9 +439,9 @@ bool Game::area_free_of_asteroids(BoundingVolume2df * bounding) {
 
 void Game::spawn_ship() {
   saucer.mark_for_deletion();
-  BoundingVolume2df bounding{ Vector2df{512.0f, 368.0f}, 75.0f };
+  GameBoundingVolume bounding{ GameVector{512.0f, 368.0f}, 75.0f };
   if ( area_free_of_asteroids( &bounding ) ) {
-    ship = Spaceship{ Vector2df{512.0f, 368.0f} };
+    ship = Spaceship{ GameVector{512.0f, 368.0f} };
     physics.add_body(&ship);
   }
   game_events.push_back( GameEvent::new_ship_spawned );
@@ -474,15 +496,15 @@ void Game::new_saucer() {
     if ( time_since_start_of_level > 35.0f || score >= 30000LL) {
       type = 0;
     }
-    Vector2df position = { 10.0,   dis(gen) * (SCREEN_HEIGHT / 10 + (6 * SCREEN_HEIGHT) / 8)  };
-    Vector2df velocity = { 1024.0f / 8.0f, 0.0 };
-    BoundingVolume2df body{position, 10.0f};
+    GameVector position = { 10.0f,   random_number() * (SCREEN_HEIGHT / 10 + (6 * SCREEN_HEIGHT) / 8)  };
+    GameVector velocity = { 1024.0f / 8.0f, 0.0 };
+    GameBoundingVolume body{position, 10.0f};
     if ( area_free_of_asteroids(&body) ) {
-      if ( dis(gen) > 0.5 ) {
+      if ( random_number() > 0.5 ) {
         position[0] = SCREEN_WIDTH - 10.0;
         velocity[0] = -velocity[0];
       }
-      saucer = Saucer{type, position, [&] (Body2df * body, float time)-> void { this->saucer_fix(body, time); } };
+      saucer = Saucer{type, position, [&] (GameBody * body, GameFloat time)-> void { this->saucer_fix(body, time); } };
       saucer.set_velocity(velocity);
       physics.add_body(&saucer);
       saucer_timer = 5.0;
@@ -508,7 +530,7 @@ std::vector<GameEvent> & Game::get_game_events() {
 }
 
 
-void Game::resolve_collision(Body2df *body1, Body2df *body2) {
+void Game::resolve_collision(GameBody *body1, GameBody *body2) {
   TypedBody *typed_body1 = static_cast<TypedBody *>(body1);
   TypedBody *typed_body2 = static_cast<TypedBody *>(body2);
   Asteroid *asteroid;
@@ -559,7 +581,7 @@ void Game::resolve_collision(Body2df *body1, Body2df *body2) {
   }    
 }
   
-bool Game::check_collision(Body2df *body1, Body2df *body2) {
+bool Game::check_collision(GameBody *body1, GameBody *body2) {
   TypedBody *typed_body1 = static_cast<TypedBody *>(body1);
   TypedBody *typed_body2 = static_cast<TypedBody *>(body2);
   bool torpedo = typed_body1->get_type() == BodyType::torpedo
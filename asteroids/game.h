@@ -4,7 +4,6 @@
 #include <vector>  
 #include <utility>
 #include <array>
-#include <random>
 #include "timer.h"
 #include "physics.h" 
 
@@ -20,20 +19,35 @@ enum class GameEvent : short { small_asteroid_destroyed, medium_asteroid_destroy
                                 next_level_started, new_ship_spawned, torpedo_fired };
 
 
-class Game;
+// the scalar type of the bodies: float, or Q32_32 when compiled with -DGAME_FIXED_POINT,
+// which makes a game started with the same seed and played with the same inputs bit-identical on every build
+// with GCC or Clang (see Fixed), since all arithmetic on positions and velocities is done in GameFloat
+// and the random numbers are made from the bits of std::mt19937, which the standard specifies exactly
+#ifdef GAME_FIXED_POINT
+typedef Q32_32 GameFloat;
+#else
+typedef float GameFloat;
+#endif
+typedef Vector<GameFloat, 2u> GameVector;
+typedef BoundingVolumeCircle<GameFloat, 2u> GameBoundingVolume;
+typedef Body<GameFloat, 2u, GameBoundingVolume> GameBody;
+typedef Physics<GameFloat, 2u, GameBoundingVolume> GamePhysics;
 
-void displacement_fix(Body2df * body, float seconds = 1.0);
+// returns the float coordinates of a position or direction, e.g. for rendering
+inline Vector2df to_float(const GameVector & vector) {
+  return { static_cast<float>(vector[0]), static_cast<float>(vector[1]) };
+}
 
-static std::random_device rd;
-static std::mt19937 gen(rd());
-static std::uniform_real_distribution<float> dis(0.0, 0.99);
+class Game;
+
+void displacement_fix(GameBody * body, GameFloat seconds = 1.0);
 
 // the base class of all game objects
-class TypedBody : public Body2df {
+class TypedBody : public GameBody {
 protected:
   BodyType type;
 public:
-  TypedBody(BodyType type, Body2df body) : Body2df(body), type(type) { }
+  TypedBody(BodyType type, GameBody body) : GameBody(body), type(type) { }
 
   BodyType get_type() {
     return type;
@@ -46,7 +60,7 @@ short rock_type; // one of the four different rock types
 public:
   Asteroid(short size = 3);
 
-  Asteroid(short size, Vector2df position );
+  Asteroid(short size, GameVector position );
   
   short get_size() const;
   
@@ -58,15 +72,16 @@ static constexpr float MAX_SPEED = 768.0f;
 public:
 
   Torpedo()
-    : Torpedo( Vector2df{0.0f, 0.0f}, 0.0f, Vector2df{1.0f, 1.0f} ) 
+    : Torpedo( GameVector{0.0f, 0.0f}, GameVector{1.0f, 0.0f}, GameVector{1.0f, 1.0f} ) 
     {  }
 
 
-  Torpedo(Vector2df position, float angle, Vector2df velocity)
+  // direction is the unit vector in which the torpedo is fired
+  Torpedo(GameVector position, GameVector direction, GameVector velocity)
     : TypedBody(BodyType::torpedo, 
-                Body2df{ BoundingVolume2df{position + 14.0f * Vector2df( angle ), 1.0},
-                         velocity + 1.1f * MAX_SPEED / 2.0f * Vector2df( angle ),
-                         MAX_SPEED, 0.0f, angle, displacement_fix} ) 
+                GameBody{ GameBoundingVolume{position + GameFloat(14.0f) * direction, 1.0},
+                         velocity + GameFloat(1.1f * MAX_SPEED / 2.0f) * direction,
+                         MAX_SPEED, 0.0f, direction, displacement_fix} ) 
     { set_time_to_delete(1.2f);
     }
 
@@ -82,18 +97,18 @@ class Spaceship : public TypedBody {
   bool in_hyperspace = false;
 public:
   static constexpr float MAX_SPEED = 384.0f;
-  static void spaceship_fix(Body2df * body, float seconds);
-  Spaceship(Vector2df position)
+  static void spaceship_fix(GameBody * body, GameFloat seconds);
+  Spaceship(GameVector position)
     : TypedBody(BodyType::spaceship,
-                Body2df{ BoundingVolume2df{position, 10.0f},
-                         Vector2df{0.0f, 0.0f}, MAX_SPEED, 0.0f, 0.0f, spaceship_fix} )
+                GameBody{ GameBoundingVolume{position, 10.0f},
+                         GameVector{0.0f, 0.0f}, MAX_SPEED, 0.0f, 0.0f, spaceship_fix} )
     {
       for (Torpedo & torpedo : torpedos) {
         torpedo.mark_for_deletion();
       }
     }
   bool contains_torpedo(Torpedo * torpedo);
-  bool shoot(Physics2df & physics);
+  bool shoot(GamePhysics & physics);
   bool is_in_hyperspace();
   void pass_time(float seconds);
   bool can_accelerate(float seconds);
@@ -111,10 +126,10 @@ public:
 class SpaceshipDebris : public TypedBody {
 public:
   static constexpr float TIME_TO_DELETE = 3.0;
-  SpaceshipDebris(Vector2df position = Vector2df{0.0, 0.0}, float angle = 0.0)
+  SpaceshipDebris(GameVector position = GameVector{0.0, 0.0}, GameFloat angle = 0.0)
     : TypedBody(BodyType::spaceship_debris,
-                Body2df{ BoundingVolume2df{position, 0.0},
-                         Vector2df{0.0, 0.0}, 384.0, 0.0, angle, displacement_fix} )
+                GameBody{ GameBoundingVolume{position, 0.0},
+                         GameVector{0.0, 0.0}, 384.0, 0.0, angle, displacement_fix} )
   {
     set_time_to_delete(TIME_TO_DELETE);
   }
@@ -128,10 +143,10 @@ class Saucer : public TypedBody {
   short size; // 0 = small, 1 = big
   char precise_shoot_counter = 0; // every sixth torpedo of a small saucer shoots in direction to the spaceship
 public:
-  Saucer(short size = 1, Vector2df position = Vector2df{0.0, 0.0}, std::function<void(Body2df *, float)> saucer_fix = displacement_fix)
+  Saucer(short size = 1, GameVector position = GameVector{0.0, 0.0}, std::function<void(GameBody *, GameFloat)> saucer_fix = displacement_fix)
     : TypedBody(BodyType::saucer,
-                Body2df{ BoundingVolume2df{position, static_cast<float>(size == 1 ? 15 : 7) },
-                         Vector2df{0.0, 0.0}, 200.0, 0.0, 0.0, saucer_fix} ) 
+                GameBody{ GameBoundingVolume{position, GameFloat(size == 1 ? 15 : 7) },
+                         GameVector{0.0, 0.0}, 200.0, 0.0, 0.0, saucer_fix} ) 
     {
       this->size = size;
       for (Torpedo & torpedo : torpedos) {
@@ -153,10 +168,10 @@ public:
 class Debris : public TypedBody {
 public:
   static constexpr float TIME_TO_DELETE = 0.6f;
-  Debris(Vector2df position = Vector2df{0.0, 0.0}, float angle = 0.0f)
+  Debris(GameVector position = GameVector{0.0, 0.0}, GameFloat angle = 0.0f)
     : TypedBody( BodyType::debris,
-                 Body2df{ BoundingVolume2df{position, 0.0f},
-                          Vector2df{0.0, 0.0}, 0.0f, 0.0f, angle, displacement_fix })
+                 GameBody{ GameBoundingVolume{position, 0.0f},
+                          GameVector{0.0, 0.0}, 0.0f, 0.0f, angle, displacement_fix })
   {
     set_time_to_delete(TIME_TO_DELETE);
   }
@@ -179,11 +194,11 @@ class Game {
   static constexpr short NO_OF_SHIPS_AT_START = 3;
   static constexpr short NO_OF_ASTEROIDS_AT_START = 4;
   static constexpr short MAXIMUM_ASTEROIDS_SPAWNING = 11;
-  void saucer_fix(Body2df * body, float seconds);
-  Physics2df physics{ [&](Body2df * b1, Body2df * b2) -> bool { return this->check_collision(b1, b2); },
-                      [&](Body2df * b1, Body2df * b2) -> void { this->resolve_collision(b1, b2); }};
-  Spaceship ship{ Vector2df{512.0, 368.0} };
-  Saucer saucer{1, Vector2df{70.0, 70.0}, [&] (Body2df * body, float time)-> void { this->saucer_fix(body, time); } };
+  void saucer_fix(GameBody * body, GameFloat seconds);
+  GamePhysics physics{ [&](GameBody * b1, GameBody * b2) -> bool { return this->check_collision(b1, b2); },
+                      [&](GameBody * b1, GameBody * b2) -> void { this->resolve_collision(b1, b2); }};
+  Spaceship ship{ GameVector{512.0, 368.0} };
+  Saucer saucer{1, GameVector{70.0, 70.0}, [&] (GameBody * body, GameFloat time)-> void { this->saucer_fix(body, time); } };
   SpaceshipDebris debris;
   std::array<Asteroid, MAXIMUM_ASTEROIDS_SPAWNING * 4> asteroids; // maximal possible asteroids, in original it is 26
   std::array<Debris, 10> debrises;
@@ -197,8 +212,8 @@ class Game {
   Asteroid * get_next_asteroid();
   Debris * get_next_debris();
   // check_collision must not have side effects
-  bool check_collision(Body2df *body1, Body2df *body2);
-  void resolve_collision(Body2df *body1, Body2df *body2);
+  bool check_collision(GameBody *body1, GameBody *body2);
+  void resolve_collision(GameBody *body1, GameBody *body2);
   void destroy_asteroid(Asteroid * asteroid);
   void spawn_ship();
   void spawn_asteroids();
@@ -214,9 +229,12 @@ class Game {
   float new_asteroids_spawn_timer = 0.0;
   void new_saucer();
   void add_score(long long points);
-  bool area_free_of_asteroids(BoundingVolume2df * bounding);
+  bool area_free_of_asteroids(GameBoundingVolume * bounding);
 public:
   Game();
+
+  // starts the random numbers with seed, so that the same inputs play the same game
+  explicit Game(unsigned seed);
   void tick(float tick_time);
   void ship_shoots();
   void hyperspace();
@@ -225,7 +243,7 @@ public:
   long long get_score() const;
   float get_time_since_start_of_level() const;
   Spaceship & get_ship();
-  Physics2df & get_physics();
+  GamePhysics & get_physics();
   std::vector<GameEvent> & get_game_events();  
   friend class Saucer;
   friend class Spaceship;
@@ -0,0 +1,57 @@
+#include "game.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// benchmark of Game::tick, i.e. the physics of all bodies plus the game logic,
+// with the ship turning, accelerating and shooting all the time
+// build it once with the pre-compiled templates and once with the definitions visible everywhere
+// to see what inlining the small math, geometry and physics functions into game.cc is worth:
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc geometry.cc physics.cc timer.cc game.cc game_benchmark.cc -lSDL2 -o game_benchmark
+//   g++ -std=c++20 -O2 -DNDEBUG -DINLINE_TEMPLATES math.cc geometry.cc physics.cc timer.cc game.cc game_benchmark.cc -lSDL2 -o game_benchmark
+// add -DGAME_FIXED_POINT to play the game with Q32.32 positions and velocities instead of float
+// the asteroids are placed randomly, so the median of several games is reported
+
+namespace {
+
+constexpr size_t NO_OF_GAMES = 31u;
+constexpr size_t NO_OF_TICKS = 20000u; // about 5.5 minutes of game time each
+
+// plays one game and returns the average time per tick in microseconds
+double play() {
+  const float seconds = 1.0f / 60.0f;
+  Game game;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tick = 0u; tick < NO_OF_TICKS; tick++) {
+    if (! game.get_ship().is_marked_for_deletion()) {
+      game.get_ship().turn_left(seconds);
+      game.accelerate_ship(seconds);
+      if (tick % 8u == 0u) {
+        game.ship_shoots();
+      }
+    }
+    game.tick(seconds);
+    game.get_game_events().clear();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / NO_OF_TICKS;
+}
+
+}
+
+int main() {
+  std::vector<double> microseconds;
+  for (size_t i = 0u; i < NO_OF_GAMES; i++) {
+    microseconds.push_back( play() );
+  }
+  std::sort(microseconds.begin(), microseconds.end());
+#ifdef INLINE_TEMPLATES
+  const char * mode = "inline templates";
+#else
+  const char * mode = "pre-compiled templates";
+#endif
+  std::cout << "Game::tick (" << mode << "): " << microseconds[NO_OF_GAMES / 2u] << " us/tick (median), "
+            << microseconds.front() << " us/tick (minimum)" << std::endl;
+  return 0;
+}
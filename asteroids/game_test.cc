@@ -1,24 +1,26 @@
 #include "game.h"
+#include <bit>
+#include <cstdint>
 #include "gtest/gtest.h"
 
 
 namespace {
   
 TEST(SPACESHIP, InitalState) {
-  Spaceship ship{ Vector2df{125.0f, 100.0f} }; 
+  Spaceship ship{ GameVector{125.0f, 100.0f} }; 
   
   ASSERT_FALSE(ship.is_accelerating());
-  EXPECT_NEAR(125.0f, ship.get_position()[0], 0.00001f);
-  EXPECT_NEAR(100.0f, ship.get_position()[1], 0.00001f);
-  EXPECT_NEAR(0.0f, ship.get_angle(), 0.00001f);
+  EXPECT_NEAR(125.0f, static_cast<float>(ship.get_position()[0]), 0.00001f);
+  EXPECT_NEAR(100.0f, static_cast<float>(ship.get_position()[1]), 0.00001f);
+  EXPECT_NEAR(0.0f, static_cast<float>(ship.get_angle()), 0.00001f);
 }
   
 TEST(SPACESHIP, HalfTurn) {
-  Spaceship ship{ Vector2df{125.0f, 100.0f} }; 
+  Spaceship ship{ GameVector{125.0f, 100.0f} }; 
   
   ship.turn(PI, 0.5f);
   ship.turn(PI, 0.5f);
-  EXPECT_NEAR(PI, ship.get_angle(), 0.00001f);
+  EXPECT_NEAR(PI, static_cast<float>(ship.get_angle()), 0.00001f);
 }
   
   
@@ -57,5 +59,37 @@ TEST(GAME, ShipShoots) {
   ASSERT_EQ(9, game.get_physics().get_bodies().size());
 }
 
+// plays a minute with the ship turning, accelerating and shooting and returns a checksum of the bodies and the score
+std::uint64_t play(unsigned seed) {
+  const float tick_time = 1.0f / 60.0f;
+  Game game{seed};
+  for (size_t tick = 0; tick < 3600; tick++) {
+    game.get_ship().turn_left(tick_time);
+    game.accelerate_ship(tick_time);
+    if (tick % 8 == 0) {
+      game.ship_shoots();
+    }
+    game.tick(tick_time);
+  }
+  std::uint64_t checksum = game.get_score();
+  for (GameBody * body : game.get_physics().get_bodies()) {
+    for (size_t axis = 0; axis < 2; axis++) {
+      checksum = 31 * checksum + std::bit_cast<std::uint64_t>(static_cast<double>(body->get_position()[axis]));
+      checksum = 31 * checksum + std::bit_cast<std::uint64_t>(static_cast<double>(body->get_velocity()[axis]));
+    }
+  }
+  return checksum;
+}
+
+TEST(GAME, SameSeedPlaysSameGame) {
+  std::uint64_t checksum = play(7u);
+  EXPECT_EQ(checksum, play(7u));
+  EXPECT_NE(checksum, play(8u));
+#ifdef GAME_FIXED_POINT
+  // the fixed-point game is the same for every standard library and optimization level of GCC and Clang
+  EXPECT_EQ(2282618104268603894u, checksum);
+#endif
+}
+
 
 }
\ No newline at end of file
@@ -1,13 +1,28 @@
+#ifndef GEOMETRY_TCC
+#define GEOMETRY_TCC
+
 #include "geometry.h"
+#include "vector_expression.h"
+#include "ray_packet.tcc"
+
+template <class FLOAT, size_t N>
+PrecomputedRay<FLOAT, N>::PrecomputedRay(const Ray<FLOAT, N> & ray)
+  : origin(ray.origin), direction(ray.direction), inverse_direction(ray.direction) {
+  for (size_t i = 0; i < N; i++) {
+    inverse_direction[i] = static_cast<FLOAT>(1.0) / direction[i];
+    negative[i] = std::signbit(inverse_direction[i]);
+  }
+}
+
 template <class FLOAT, size_t N>
-AxisAlignedBoundingBox<FLOAT, N>::AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length)
+inline AxisAlignedBoundingBox<FLOAT, N>::AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length)
   : center(center), half_edge_length(half_edge_length)
 {
 }
 
 
 template <class FLOAT, size_t N>
-bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const {
+inline bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const {
   bool intersects = true;
   for (size_t i = 0; i < N; i++) {
     intersects &= (center[i] - half_edge_length[i] - aabb.half_edge_length[i] <= aabb.center[i]) 
@@ -17,7 +32,7 @@ bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N
 }
 
 template <class FLOAT, size_t N>
-bool AxisAlignedBoundingBox<FLOAT, N>::intersects(Ray<FLOAT,N> ray) const {
+inline bool AxisAlignedBoundingBox<FLOAT, N>::intersects(Ray<FLOAT,N> ray) const {
     FLOAT tmin;
     FLOAT tmax;
     FLOAT tminimum = -INFINITY;
@@ -32,6 +47,10 @@ bool AxisAlignedBoundingBox<FLOAT, N>::intersects(Ray<FLOAT,N> ray) const {
     return tmaximum >= tminimum;
 }
 
+template <class FLOAT, size_t N>
+inline bool AxisAlignedBoundingBox<FLOAT, N>::intersects(const PrecomputedRay<FLOAT, N> & ray, FLOAT & tmin, FLOAT & tmax) const {
+  return ray.slabs(center - half_edge_length, center + half_edge_length, tmin, tmax);
+}
 
 template <class FLOAT, size_t N>
 bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N> aabb, Vector<FLOAT, N> direction) const {
@@ -66,10 +85,30 @@ Vector<FLOAT, N> AxisAlignedBoundingBox<FLOAT, N>::sweep_intersects(AxisAlignedB
     return normal;
 }
 
+// the slab test of intersects(ray) with one lane per ray
+template <class FLOAT, size_t N>
+template <size_t WIDTH>
+std::uint32_t AxisAlignedBoundingBox<FLOAT, N>::intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const {
+    typedef Lanes<FLOAT, WIDTH> L;
+    L tminimum = L::broadcast(-INFINITY);
+    L tmaximum = L::broadcast(INFINITY);
+
+    for (size_t i = 0; i < N; i++) {
+      L origin = L::load(packet.origin[i]);
+      L direction = L::load(packet.direction[i]);
+      L tmin = (L::broadcast(center[i] - half_edge_length[i]) - origin) / direction;
+      L tmax = (L::broadcast(center[i] + half_edge_length[i]) - origin) / direction;
+      tminimum = max(tminimum, min(tmin, tmax));
+      tmaximum = min(tmaximum, max(tmin, tmax));
+    }
+    typename L::Mask hit = tminimum <= tmaximum;
+    select(hit, tminimum, L::broadcast(0.0)).store(t);
+    return hit.bits();
+}
 
 
 template <class FLOAT, size_t N>
-Sphere<FLOAT,N>::Sphere(Vector<FLOAT,N> center, FLOAT radius)
+inline Sphere<FLOAT,N>::Sphere(Vector<FLOAT,N> center, FLOAT radius)
  : center(center), radius(radius)
 {
 }
@@ -80,7 +119,7 @@ Sphere<FLOAT,N>::Sphere(Vector<FLOAT,N> center, FLOAT radius)
 // and abc-formula
 
 template <class FLOAT, size_t N>
-FLOAT Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray) const {
+inline FLOAT Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray) const {
   Vector<FLOAT,N> om = ray.origin - center;
   FLOAT  a = ray.direction * ray.direction,
          b = 2.0 * (om * ray.direction),
@@ -96,6 +135,52 @@ FLOAT Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray) const {
   return 0.5 * std::min( std::max<FLOAT>(0.0, (-b + d)) , (-b - d) ) / a; 
 }
 
+// the same formula as intersects(ray) with one lane per ray,
+// both roots are computed and the one of each lane is selected instead of branching
+template <class FLOAT, size_t N>
+template <size_t WIDTH>
+std::uint32_t Sphere<FLOAT,N>::intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const {
+  typedef Lanes<FLOAT, WIDTH> L;
+  L a = L::broadcast(0.0),
+    b = L::broadcast(0.0),
+    c = L::broadcast(-radius * radius);
+  for (size_t i = 0; i < N; i++) {
+    L om = L::load(packet.origin[i]) - L::broadcast(center[i]);
+    L direction = L::load(packet.direction[i]);
+    a = a + direction * direction;
+    b = b + om * direction;
+    c = c + om * om;
+  }
+  L zero = L::broadcast(0.0);
+  b = b + b;
+  L d = b * b - L::broadcast(4.0) * a * c;
+  typename L::Mask real = zero <= d;
+  d = sqrt(max(d, zero));
+  L far = zero - b + d,
+    near = zero - b - d;
+  // c < 0 iff the origin is inside the sphere
+  L root = select(c < zero, far, min(max(zero, far), near)) * L::broadcast(0.5) / a;
+  typename L::Mask hit = real & (zero < root);
+  select(hit, root, zero).store(t);
+  return hit.bits();
+}
+
+// with f(t) = (ray.origin + t * ray.direction - center)^2 - r^2 = a t^2 + 2 b t + c, the ray starts inside iff c < 0
+// and leaves before tmax iff f(tmax) > 0, a ray starting outside has to approach the center (b < 0), needs real roots
+// (b^2 >= a c), and enters before tmax iff f(tmax) <= 0 or the minimum of f at -b / a is before tmax
+// most rays miss and return after the first test, f(tmax) is written so that an infinite tmax gives infinity and not NaN
+template <class FLOAT, size_t N>
+inline bool Sphere<FLOAT,N>::occluded(const Ray<FLOAT, N> &ray, FLOAT tmax) const {
+  Vector<FLOAT,N> om = ray.origin - center;
+  FLOAT a = ray.direction * ray.direction,
+        b = om * ray.direction,
+        c = om * om - radius * radius,
+        f = c + tmax * (b + b + a * tmax);
+  bool leaves = (c < 0) & (f > 0);
+  bool enters = (c >= 0) & (b < 0) & (b * b >= a * c) & ((f <= 0) | (-b < a * tmax));
+  return leaves | enters;
+}
+
 template <class FLOAT, size_t N>
 bool Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
   FLOAT t = intersects(ray);
@@ -135,7 +220,11 @@ bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Conte
 template <class FLOAT, size_t N>
 bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
     const FLOAT EPSILON = 10e-7;
-    normal =  (b-a).cross_product(c-a);  // points away from triangle surface (clockwise order)
+    // Vector::cross_product returns the y component with the opposite sign, which cancels
+    // in the side tests below, but the plane of the triangle needs the geometric normal
+    Vector<FLOAT, N> side_normal = (b-a).cross_product(c-a);
+    normal = side_normal;
+    normal[1] = -normal[1];  // points away from triangle surface (clockwise order)
 
     FLOAT normalRayProduct =  normal * ray.direction;
     FLOAT area = normal.length(); // used for u-v-parameter calculation
@@ -155,20 +244,20 @@ bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> &
     p = ray.origin + t * ray.direction;
    
     Vector<FLOAT, N> vector = (b - a).cross_product(p - a );
-    if ( normal * vector < 0.0 ) { 
+    if ( side_normal * vector < 0.0 ) { 
       return false;
     }
 
     
     vector = (c - b).cross_product(p - b );
-    if ( normal * vector < 0.0 ) { 
+    if ( side_normal * vector < 0.0 ) { 
       return false;
     }
 
     u = vector.length()  / area;
 
     vector = (a-c).cross_product(p - c );
-    if (normal * vector < 0.0 ) {
+    if (side_normal * vector < 0.0 ) {
       return false;
     }
 
@@ -177,6 +266,213 @@ bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> &
     return true;
 }
 
+template <class FLOAT, size_t N>
+inline bool Triangle<FLOAT, N>::occluded(const Ray<FLOAT, N> &ray, FLOAT tmax) const {
+  return PrecomputedTriangle<FLOAT, N>(*this).occluded(ray, tmax);
+}
+
+template <class FLOAT, size_t N>
+template <size_t WIDTH>
+std::uint32_t Triangle<FLOAT, N>::intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const {
+  return PrecomputedTriangle<FLOAT, N>(*this).intersects(packet, t);
+}
+
+template <class FLOAT, size_t N>
+inline Vector<FLOAT, N> Triangle<FLOAT, N>::get_vertex(size_t vertex) const {
+  return vertex == 0u ? a : (vertex == 1u ? b : c);
+}
+
+template <class FLOAT, size_t N>
+PrecomputedTriangle<FLOAT, N>::PrecomputedTriangle(const Triangle<FLOAT, N> & triangle)
+  : a(triangle.get_vertex(0u)), edge1(triangle.get_vertex(1u) - a), edge2(triangle.get_vertex(2u) - a), normal(cross(edge1, edge2)) { }
+
+template <class FLOAT, size_t N>
+inline Vector<FLOAT, N> PrecomputedTriangle<FLOAT, N>::cross(const Vector<FLOAT, N> & v, const Vector<FLOAT, N> & w) {
+  return { v[1] * w[2] - v[2] * w[1],
+           v[2] * w[0] - v[0] * w[2],
+           v[0] * w[1] - v[1] * w[0] };
+}
+
+template <class FLOAT, size_t N>
+inline Vector<FLOAT, N> PrecomputedTriangle<FLOAT, N>::get_vertex(size_t vertex) const {
+  return vertex == 0u ? a : (vertex == 1u ? a + edge1 : a + edge2);
+}
+
+template <class FLOAT, size_t N>
+inline bool PrecomputedTriangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  return intersects(ray, context.normal, context.intersection, context.u, context.v, context.t);
+}
+
+// solves ray.origin + t * ray.direction = a + beta * edge1 + gamma * edge2 with Cramer's rule,
+// the determinant is -normal * ray.direction, which is compared with the same EPSILON as in Triangle::intersects
+// u is the barycentric coordinate of a and v the one of b like in Triangle::intersects
+template <class FLOAT, size_t N>
+inline bool PrecomputedTriangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
+    const FLOAT EPSILON = 10e-7;
+    // the products are written out with components, which keeps them in registers
+    const Vector<FLOAT, N> & d = ray.direction;
+    FLOAT p0 = d[1] * edge2[2] - d[2] * edge2[1],
+          p1 = d[2] * edge2[0] - d[0] * edge2[2],
+          p2 = d[0] * edge2[1] - d[1] * edge2[0];
+    FLOAT determinant = edge1[0] * p0 + edge1[1] * p1 + edge1[2] * p2;
+    if ( fabs(determinant) < EPSILON ) { // backface culling off
+      return false;
+    }
+    FLOAT inverse_determinant = static_cast<FLOAT>(1.0) / determinant;
+
+    FLOAT t0 = ray.origin[0] - a[0],
+          t1 = ray.origin[1] - a[1],
+          t2 = ray.origin[2] - a[2];
+    FLOAT beta = (t0 * p0 + t1 * p1 + t2 * p2) * inverse_determinant;
+    if ( beta < 0.0 || beta > 1.0 ) {
+      return false;
+    }
+
+    FLOAT q0 = t1 * edge1[2] - t2 * edge1[1],
+          q1 = t2 * edge1[0] - t0 * edge1[2],
+          q2 = t0 * edge1[1] - t1 * edge1[0];
+    FLOAT gamma = (d[0] * q0 + d[1] * q1 + d[2] * q2) * inverse_determinant;
+    if ( gamma < 0.0 || beta + gamma > 1.0 ) {
+      return false;
+    }
+
+    t = (edge2[0] * q0 + edge2[1] * q1 + edge2[2] * q2) * inverse_determinant;
+    if ( t < 0.0 ) {
+      return false;
+    }
+    normal = this->normal;
+    p = ray.origin + t * ray.direction;
+    u = static_cast<FLOAT>(1.0) - beta - gamma;
+    v = beta;
+    return true;
+}
+
+// the same tests as intersects(ray), followed by the comparison with tmax instead of computing the point, normal and u, v
+template <class FLOAT, size_t N>
+inline bool PrecomputedTriangle<FLOAT, N>::occluded(const Ray<FLOAT, N> &ray, FLOAT tmax) const {
+    const FLOAT EPSILON = 10e-7;
+    const Vector<FLOAT, N> & d = ray.direction;
+    FLOAT p0 = d[1] * edge2[2] - d[2] * edge2[1],
+          p1 = d[2] * edge2[0] - d[0] * edge2[2],
+          p2 = d[0] * edge2[1] - d[1] * edge2[0];
+    FLOAT determinant = edge1[0] * p0 + edge1[1] * p1 + edge1[2] * p2;
+    if ( fabs(determinant) < EPSILON ) {
+      return false;
+    }
+    FLOAT inverse_determinant = static_cast<FLOAT>(1.0) / determinant;
+
+    FLOAT t0 = ray.origin[0] - a[0],
+          t1 = ray.origin[1] - a[1],
+          t2 = ray.origin[2] - a[2];
+    FLOAT beta = (t0 * p0 + t1 * p1 + t2 * p2) * inverse_determinant;
+    if ( beta < 0.0 || beta > 1.0 ) {
+      return false;
+    }
+
+    FLOAT q0 = t1 * edge1[2] - t2 * edge1[1],
+          q1 = t2 * edge1[0] - t0 * edge1[2],
+          q2 = t0 * edge1[1] - t1 * edge1[0];
+    FLOAT gamma = (d[0] * q0 + d[1] * q1 + d[2] * q2) * inverse_determinant;
+    if ( gamma < 0.0 || beta + gamma > 1.0 ) {
+      return false;
+    }
+    FLOAT t = (edge2[0] * q0 + edge2[1] * q1 + edge2[2] * q2) * inverse_determinant;
+    return t >= 0.0 && t < tmax;
+}
+
+// the same tests as intersects(ray) with one lane per ray, a lane hits if it passes all of them
+template <class FLOAT, size_t N>
+template <size_t WIDTH>
+std::uint32_t PrecomputedTriangle<FLOAT, N>::intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const {
+    typedef Lanes<FLOAT, WIDTH> L;
+    const L zero = L::broadcast(0.0),
+            one = L::broadcast(1.0);
+    L d0 = L::load(packet.direction[0]),
+      d1 = L::load(packet.direction[1]),
+      d2 = L::load(packet.direction[2]);
+    L e10 = L::broadcast(edge1[0]), e11 = L::broadcast(edge1[1]), e12 = L::broadcast(edge1[2]),
+      e20 = L::broadcast(edge2[0]), e21 = L::broadcast(edge2[1]), e22 = L::broadcast(edge2[2]);
+    L p0 = d1 * e22 - d2 * e21,
+      p1 = d2 * e20 - d0 * e22,
+      p2 = d0 * e21 - d1 * e20;
+    L determinant = e10 * p0 + e11 * p1 + e12 * p2;
+    typename L::Mask hit = L::broadcast(10e-7) <= abs(determinant);
+    L inverse_determinant = one / determinant;
+
+    L t0 = L::load(packet.origin[0]) - L::broadcast(a[0]),
+      t1 = L::load(packet.origin[1]) - L::broadcast(a[1]),
+      t2 = L::load(packet.origin[2]) - L::broadcast(a[2]);
+    L beta = (t0 * p0 + t1 * p1 + t2 * p2) * inverse_determinant;
+    hit = hit & (zero <= beta) & (beta <= one);
+
+    L q0 = t1 * e12 - t2 * e11,
+      q1 = t2 * e10 - t0 * e12,
+      q2 = t0 * e11 - t1 * e10;
+    L gamma = (d0 * q0 + d1 * q1 + d2 * q2) * inverse_determinant;
+    hit = hit & (zero <= gamma) & (beta + gamma <= one);
+
+    L distance = (e20 * q0 + e21 * q1 + e22 * q2) * inverse_determinant;
+    hit = hit & (zero <= distance);
+    select(hit, distance, zero).store(t);
+    return hit.bits();
+}
+
+template <class FLOAT, size_t N>
+bool closest_hit(std::span<const Triangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context) {
+  Intersection_Context<FLOAT, N> candidate;
+  bool hit = false;
+  for (const Triangle<FLOAT, N> & triangle : triangles) {
+    if ( triangle.intersects(ray, candidate) && (! hit || candidate.t < context.t) ) {
+      context = candidate;
+      hit = true;
+    }
+  }
+  return hit;
+}
+
+template <class FLOAT, size_t N>
+bool closest_hit(std::span<const PrecomputedTriangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context) {
+  Intersection_Context<FLOAT, N> candidate;
+  bool hit = false;
+  for (const PrecomputedTriangle<FLOAT, N> & triangle : triangles) {
+    if ( triangle.intersects(ray, candidate) && (! hit || candidate.t < context.t) ) {
+      context = candidate;
+      hit = true;
+    }
+  }
+  return hit;
+}
+
+template <class FLOAT, size_t N>
+bool occluded(std::span<const Sphere<FLOAT, N>> spheres, const Ray<FLOAT, N> & ray, FLOAT tmax) {
+  for (const Sphere<FLOAT, N> & sphere : spheres) {
+    if ( sphere.occluded(ray, tmax) ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class FLOAT, size_t N>
+bool occluded(std::span<const Triangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, FLOAT tmax) {
+  for (const Triangle<FLOAT, N> & triangle : triangles) {
+    if ( triangle.occluded(ray, tmax) ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class FLOAT, size_t N>
+bool occluded(std::span<const PrecomputedTriangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, FLOAT tmax) {
+  for (const PrecomputedTriangle<FLOAT, N> & triangle : triangles) {
+    if ( triangle.occluded(ray, tmax) ) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <class FLOAT, size_t N>
 bool refract(FLOAT refraction_index, Vector<FLOAT, N> normal, Vector<FLOAT, N> direction, Vector<FLOAT, N> & transmission) {
    FLOAT cos_theta = direction * normal; // both vectors need to be normalized
@@ -186,7 +482,7 @@ bool refract(FLOAT refraction_index, Vector<FLOAT, N> normal, Vector<FLOAT, N> d
      return false; // total internal reflection
    }
    FLOAT cos_phi = sqrt( static_cast<FLOAT>(1.0f) - sin_phi_squared );
-   transmission = refraction_index * (direction - cos_theta * normal  ) - cos_phi * normal;
+   transmission = refraction_index * (lazy(direction) - cos_theta * lazy(normal)) - cos_phi * lazy(normal);
    
    return true;
 }
@@ -195,11 +491,53 @@ bool refract(FLOAT refraction_index, Vector<FLOAT, N> normal, Vector<FLOAT, N> d
 template <class FLOAT, size_t N>
 inline bool Sphere<FLOAT, N>::intersects(Sphere<FLOAT, N> sphere) const
 {
-    return ((this->center - sphere.center).length() < this->radius + sphere.radius);
+    // compares squared distances, which needs no square root (exactly for fixed-point types)
+    return VectorKernels<FLOAT, N>::within(this->center.vector, sphere.center.vector, this->radius + sphere.radius);
+}
+
+// with the distance of the centers d(t) = center - other.center + t * relative_velocity and the sum of the radii r,
+// the spheres touch when f(t) = d(t)^2 - r^2 = a t^2 + 2 b t + c is zero, like in occluded(ray, tmax):
+// they overlap at time zero iff c < 0, otherwise they have to approach (b < 0) with real roots (b^2 >= a c),
+// and meet before dt iff f(dt) <= 0 or the minimum of f at -b / a is before dt
+// only an impact needs the square root, the smaller root is computed as c / (-b + sqrt(b^2 - a c)) without cancellation,
+// and at that time the length of d is r, so that d / r is the unit normal
+template <class FLOAT, size_t N>
+bool Sphere<FLOAT, N>::sweep(const Sphere<FLOAT, N> & other, const Vector<FLOAT, N> & relative_velocity, FLOAT dt, FLOAT & time, Vector<FLOAT, N> & normal) const
+{
+    Vector<FLOAT, N> distance = this->center - other.center;
+    FLOAT radii = this->radius + other.radius;
+    FLOAT a = relative_velocity * relative_velocity,
+          b = distance * relative_velocity,
+          c = distance * distance - radii * radii;
+    if ( c < 0 ) {
+      time = 0;
+      FLOAT length = sqrt(distance * distance);
+      normal = length > 0 ? (1 / length) * distance : static_cast<FLOAT>(0) * distance;
+      return true;
+    }
+    FLOAT discriminant = b * b - a * c;
+    if ( b >= 0 || discriminant < 0 || (c + dt * (b + b + a * dt) > 0 && -b >= a * dt) ) {
+      return false;
+    }
+    time = c / (-b + sqrt(discriminant));
+    normal = (1 / radii) * (distance + time * relative_velocity);
+    return true;
 }
 
 template <class FLOAT, size_t N>
 inline bool Sphere<FLOAT, N>::inside(const Vector<FLOAT, N> p) const
 {
-    return (this->center - p).length() < this->radius;
+    return (this->center - p).square_of_length() < this->radius * this->radius;
 }
+
+template <class FLOAT, size_t N>
+inline Vector<FLOAT, N> Sphere<FLOAT, N>::get_center() const {
+  return center;
+}
+
+template <class FLOAT, size_t N>
+inline FLOAT Sphere<FLOAT, N>::get_radius() const {
+  return radius;
+}
+
+#endif
@@ -1,4 +1,11 @@
 #include "math.h"
+#include "vector_expression.h"
+#include "vector_array.h"
+#include "vector_view.h"
+#include "vector_random.h"
+#include "quantized_vector_array.h"
+#include "fast_math.h"
+#include "fixed_point.h"
 #include "gtest/gtest.h"
 
 namespace {
@@ -395,6 +402,489 @@ TEST(VECTOR, CrossVectorProduct7) {
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
+TEST(VECTOR, AddDoesNotTouchNeighbours3df) {
+  std::array<Vector3df, 2> vectors = { Vector3df{1.0, 2.0, 3.0}, Vector3df{4.0, 5.0, 6.0} };
+  vectors[0] += Vector3df{1.0, 1.0, 1.0};
+  vectors[0] *= 2.0f;
+
+  EXPECT_NEAR(4.0, vectors[0][0], 0.00001);
+  EXPECT_NEAR(6.0, vectors[0][1], 0.00001);
+  EXPECT_NEAR(8.0, vectors[0][2], 0.00001);
+  EXPECT_NEAR(4.0, vectors[1][0], 0.00001);
+  EXPECT_NEAR(5.0, vectors[1][1], 0.00001);
+  EXPECT_NEAR(6.0, vectors[1][2], 0.00001);
+}
+
+TEST(VECTOR, ScalarVectorProduct4df) {
+  Vector4df vector1 = {1.0, 2.0, -3.0, 4.0};
+  Vector4df vector2 = {-2.0, 0.5, 1.0, 2.0};
+
+  EXPECT_NEAR(4.0, vector1 * vector2, 0.00001);
+  EXPECT_NEAR(30.0, vector1.square_of_length(), 0.00001);
+}
+
+TEST(VECTOR, ConstantExpressions) {
+  constexpr Vector3df vector = {1.0, 2.0, 2.0};
+  constexpr Vector3df sum = 2.0f * vector + Vector3df{1.0, 0.0, 0.0};
+  constexpr Vector3df cross = Vector3df{1.0, 0.0, 0.0}.cross_product(Vector3df{0.0, 1.0, 0.0});
+  static_assert(vector.length() == 3.0f);
+  static_assert(vector * vector == 9.0f);
+  static_assert(cross[2] == 1.0f);
+  static_assert(1.41421f < Vector2df{1.0, 1.0}.length() && Vector2df{1.0, 1.0}.length() < 1.41422f);
+
+  EXPECT_NEAR(3.0, sum[0], 0.00001);
+  EXPECT_NEAR(4.0, sum[1], 0.00001);
+  EXPECT_NEAR(4.0, sum[2], 0.00001);
+}
+
+TEST(VECTOR_EXPRESSION, SumOfScaledVectors) {
+  Vector3df origin = {1.0, 2.0, 3.0};
+  Vector3df direction = {0.0, -1.0, 2.0};
+  Vector3df point = lazy(origin) + 2.0f * lazy(direction);
+
+  EXPECT_NEAR(1.0, point[0], 0.00001);
+  EXPECT_NEAR(0.0, point[1], 0.00001);
+  EXPECT_NEAR(7.0, point[2], 0.00001);
+}
+
+TEST(VECTOR_EXPRESSION, MatchesEagerEvaluation) {
+  Vector2df vector = {0.5, -1.5};
+  Vector2df normal = {0.6, 0.8};
+  Vector2df eager = 3.0f * (vector - 0.5f * normal) - normal;
+  Vector2df expression = 3.0f * (lazy(vector) - 0.5f * lazy(normal)) - lazy(normal);
+
+  EXPECT_NEAR(eager[0], expression[0], 0.00001);
+  EXPECT_NEAR(eager[1], expression[1], 0.00001);
+  EXPECT_NEAR(vector * normal, lazy(vector) * lazy(normal), 0.00001);
+}
+
+TEST(VECTOR_ARRAY, GatherAndScatter) {
+  std::array<Vector3df, 2> vectors = { Vector3df{1.0, 2.0, 3.0}, Vector3df{4.0, 5.0, 6.0} };
+  VectorArray3df array{ vectors };
+  array.set(0, Vector3df{-1.0, -2.0, -3.0});
+
+  EXPECT_EQ(2u, array.size());
+  EXPECT_NEAR(-2.0, array.get(0)[1], 0.00001);
+  EXPECT_NEAR(6.0, array.get(1)[2], 0.00001);
+  EXPECT_NEAR(5.0, array.axis(1)[1], 0.00001);
+}
+
+TEST(VECTOR_ARRAY, Axpy) {
+  VectorArray2df positions{3};
+  VectorArray2df velocities{3};
+  velocities.set(1, Vector2df{2.0, -4.0});
+  positions.set(1, Vector2df{1.0, 1.0});
+  positions.axpy(0.5f, velocities);
+
+  EXPECT_NEAR(2.0, positions.get(1)[0], 0.00001);
+  EXPECT_NEAR(-1.0, positions.get(1)[1], 0.00001);
+  EXPECT_NEAR(0.0, positions.get(2)[0], 0.00001);
+}
+
+TEST(VECTOR_ARRAY, DotAndLengths) {
+  std::array<Vector3df, 2> vectors = { Vector3df{1.0, 2.0, 2.0}, Vector3df{0.0, -4.0, 3.0} };
+  VectorArray3df array{ vectors };
+  std::array<float, 2> products;
+  std::array<float, 2> lengths;
+  array.dot(Vector3df{1.0, 1.0, 1.0}, products);
+  array.lengths(lengths);
+
+  EXPECT_NEAR(5.0, products[0], 0.00001);
+  EXPECT_NEAR(-1.0, products[1], 0.00001);
+  EXPECT_NEAR(3.0, lengths[0], 0.00001);
+  EXPECT_NEAR(5.0, lengths[1], 0.00001);
+}
+
+TEST(VECTOR_ARRAY, Normalize) {
+  std::array<Vector2df, 2> vectors = { Vector2df{-3.0, 4.0}, Vector2df{0.0, 0.5} };
+  VectorArray2df array{ vectors };
+  array.normalize();
+
+  EXPECT_NEAR(1.0, array.get(0).length(), 0.00001);
+  EXPECT_NEAR(-0.6, array.get(0)[0], 0.00001);
+  EXPECT_NEAR(1.0, array.get(1)[1], 0.00001);
+}
+
+TEST(VECTOR_ARRAY, MinimumAndMaximum) {
+  std::array<Vector2df, 3> vectors = { Vector2df{-3.0, 4.0}, Vector2df{2.0, -0.5}, Vector2df{1.0, 1.0} };
+  VectorArray2df array{ vectors };
+
+  EXPECT_NEAR(-3.0, array.minimum()[0], 0.00001);
+  EXPECT_NEAR(-0.5, array.minimum()[1], 0.00001);
+  EXPECT_NEAR(2.0, array.maximum()[0], 0.00001);
+  EXPECT_NEAR(4.0, array.maximum()[1], 0.00001);
+}
+
+TEST(VECTOR, PaddingStaysZero) {
+  // with MATH_PADDED_VECTOR3 the padding is part of the SSE registers
+  Vector3df vector = {1.0, 0.0, -1.0};
+  vector *= std::numeric_limits<float>::infinity();
+  vector /= 0.0f;
+  vector[0] = 1.0f;
+  vector[1] = 2.0f;
+  vector[2] = 2.0f;
+  Vector3df cross = vector.cross_product(Vector3df{0.0, 0.0, 1.0});
+
+  EXPECT_EQ(0u, (alignof(Vector3df) % VectorPadding<float, 3u>::ALIGNMENT));
+  EXPECT_EQ(9.0f, vector * vector);
+  EXPECT_EQ(2.0f, cross[0]);
+  EXPECT_EQ(1.0f, cross[1]);
+  EXPECT_EQ(0.0f, cross[2]);
+  EXPECT_EQ(5.0f, cross * cross);
+}
+
+TEST(VECTOR_VIEW, InterleavedVertices) {
+  // position and normal of two vertices
+  std::array<float, 12> vertices = { 1.0, 2.0, 3.0,  0.0, 0.0, 1.0,
+                                     4.0, 5.0, 6.0,  0.0, 1.0, 0.0 };
+  VectorView3df positions{ vertices.data(), 2, 6 };
+  VectorView3df normals{ vertices.data() + 3, 2, 6 };
+  positions[1] += Vector3df{1.0, 1.0, 1.0};
+  normals[0] = Vector3df{0.0, 0.0, -1.0};
+
+  EXPECT_EQ(2u, positions.size());
+  EXPECT_EQ(5.0f, vertices[6]);
+  EXPECT_EQ(7.0f, vertices[8]);
+  EXPECT_EQ(-1.0f, vertices[5]);
+  EXPECT_EQ(2.0f, vertices[1]);
+}
+
+TEST(VECTOR_VIEW, StructureOfArrays) {
+  // x values of three vectors followed by their y values
+  std::array<float, 6> axes = { 1.0, 2.0, 3.0,  -1.0, -2.0, -3.0 };
+  VectorView2df view{ axes.data(), 3, 1, 3 };
+  for (VectorRef2df ref : view) {
+    ref *= 2.0f;
+  }
+  Vector2df second = view[1];
+
+  EXPECT_EQ(4.0f, second[0]);
+  EXPECT_EQ(-4.0f, second[1]);
+  EXPECT_EQ(-6.0f, axes[5]);
+}
+
+TEST(VECTOR_VIEW, Arithmetic) {
+  std::array<Vector2df, 2> vectors = { Vector2df{3.0, 4.0}, Vector2df{1.0, -1.0} };
+  VectorView2df view{ vectors };
+  Vector2df sum = view[0] + view[1];
+  Vector2df scaled = 2.0f * view[1];
+  Vector2df expression = lazy(vectors[0]) - 0.5f * lazy(vectors[1]);
+
+  EXPECT_EQ(4.0f, sum[0]);
+  EXPECT_EQ(-2.0f, scaled[1]);
+  EXPECT_EQ(-1.0f, view[0] * view[1]);
+  EXPECT_NEAR(5.0, view[0].length(), 0.00001);
+  view[0].normalize();
+  EXPECT_NEAR(0.8, vectors[0][1], 0.00001);
+  view[1] = expression;
+  EXPECT_NEAR(2.5, vectors[1][0], 0.00001);
+}
+
+TEST(VECTOR_VIEW, IntegerPoints) {
+  // like SDL_Point
+  struct Point { int x, y; };
+  std::array<Point, 2> points = { Point{1, 2}, Point{3, 4} };
+  VectorView<int, 2u> view{ &points[0].x, points.size(), sizeof(Point) / sizeof(int) };
+  view[1] += Vector<int, 2u>{10, 20};
+  VectorRef<int, 2u> first = view[0];
+  first = view[1];
+
+  EXPECT_EQ(13, points[1].x);
+  EXPECT_EQ(24, points[0].y);
+}
+
+TEST(VECTOR_RANDOM, PhiloxKnownAnswers) {
+  // test vectors of the Random123 library
+  EXPECT_EQ(0xff1dae59u, philox_2x32(0u, 0u)[0]);
+  EXPECT_EQ(0x6cd10df2u, philox_2x32(0u, 0u)[1]);
+  EXPECT_EQ(0x2c3f628bu, philox_2x32(0xffffffffffffffffu, 0xffffffffu)[0]);
+  EXPECT_EQ(0xab4fd7adu, philox_2x32(0xffffffffffffffffu, 0xffffffffu)[1]);
+  static_assert(philox_2x32(0x85a308d3243f6a88u, 0x13198a2eu)[0] == 0xdd7ce038u);
+}
+
+TEST(VECTOR_RANDOM, Reproducible) {
+  std::vector<Vector3df> samples1(300, Vector3df{}), samples2(300, Vector3df{}), samples3(300, Vector3df{});
+  VectorRandom3df random1{42u};
+  VectorRandom3df random2{42u};
+  random1.in_box(Vector3df{0.0, 0.0, 0.0}, Vector3df{1.0, 1.0, 1.0}, samples1);
+  random2.in_box(Vector3df{0.0, 0.0, 0.0}, Vector3df{1.0, 1.0, 1.0}, samples2);
+  // continues the stream of random1 and random2
+  VectorRandom3df random3{42u, random1.get_counter()};
+  random2.in_box(Vector3df{0.0, 0.0, 0.0}, Vector3df{1.0, 1.0, 1.0}, samples2);
+  random3.in_box(Vector3df{0.0, 0.0, 0.0}, Vector3df{1.0, 1.0, 1.0}, samples3);
+
+  EXPECT_EQ(450u, random1.get_counter());
+  for (size_t i = 0u; i < samples2.size(); i++) {
+    EXPECT_EQ(samples2[i][0], samples3[i][0]);
+    EXPECT_EQ(samples2[i][2], samples3[i][2]);
+  }
+  EXPECT_NE(samples1[0][0], samples2[0][0]);
+}
+
+TEST(VECTOR_RANDOM, Box) {
+  std::vector<Vector2df> samples(1000, Vector2df{});
+  VectorRandom2df random{7u};
+  random.in_box(Vector2df{-2.0, 10.0}, Vector2df{2.0, 11.0}, samples);
+  Vector2df mean = {0.0, 0.0};
+  for (Vector2df sample : samples) {
+    EXPECT_LE(-2.0f, sample[0]);
+    EXPECT_GT(2.0f, sample[0]);
+    EXPECT_LE(10.0f, sample[1]);
+    EXPECT_GT(11.0f, sample[1]);
+    mean += 0.001f * sample;
+  }
+  EXPECT_NEAR(0.0, mean[0], 0.1);
+  EXPECT_NEAR(10.5, mean[1], 0.05);
+}
+
+TEST(VECTOR_RANDOM, CircleAnnulusAndDisk) {
+  std::vector<Vector2df> circle(1000, Vector2df{}), annulus(1000, Vector2df{}), disk(1000, Vector2df{});
+  VectorRandom2df random{3u};
+  random.on_circle(2.0f, circle);
+  random.in_annulus(1.0f, 3.0f, annulus);
+  random.in_disk(1.0f, disk);
+  size_t inner_disk = 0u;
+  for (size_t i = 0u; i < circle.size(); i++) {
+    EXPECT_NEAR(2.0, circle[i].length(), 0.00001);
+    EXPECT_LE(1.0f - 0.00001f, annulus[i].length());
+    EXPECT_GE(3.0f + 0.00001f, annulus[i].length());
+    EXPECT_GE(1.0f + 0.00001f, disk[i].length());
+    inner_disk += disk[i].length() < 0.5f;
+  }
+  // a quarter of the area of the disk is within half the radius
+  EXPECT_NEAR(250.0, inner_disk, 50.0);
+}
+
+TEST(QUANTIZED_VECTOR_ARRAY, PackAndUnpack) {
+  VectorArray3df vectors{1000u};
+  VectorRandom3df random{5u};
+  std::vector<Vector3df> samples(vectors.size(), Vector3df{});
+  random.in_box({-10.0f, 0.0f, 5.0f}, {10.0f, 1.0f, 6.0f}, samples);
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    vectors.set(i, samples[i]);
+  }
+  QuantizedVectorArray3df quantized{{-10.0f, 0.0f, 5.0f}, {10.0f, 1.0f, 6.0f}};
+  quantized.pack(vectors);
+  EXPECT_EQ(vectors.size(), quantized.size());
+  VectorArray3df unpacked{0u};
+  quantized.unpack(unpacked);
+  EXPECT_EQ(vectors.size(), unpacked.size());
+  // the error is at most half a step of each axis
+  const Vector3df half_step = {20.0f / 131070.0f, 1.0f / 131070.0f, 1.0f / 131070.0f};
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    for (size_t axis = 0u; axis < 3u; axis++) {
+      EXPECT_NEAR(vectors.get(i)[axis], unpacked.get(i)[axis], half_step[axis] * 1.01f);
+      EXPECT_EQ(unpacked.get(i)[axis], quantized.get(i)[axis]);
+    }
+  }
+
+  // the span overloads give the same values
+  QuantizedVectorArray3df from_span{{-10.0f, 0.0f, 5.0f}, {10.0f, 1.0f, 6.0f}};
+  from_span.pack(std::span<const Vector3df>(samples));
+  for (size_t i = 0u; i < quantized.size(); i++) {
+    EXPECT_EQ(quantized.axis(1u)[i], from_span.axis(1u)[i]);
+  }
+  std::vector<Vector3df> part(10u, Vector3df{});
+  from_span.unpack(part, 990u);
+  EXPECT_EQ(unpacked.get(995u)[2], part[5][2]);
+}
+
+TEST(QUANTIZED_VECTOR_ARRAY, SetGetAndClamp) {
+  QuantizedVectorArray2df quantized{{0.0f, -1.0f}, {1024.0f, 1.0f}, 3u};
+  EXPECT_EQ(0.0f, quantized.get(2u)[0]);
+  EXPECT_EQ(-1.0f, quantized.get(2u)[1]);
+  quantized.set(0u, {512.0f, 0.5f});
+  quantized.set(1u, {-5.0f, 2.0f});
+  quantized.set(2u, {1024.0f, -1.0f});
+  EXPECT_NEAR(512.0, quantized.get(0u)[0], 0.008);
+  EXPECT_NEAR(0.5, quantized.get(0u)[1], 0.000016);
+  // values outside of the box are clamped
+  EXPECT_EQ(0.0f, quantized.get(1u)[0]);
+  EXPECT_EQ(1.0f, quantized.get(1u)[1]);
+  EXPECT_EQ(65535u, quantized.axis(0u)[2]);
+  EXPECT_EQ(0u, quantized.axis(1u)[2]);
+  quantized.resize(5u);
+  EXPECT_EQ(5u, quantized.size());
+  EXPECT_EQ(0.0f, quantized.get(4u)[0]);
+}
+
+TEST(MATRIX, IdentityAndRotation) {
+  Vector3df vector = {1.0, -2.0, 3.0};
+  Vector3df same = Matrix3df::identity() * vector;
+  EXPECT_EQ(vector[0], same[0]);
+  EXPECT_EQ(vector[1], same[1]);
+  EXPECT_EQ(vector[2], same[2]);
+
+  Vector2df rotated = rotation<float>(PI / 2.0f) * Vector2df{1.0, 0.0};
+  EXPECT_NEAR(0.0, rotated[0], 0.00001);
+  EXPECT_NEAR(1.0, rotated[1], 0.00001);
+}
+
+TEST(MATRIX, MatrixProduct) {
+  constexpr Matrix2df a = { Vector2df{1.0, 2.0}, Vector2df{3.0, 4.0} };
+  constexpr Matrix2df b = { Vector2df{0.0, 1.0}, Vector2df{1.0, 0.0} };
+  constexpr Matrix2df product = a * b;
+  static_assert(product[0][0] == 2.0f && product[0][1] == 1.0f);
+  static_assert(product[1][0] == 4.0f && product[1][1] == 3.0f);
+}
+
+TEST(MATRIX, TransformPoints) {
+  Matrix3df transformation = affine_2d<float>(PI / 2.0f, 2.0f, Vector2df{10.0, 20.0});
+  std::array<Vector2df, 2> points = { Vector2df{1.0, 0.0}, Vector2df{0.0, 1.0} };
+  transformation.transform_points(points, points);
+
+  EXPECT_NEAR(10.0, points[0][0], 0.00001);
+  EXPECT_NEAR(22.0, points[0][1], 0.00001);
+  EXPECT_NEAR(8.0, points[1][0], 0.00001);
+  EXPECT_NEAR(20.0, points[1][1], 0.00001);
+}
+
+TEST(MATRIX, TransformMatchesProduct) {
+  Matrix3df matrix = { Vector3df{1.0, 2.0, 0.0}, Vector3df{0.0, 1.0, -1.0}, Vector3df{2.0, 0.0, 1.0} };
+  std::array<Vector3df, 3> vectors = { Vector3df{1.0, 1.0, 1.0}, Vector3df{-1.0, 0.5, 2.0}, Vector3df{0.0, 0.0, 3.0} };
+  std::array<Vector3df, 3> transformed = vectors;
+  matrix.transform(vectors, transformed);
+
+  for (size_t i = 0; i < vectors.size(); i++) {
+    Vector3df expected = matrix * vectors[i];
+    for (size_t j = 0; j < 3; j++) {
+      EXPECT_EQ(expected[j], transformed[i][j]);
+    }
+  }
+}
+
+TEST(FAST_MATH, SinCosErrorBounds) {
+  for (float angle = -100.0f; angle <= 100.0f; angle += 0.001f) {
+    float sine, cosine;
+    FastMath<float, Accuracy::accurate>::sincos(angle, sine, cosine);
+    EXPECT_NEAR(std::sin(double(angle)), sine, 1.0e-7);
+    EXPECT_NEAR(std::cos(double(angle)), cosine, 1.0e-7);
+    FastMath<float, Accuracy::fast>::sincos(angle, sine, cosine);
+    EXPECT_NEAR(std::sin(double(angle)), sine, 3.0e-5);
+    EXPECT_NEAR(std::cos(double(angle)), cosine, 3.0e-5);
+  }
+}
+
+TEST(FAST_MATH, Atan2ErrorBounds) {
+  for (float angle = -3.14f; angle <= 3.14f; angle += 0.0001f) {
+    float y = 2.5f * std::sin(angle);
+    float x = 2.5f * std::cos(angle);
+    EXPECT_NEAR(std::atan2(double(y), double(x)), (FastMath<float, Accuracy::accurate>::atan2(y, x)), 3.0e-7);
+    EXPECT_NEAR(std::atan2(double(y), double(x)), (FastMath<float, Accuracy::fast>::atan2(y, x)), 1.6e-3);
+  }
+  EXPECT_EQ(0.0f, (FastMath<float, Accuracy::accurate>::atan2(0.0f, 0.0f)));
+  EXPECT_NEAR(PI, (FastMath<float, Accuracy::accurate>::atan2(0.0f, -1.0f)), 1.0e-6);
+  EXPECT_NEAR(-PI / 2.0, (FastMath<float, Accuracy::fast>::atan2(-3.0f, 0.0f)), 1.0e-6);
+}
+
+TEST(FAST_MATH, RsqrtErrorBounds) {
+  for (float value = 1.0e-6f; value < 1.0e6f; value *= 1.001f) {
+    double exact = 1.0 / std::sqrt(double(value));
+    EXPECT_NEAR(1.0, (FastMath<float, Accuracy::accurate>::rsqrt(value)) / exact, 1.5e-7);
+    EXPECT_NEAR(1.0, (FastMath<float, Accuracy::fast>::rsqrt(value)) / exact, 1.8e-3);
+    EXPECT_NEAR(1.0, (FastMath<double, Accuracy::accurate>::rsqrt(value)) / exact, 1.0e-15);
+  }
+}
+
+TEST(FAST_MATH, BatchedMatchesScalar) {
+  std::vector<float> angles = { -7.0f, -1.0f, 0.0f, 0.5f, 2.0f, 3.0f, 100.0f };
+  std::vector<float> sines(angles.size()), cosines(angles.size()), inverse_roots(angles.size()), directions(angles.size());
+  FastMath<float, Accuracy::fast>::sincos(angles, sines, cosines);
+  FastMath<float, Accuracy::fast>::atan2(sines, cosines, directions);
+  FastMath<float, Accuracy::accurate>::rsqrt(cosines, inverse_roots);
+
+  for (size_t i = 0; i < angles.size(); i++) {
+    float sine, cosine;
+    FastMath<float, Accuracy::fast>::sincos(angles[i], sine, cosine);
+    EXPECT_EQ(sine, sines[i]);
+    EXPECT_EQ(cosine, cosines[i]);
+    EXPECT_EQ((FastMath<float, Accuracy::fast>::atan2(sine, cosine)), directions[i]);
+    if (cosine > 0.0f) {
+      EXPECT_EQ((FastMath<float, Accuracy::accurate>::rsqrt(cosine)), inverse_roots[i]);
+    }
+  }
+}
+
+TEST(FIXED_POINT, ConversionAndArithmetic) {
+  Q16_16 a = 1.5;
+  Q16_16 b = -2.25;
+  EXPECT_EQ(98304, a.raw());
+  EXPECT_EQ(-0.75, double(a + b));
+  EXPECT_EQ(3.75, double(a - b));
+  EXPECT_EQ(-3.375, double(a * b));
+  EXPECT_NEAR(-0.666667, double(a / b), 0.00002);
+  EXPECT_TRUE(b < a && a > 0.0 && a == 1.5);
+
+  static_assert(Q32_32(0.5) * Q32_32(0.5) == Q32_32(0.25));
+}
+
+TEST(FIXED_POINT, Saturation) {
+  const Q16_16 maximum = std::numeric_limits<Q16_16>::max();
+  const Q16_16 lowest = std::numeric_limits<Q16_16>::lowest();
+  EXPECT_EQ(maximum, Q16_16(30000.0) + Q16_16(30000.0));
+  EXPECT_EQ(lowest, Q16_16(-30000.0) - Q16_16(30000.0));
+  EXPECT_EQ(maximum, Q16_16(200.0) * Q16_16(200.0));
+  EXPECT_EQ(lowest, Q16_16(-200.0) * Q16_16(200.0));
+  EXPECT_EQ(maximum, Q16_16(1.0) / Q16_16(0.0));
+  EXPECT_EQ(maximum, -lowest);
+  EXPECT_EQ(maximum, Q16_16(1.0e9));
+}
+
+TEST(FIXED_POINT, SquareRoot) {
+  EXPECT_EQ(Q32_32(3.0), sqrt(Q32_32(9.0)));
+  EXPECT_EQ(Q16_16(0.0), sqrt(Q16_16(-1.0)));
+  for (double value = 0.001; value < 30000.0; value *= 1.1) {
+    Q16_16 root = sqrt(Q16_16(value));
+    Q16_16 next = Q16_16::from_raw(root.raw() + 1);
+    EXPECT_LE(root * root, Q16_16(value));
+    EXPECT_GT(double(next) * double(next), double(Q16_16(value)));
+  }
+}
+
+TEST(FIXED_POINT, Trigonometry) {
+  for (double angle = -20.0; angle < 20.0; angle += 0.001) {
+    EXPECT_NEAR(std::sin(angle), double(sin(Q32_32(angle))), 5.0e-6);
+    EXPECT_NEAR(std::cos(angle), double(cos(Q32_32(angle))), 5.0e-6);
+    EXPECT_NEAR(std::sin(angle), double(sin(Q16_16(angle))), 2.0e-5);
+  }
+  for (double angle = -3.14; angle < 3.14; angle += 0.001) {
+    EXPECT_NEAR(angle, double(atan2(Q32_32(std::sin(angle)), Q32_32(std::cos(angle)))), 1.0e-8);
+    EXPECT_NEAR(angle, double(atan2(Q16_16(50.0 * std::sin(angle)), Q16_16(50.0 * std::cos(angle)))), 2.0e-5);
+  }
+  EXPECT_EQ(Q32_32(0.0), atan2(Q32_32(0.0), Q32_32(0.0)));
+}
+
+TEST(FIXED_POINT, Vector) {
+  Vector2dq32 vector = {3.0, 4.0};
+  EXPECT_EQ(Q32_32(5.0), vector.length());
+  EXPECT_NEAR(std::atan2(4.0, 3.0), double(vector.angle(0, 1)), 1.0e-8);
+  vector.normalize();
+  EXPECT_NEAR(0.6, double(vector[0]), 1.0e-9);
+
+  // the scalar product saturates only its result
+  Vector2dq16 big = {150.0, 150.0};
+  EXPECT_EQ(std::numeric_limits<Q16_16>::max(), big.square_of_length());
+  EXPECT_EQ(Q16_16(0.0), (big * Vector2dq16{1.0, -1.0}));
+  static_assert(Vector2dq32{6.0, 8.0}.length() == 10.0);
+}
+
+// the distance test of the collisions neither rounds nor saturates
+TEST(FIXED_POINT, Within) {
+  typedef VectorKernels<Q16_16, 2u> Kernels;
+  Vector2dq16 origin = {0.0, 0.0}, point = {150.0, 150.0}; // 212.13 apart, the squares saturate
+  EXPECT_TRUE( Kernels::within(point.vector, origin.vector, 212.14) );
+  EXPECT_FALSE( Kernels::within(point.vector, origin.vector, 212.13) );
+  EXPECT_FALSE( Kernels::within(Vector2dq16{3.0, 4.0}.vector, origin.vector, 5.0) );
+  EXPECT_TRUE( Kernels::within(Vector2dq16{3.0, 4.0}.vector, origin.vector, 5.0 + 1.0 / 65536.0) );
+  Vector2dq16 lowest = { std::numeric_limits<Q16_16>::lowest(), std::numeric_limits<Q16_16>::lowest() };
+  Vector2dq16 maximum = { std::numeric_limits<Q16_16>::max(), std::numeric_limits<Q16_16>::max() };
+  EXPECT_FALSE( Kernels::within(lowest.vector, maximum.vector, std::numeric_limits<Q16_16>::max()) );
+  EXPECT_TRUE( Kernels::within(lowest.vector, lowest.vector, std::numeric_limits<Q16_16>::epsilon()) );
+  EXPECT_FALSE( (VectorKernels<Q32_32, 3u>::within(Vector3dq32{1.0, 2.0, 2.0}.vector, Vector3dq32{}.vector, 3.0)) );
+  EXPECT_TRUE( (VectorKernels<Q32_32, 3u>::within(Vector3dq32{1.0, 2.0, 2.0}.vector, Vector3dq32{}.vector, 3.0000001)) );
+  static_assert(Kernels::within(Vector2dq16{1.0, 1.0}.vector, Vector2dq16{}.vector, 1.5));
+}
+
 }
 
 // eigene Tests
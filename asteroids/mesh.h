@@ -0,0 +1,97 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "math.h"
+#include "geometry.h"
+
+// maps a file read only into memory, so that it is parsed without copying it into buffers first
+class MappedFile {
+  const char * data = nullptr;
+  size_t size = 0u;
+  bool open = false;
+public:
+  explicit MappedFile(const std::string & path);
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile & operator=(const MappedFile &) = delete;
+
+  // returns false if the file could not be opened or mapped
+  bool is_open() const;
+
+  std::span<const char> get_data() const;
+};
+
+// a triangle mesh with shared vertices: the positions and normals are stored with one array per axis,
+// and each triangle is three indices into them
+// the meshes are loaded from Wavefront OBJ files or from a binary format written by save_binary,
+// which loads without parsing
+template <class FLOAT, size_t N>
+class Mesh {
+  static_assert(N == 3u); // the normals are cross products
+  static constexpr size_t MIN_CHUNK_SIZE = 1u << 20; // bytes of an OBJ file parsed by one thread at least
+  static constexpr char BINARY_MAGIC[4] = { 'M', 'S', 'H', '1' };
+
+  std::array<std::vector<FLOAT>, N> positions,
+                                    normals;
+  std::vector<std::uint32_t> indices; // three per triangle
+
+  // the header of the binary format, followed by the positions and normals per axis and then the indices
+  struct BinaryHeader {
+    char magic[4];
+    std::uint32_t float_size, vertices, triangles;
+  };
+
+  // returns the line starting at position without the line break and moves position to the next line
+  static std::string_view next_line(std::string_view text, size_t & position);
+
+  // reads a number after optional blanks and moves text behind it, returns false if there is none
+  static bool parse(std::string_view & text, FLOAT & value);
+  static bool parse(std::string_view & text, long & value);
+
+  // returns the number of vertices ("v" lines) of the text
+  static size_t count_vertices(std::string_view text);
+
+  // stores the vertices of the text from positions[*][first_vertex] on and appends the triangles to triangle_indices,
+  // faces with more than three vertices are split into fans, returns false for malformed lines and invalid indices
+  bool parse_chunk(std::string_view text, size_t first_vertex, std::vector<std::uint32_t> & triangle_indices);
+
+  // sets the normal of each vertex to the normalized sum of the normals of its triangles, weighted by their area
+  void compute_normals();
+public:
+  Mesh() = default;
+
+  // loads the vertices ("v") and faces ("f") of an OBJ file with the given number of threads, other lines are ignored
+  // the normals are computed from the triangles with the orientation of Triangle::intersects, OBJ normals are ignored
+  // returns false if the file cannot be read or is malformed, the mesh is empty then
+  bool load_obj(const std::string & path, size_t threads = std::thread::hardware_concurrency());
+
+  // loads and stores the binary format, returns false if the file cannot be read or written,
+  // or if it was written with another FLOAT type
+  bool load_binary(const std::string & path);
+  bool save_binary(const std::string & path) const;
+
+  size_t get_vertex_count() const;
+  size_t get_triangle_count() const;
+
+  Vector<FLOAT, N> get_position(size_t vertex) const;
+  Vector<FLOAT, N> get_normal(size_t vertex) const;
+
+  // returns the vertex indices, three per triangle
+  std::span<const std::uint32_t> get_indices() const;
+
+  // returns the triangle with its vertex normals, see Triangle(a, b, c, na, nb, nc)
+  Triangle<FLOAT, N> get_triangle(size_t triangle) const;
+  std::vector<Triangle<FLOAT, N>> get_triangles() const;
+};
+
+typedef Mesh<float, 3u> Mesh3df;
+
+#endif
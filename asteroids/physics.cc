@@ -8,3 +8,7 @@ template class Physics<float, 2u, BoundingVolumeCircle<float, 2>>;
 template class Body<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
 template class Physics<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
 
+template class BoundingVolumeCircle<Q32_32, 2>;
+template class Body<Q32_32, 2u, BoundingVolumeCircle<Q32_32, 2>>;
+template class Physics<Q32_32, 2u, BoundingVolumeCircle<Q32_32, 2>>;
+
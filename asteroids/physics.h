@@ -7,6 +7,7 @@
 #include <iostream>
 
 #include "math.h"
+#include "fixed_point.h"
 #include "timer.h"
 #include "geometry.h"
 
@@ -51,6 +52,7 @@ template<class FLOAT_TYPE, size_t N, class BV> class Physics;
 
 // dynamic physical body  with a bounding value of type BV
 // the body has a (central) position, a velocity, an orientation defined by an angle and other physical attributes
+// the orientation is also kept as unit direction vector, so that moving along it needs no trigonometric functions
 template<class FLOAT_TYPE, size_t N, class BV>
 class Body  {
 protected:
@@ -59,6 +61,7 @@ protected:
   FLOAT_TYPE max_velocity;
   FLOAT_TYPE min_velocity;
   FLOAT_TYPE angle;
+  Vector<FLOAT_TYPE, N> direction; // (cos(angle), sin(angle), 0, ...), updated by turn()
 
   std::function<void(Body<FLOAT_TYPE, N, BV> *, FLOAT_TYPE)> fix; // fix object values after movement
 
@@ -75,6 +78,17 @@ public:
 
             = [](Body<FLOAT_TYPE, N, BV> * , FLOAT_TYPE ) -> void {  }); 
 
+  // the same as above with the orientation given by a vector in the x/y-Plane, which is normalized
+  Body(  BV bounding_volume,
+         Vector<FLOAT_TYPE, N> velocity,
+         FLOAT_TYPE max_velocity,
+         FLOAT_TYPE min_velocity,
+         Vector<FLOAT_TYPE, N> direction,
+
+         std::function<void(Body<FLOAT_TYPE, N, BV> *, FLOAT_TYPE)> fix
+
+            = [](Body<FLOAT_TYPE, N, BV> * , FLOAT_TYPE ) -> void {  });
+
  
 
  void move(FLOAT_TYPE seconds = 1.0);
@@ -83,6 +97,7 @@ public:
 
   // turns the Body in the x/y-Plane 
   // angle is measured in radians
+  // the direction is rotated incrementally and normalized again, so that it stays a unit vector
   void turn(FLOAT_TYPE angle, FLOAT_TYPE seconds = 1.0);
 
   void set_velocity(Vector<FLOAT_TYPE, N> velocity);
@@ -99,6 +114,9 @@ public:
   bool is_marked_for_deletion() const;
   
   FLOAT_TYPE get_angle() const;
+
+  // returns the unit vector pointing in the direction of the angle
+  Vector<FLOAT_TYPE, N> get_direction() const;
   
   void set_time_to_delete(FLOAT_TYPE time_to_delete);
   
@@ -172,8 +190,30 @@ typedef BoundingVolumeCircle<float, 2u> BoundingVolume2df;
 typedef Body<float, 2u, BoundingVolume2df> Body2df;
 typedef Physics<float, 2u, BoundingVolume2df> Physics2df;
 
+// bit-identical simulations on every platform
+typedef BoundingVolumeCircle<Q32_32, 2u> BoundingVolume2dq32;
+typedef Body<Q32_32, 2u, BoundingVolume2dq32> Body2dq32;
+typedef Physics<Q32_32, 2u, BoundingVolume2dq32> Physics2dq32;
+
 typedef BoundingVolumeHyperRectangle<float, 2u> Rectangle2df;
 typedef Body<float, 2u, Rectangle2df> BodyRect2df;
 typedef Physics<float, 2u, Rectangle2df> PhysicsRect2df;
 
+// with INLINE_TEMPLATES defined, the definitions are visible in every translation unit,
+// so that the accessors and collision tests called by Game are inlined without link time optimization
+#ifdef INLINE_TEMPLATES
+#include "physics.tcc"
+
+extern template class BoundingVolumeCircle<float, 2>;
+extern template class BoundingVolumeHyperRectangle<float, 2>;
+extern template class Body<float, 2u, BoundingVolumeCircle<float, 2>>;
+extern template class Physics<float, 2u, BoundingVolumeCircle<float, 2>>;
+extern template class Body<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
+extern template class Physics<float, 2u, BoundingVolumeHyperRectangle<float, 2>>;
+
+extern template class BoundingVolumeCircle<Q32_32, 2>;
+extern template class Body<Q32_32, 2u, BoundingVolumeCircle<Q32_32, 2>>;
+extern template class Physics<Q32_32, 2u, BoundingVolumeCircle<Q32_32, 2>>;
+#endif
+
 #endif
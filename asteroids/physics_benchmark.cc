@@ -0,0 +1,95 @@
+#include "physics.h"
+#include "physics.tcc"
+#include "geometry.tcc"
+#include "fixed_point.h"
+#include "vector_expression.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// micro benchmark of the body integration path of the physics engine
+// compares position + seconds * velocity written with plain Vector operators
+// against the expression template version used by Body::move
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc geometry.cc physics.cc timer.cc physics_benchmark.cc -lSDL2 -o physics_benchmark
+// run it with "perf stat -e instructions" to compare instruction counts
+// the collision tests compare the float bounding volumes against the fixed-point ones,
+// Q16.16 compares the squared distances exactly in 64 bit and takes about as long as float,
+// Q32.32 needs 128 bit products and takes about three times as long
+
+namespace {
+
+constexpr size_t NO_OF_BODIES = 1024u;
+constexpr size_t REPETITIONS = 20000u;
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+// calls operation REPETITIONS times and prints the average time per body
+template <class OPERATION>
+void measure(const char * name, OPERATION operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < REPETITIONS; repetition++) {
+    operation();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << name << ": " << nanoseconds / (REPETITIONS * NO_OF_BODIES) << " ns/body" << std::endl;
+}
+
+// tests every pair of NO_OF_BODIES bounding volumes for collisions and prints the average time per test
+template <class FLOAT_TYPE>
+void measure_collisions(const char * name) {
+  std::vector<BoundingVolumeCircle<FLOAT_TYPE, 2u>> volumes;
+  for (size_t i = 0u; i < NO_OF_BODIES; i++) {
+    Vector<FLOAT_TYPE, 2u> position = { static_cast<FLOAT_TYPE>(i * 37 % 1024), static_cast<FLOAT_TYPE>(0.75 * (i * 53 % 1024)) };
+    volumes.push_back( BoundingVolumeCircle<FLOAT_TYPE, 2u>{ position, static_cast<FLOAT_TYPE>(10.0 + i % 7) } );
+  }
+  constexpr size_t COLLISION_REPETITIONS = 50u;
+  size_t collisions = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < COLLISION_REPETITIONS; repetition++) {
+    for (size_t i = 0u; i < volumes.size(); i++) {
+      for (size_t j = i + 1u; j < volumes.size(); j++) {
+        collisions += volumes[i].collides(volumes[j]);
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  double tests = COLLISION_REPETITIONS * NO_OF_BODIES * (NO_OF_BODIES - 1u) / 2.0;
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << name << ": " << nanoseconds / tests << " ns/test (" << collisions / COLLISION_REPETITIONS << " collisions)" << std::endl;
+}
+
+}
+
+int main() {
+  const float seconds = 1.0f / 60.0f;
+  std::vector<Vector2df> positions;
+  std::vector<Vector2df> velocities;
+  std::vector<Body2df> bodies;
+  for (size_t i = 0u; i < NO_OF_BODIES; i++) {
+    positions.push_back( Vector2df{ 1.0f * (i % 1024), 0.5f * (i % 768) } );
+    velocities.push_back( Vector2df{ 0.5f * (i % 13) - 3.0f, 0.25f * (i % 11) - 1.0f } );
+    bodies.push_back( Body2df{ BoundingVolume2df{positions.back(), 1.0f}, velocities.back(), 1000.0f } );
+  }
+
+  measure("integration with temporaries", [&]() {
+    for (size_t i = 0u; i < NO_OF_BODIES; i++) {
+      positions[i] = positions[i] + seconds * velocities[i];
+    }
+  });
+  measure("integration with expression templates", [&]() {
+    for (size_t i = 0u; i < NO_OF_BODIES; i++) {
+      positions[i] = lazy(positions[i]) + seconds * lazy(velocities[i]);
+    }
+  });
+  measure("Body::move", [&]() {
+    for (Body2df & body : bodies) {
+      body.move(seconds);
+    }
+  });
+  measure_collisions<float>("collision tests float");
+  measure_collisions<Q16_16>("collision tests Q16.16");
+  measure_collisions<Q32_32>("collision tests Q32.32");
+  sink = positions[0][0] + bodies[0].get_position()[0];
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include "physics.h"
+#include "physics.tcc" // for the 3d bodies, which physics.cc does not instantiate
 #include "gtest/gtest.h"
 
 
@@ -142,6 +143,62 @@ TEST(BODY, AccelerateAndMoveWithMaximumVelocity) {
   EXPECT_NEAR(0.0, body.get_position()[1], 0.00001);
 }
 
+TEST(BODY, TurnAndAccelerate) {
+  Body2df body( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, 0.0}, 10.0, 0.0, PI / 2.0f );
+  EXPECT_NEAR(0.0, body.get_direction()[0], 0.00001);
+  EXPECT_NEAR(1.0, body.get_direction()[1], 0.00001);
+  body.turn(PI / 0.6f, 0.3f); // a large angle
+  body.turn(-PI / 4.0f, 1.0f / 60.0f);
+  body.accelerate(2.0);
+  EXPECT_NEAR(-2.0 * std::cos(PI / 240.0), body.get_velocity()[0], 0.00001);
+  EXPECT_NEAR(2.0 * std::sin(PI / 240.0), body.get_velocity()[1], 0.00001);
+
+  Body2df fired( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, 0.0}, 10.0, 0.0, Vector2df{0.6, -0.8} );
+  EXPECT_NEAR(std::atan2(-0.8, 0.6), fired.get_angle(), 0.00001);
+
+  // the direction is normalized
+  Body2df scaled( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, 0.0}, 10.0, 0.0, Vector2df{3.0, 4.0} );
+  EXPECT_NEAR(0.6, scaled.get_direction()[0], 0.00001);
+  EXPECT_NEAR(0.8, scaled.get_direction()[1], 0.00001);
+  scaled.accelerate(2.0);
+  EXPECT_NEAR(2.0, scaled.get_velocity().length(), 0.00001);
+}
+
+// a million ticks (4.6 hours) of turning keep the direction a unit vector, which follows the exact angle
+// up to the rounding of the rotations (the float angle itself has drifted further by then)
+TEST(BODY, DirectionStaysNormalized) {
+  Body2df body( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, 0.0}, 10.0, 0.0, 0.5f );
+  double angle = 0.5;
+  for (size_t tick = 0; tick < 1000000; tick++) {
+    float turn = tick % 1000 < 600 ? PI / 0.6f : -PI / 0.7f;
+    body.turn(turn, 1.0f / 60.0f);
+    angle += static_cast<double>((1.0f / 60.0f) * turn);
+  }
+  EXPECT_NEAR(1.0, body.get_direction().length(), 0.000001);
+  EXPECT_NEAR(std::cos(angle), body.get_direction()[0], 0.005);
+  EXPECT_NEAR(std::sin(angle), body.get_direction()[1], 0.005);
+}
+
+// in 3d the direction stays in the x/y-plane
+TEST(BODY, DirectionStaysNormalized3d) {
+  Body<float, 3u, BoundingVolumeCircle<float, 3u>> body( BoundingVolumeCircle<float, 3u>({0.0, 0.0, 0.0}, 1.0), {0.0, 0.0, 0.0}, 10.0, 0.0, 0.5f );
+  EXPECT_NEAR(1.0, body.get_direction().length(), 0.000001);
+  EXPECT_EQ(0.0f, body.get_direction()[2]);
+  for (size_t tick = 0; tick < 10000; tick++) {
+    body.turn(tick % 1000 < 600 ? PI / 0.6f : -PI / 0.7f, 1.0f / 60.0f);
+  }
+  EXPECT_NEAR(1.0, body.get_direction().length(), 0.000001);
+  EXPECT_EQ(0.0f, body.get_direction()[2]);
+  body.accelerate(2.0);
+  EXPECT_NEAR(2.0, body.get_velocity().length(), 0.00001);
+  EXPECT_EQ(0.0f, body.get_velocity()[2]);
+
+  Body<float, 3u, BoundingVolumeCircle<float, 3u>> fired( BoundingVolumeCircle<float, 3u>({0.0, 0.0, 0.0}, 1.0), {0.0, 0.0, 0.0}, 10.0, 0.0,
+                                                          Vector<float, 3u>{0.0, -2.0, 0.0} );
+  EXPECT_NEAR(-1.0, fired.get_direction()[1], 0.00001);
+  EXPECT_EQ(0.0f, fired.get_direction()[2]);
+}
+
 TEST(PHYSICS, IsAreaFreeOfBodiesTrue) {
   Body2df body1( BoundingVolume2df({2.0, 2.0}, 1.0), {-0.5, -0.5} );
   Body2df body2( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, -1.0} );
@@ -277,4 +334,62 @@ TEST(PHYSICS, TickTime120) {
   EXPECT_NEAR(768.0, std::round(body.get_position()[1]), 0.00001);
 }
 
+
+// Body2dq32 has to behave like Body2df within the resolution of the fixed-point type
+TEST(FIXED_POINT_PHYSICS, AccelerateAndMoveWithMaximumVelocity) {
+  Body2dq32 body( BoundingVolume2dq32({0.0, 0.0}, 1.0), {1.0, 0.0}, 2.0);
+  body.accelerate(0.5);
+  body.accelerate(0.5);
+  body.accelerate(0.5);
+  body.move();
+  EXPECT_NEAR(2.0, double(body.get_position()[0]), 0.00001);
+  EXPECT_NEAR(0.0, double(body.get_position()[1]), 0.00001);
+}
+
+// simulates turning, accelerating and colliding bodies in a wrapping 1024 x 768 area
+// and returns a checksum of the raw fixed-point state and the number of collisions
+std::pair<std::uint64_t, size_t> simulate_fixed_point_bodies() {
+  auto wrap = [](Body<Q32_32, 2u, BoundingVolume2dq32> * body, Q32_32) -> void {
+    Vector2dq32 position = body->get_position();
+    position[0] = position[0] < 0.0 ? position[0] + 1024.0 : (position[0] > 1024.0 ? position[0] - 1024.0 : position[0]);
+    position[1] = position[1] < 0.0 ? position[1] + 768.0 : (position[1] > 768.0 ? position[1] - 768.0 : position[1]);
+    body->set_position(position);
+  };
+  std::vector<Body2dq32> bodies;
+  for (size_t i = 0; i < 16; i++) {
+    bodies.push_back( Body2dq32( BoundingVolume2dq32({ 60.0 * i, 45.0 * (i % 7) }, 5.0 + i % 3),
+                                 { 17.0 - 3.0 * (i % 11), 11.0 - 2.0 * (i % 9) }, 300.0, 0.0, 0.25 * i, wrap ) );
+  }
+  size_t collisions = 0;
+  Physics2dq32 physics( [](Body2dq32 *, Body2dq32 *) -> bool { return true; },
+                        [&](Body2dq32 * body1, Body2dq32 * body2) -> void { collisions++; body1->bounce(0); body2->bounce(1); } );
+  for (Body2dq32 & body : bodies) {
+    physics.add_body( &body );
+  }
+  const Q32_32 tick_time = 1.0 / 60.0;
+  for (size_t tick = 0; tick < 600; tick++) {
+    for (size_t i = 0; i < bodies.size(); i++) {
+      bodies[i].turn(0.5 * Q32_32(double(i % 5) - 2.0), tick_time);
+      bodies[i].accelerate(20.0, tick_time);
+    }
+    physics.tick(tick_time);
+  }
+  std::uint64_t checksum = 0;
+  for (Body2dq32 & body : bodies) {
+    for (size_t axis = 0; axis < 2; axis++) {
+      checksum = 31 * checksum + static_cast<std::uint64_t>(body.get_position()[axis].raw());
+      checksum = 31 * checksum + static_cast<std::uint64_t>(body.get_velocity()[axis].raw());
+    }
+  }
+  return { checksum, collisions };
+}
+
+// the expected checksum is the same for every compiler, platform and optimization level
+TEST(FIXED_POINT_PHYSICS, SimulationIsBitIdentical) {
+  std::pair<std::uint64_t, size_t> result = simulate_fixed_point_bodies();
+  EXPECT_EQ(result, simulate_fixed_point_bodies());
+  EXPECT_EQ(6492756025763845860u, result.first);
+  EXPECT_EQ(48u, result.second);
+}
+
 }
@@ -0,0 +1,7 @@
+#include "quantized_vector_array.h"
+#include "quantized_vector_array.tcc"
+
+// template instantiations for the 2-, 3- and 4-dimensional float cases
+template class QuantizedVectorArray<float, 2u>;
+template class QuantizedVectorArray<float, 3u>;
+template class QuantizedVectorArray<float, 4u>;
@@ -0,0 +1,117 @@
+#ifndef QUANTIZED_VECTOR_ARRAY_TCC
+#define QUANTIZED_VECTOR_ARRAY_TCC
+
+#include <algorithm>
+#include <cassert>
+#include "quantized_vector_array.h"
+
+// the float to int conversion and both clamps have SIMD instructions, so that the loops vectorize
+template <class FLOAT_TYPE, size_t N>
+inline std::uint16_t QuantizedVectorArray<FLOAT_TYPE, N>::quantize(FLOAT_TYPE value) {
+  value = std::min(std::max(value + static_cast<FLOAT_TYPE>(0.5), static_cast<FLOAT_TYPE>(0.0)), static_cast<FLOAT_TYPE>(65535.0));
+  return static_cast<std::uint16_t>(static_cast<std::int32_t>(value));
+}
+
+template <class FLOAT_TYPE, size_t N>
+QuantizedVectorArray<FLOAT_TYPE, N>::QuantizedVectorArray(const Vector<FLOAT_TYPE, N> minimum, const Vector<FLOAT_TYPE, N> maximum, size_t size)
+  : minimum(minimum), maximum(maximum), step(maximum - minimum), inverse_step(maximum - minimum) {
+  step /= LEVELS;
+  for (size_t axis = 0u; axis < N; axis++) {
+    assert(minimum[axis] < maximum[axis]);
+    inverse_step[axis] = LEVELS / inverse_step[axis];
+  }
+  resize(size);
+}
+
+template <class FLOAT_TYPE, size_t N>
+size_t QuantizedVectorArray<FLOAT_TYPE, N>::size() const {
+  return axes[0].size();
+}
+
+template <class FLOAT_TYPE, size_t N>
+void QuantizedVectorArray<FLOAT_TYPE, N>::resize(size_t size) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis].resize(size, 0u);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> QuantizedVectorArray<FLOAT_TYPE, N>::get_minimum() const {
+  return minimum;
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> QuantizedVectorArray<FLOAT_TYPE, N>::get_maximum() const {
+  return maximum;
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> QuantizedVectorArray<FLOAT_TYPE, N>::get(size_t i) const {
+  Vector<FLOAT_TYPE, N> vector = {};
+  for (size_t axis = 0u; axis < N; axis++) {
+    vector[axis] = minimum[axis] + step[axis] * axes[axis][i];
+  }
+  return vector;
+}
+
+template <class FLOAT_TYPE, size_t N>
+void QuantizedVectorArray<FLOAT_TYPE, N>::set(size_t i, const Vector<FLOAT_TYPE, N> vector) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis][i] = quantize((vector[axis] - minimum[axis]) * inverse_step[axis]);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::span<const std::uint16_t> QuantizedVectorArray<FLOAT_TYPE, N>::axis(size_t axis) const {
+  return axes[axis];
+}
+
+// the kernels run one plain loop per axis over contiguous values like the ones of VectorArray
+
+template <class FLOAT_TYPE, size_t N>
+void QuantizedVectorArray<FLOAT_TYPE, N>::pack(const VectorArray<FLOAT_TYPE, N> & vectors) {
+  resize(vectors.size());
+  const size_t count = size();
+  for (size_t axis = 0u; axis < N; axis++) {
+    const FLOAT_TYPE * values = vectors.axis(axis).data();
+    std::uint16_t * quantized = axes[axis].data();
+    const FLOAT_TYPE offset = minimum[axis];
+    const FLOAT_TYPE factor = inverse_step[axis];
+    for (size_t i = 0u; i < count; i++) {
+      quantized[i] = quantize((values[i] - offset) * factor);
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void QuantizedVectorArray<FLOAT_TYPE, N>::pack(std::span<const Vector<FLOAT_TYPE, N>> vectors) {
+  resize(vectors.size());
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    set(i, vectors[i]);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void QuantizedVectorArray<FLOAT_TYPE, N>::unpack(VectorArray<FLOAT_TYPE, N> & vectors) const {
+  vectors.resize(size());
+  const size_t count = size();
+  for (size_t axis = 0u; axis < N; axis++) {
+    FLOAT_TYPE * values = vectors.axis(axis).data();
+    const std::uint16_t * quantized = axes[axis].data();
+    const FLOAT_TYPE offset = minimum[axis];
+    const FLOAT_TYPE factor = step[axis];
+    for (size_t i = 0u; i < count; i++) {
+      values[i] = offset + factor * quantized[i];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void QuantizedVectorArray<FLOAT_TYPE, N>::unpack(std::span<Vector<FLOAT_TYPE, N>> vectors, size_t start) const {
+  assert(start + vectors.size() <= size());
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    vectors[i] = get(start + i);
+  }
+}
+
+#endif
@@ -0,0 +1,5 @@
+#include "geometry.h"
+#include "ray_packet.tcc"
+
+template struct RayPacket<float, 3u, 4u>;
+template struct RayPacket<float, 3u, 8u>;
@@ -0,0 +1,248 @@
+#ifndef RAY_PACKET_TCC
+#define RAY_PACKET_TCC
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "ray_packet.h"
+#include "geometry.h"
+
+#if defined(__SSE__) && ! defined(MATH_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+template <class FLOAT, size_t N, size_t WIDTH>
+RayPacket<FLOAT, N, WIDTH>::RayPacket(std::span<const Ray<FLOAT, N>> rays) {
+  assert(rays.size() == WIDTH);
+  for (size_t lane = 0u; lane < WIDTH; lane++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      origin[axis][lane] = rays[lane].origin[axis];
+      direction[axis][lane] = rays[lane].direction[axis];
+    }
+  }
+}
+
+template <class FLOAT, size_t N, size_t WIDTH>
+Ray<FLOAT, N> RayPacket<FLOAT, N, WIDTH>::get_ray(size_t lane) const {
+  Ray<FLOAT, N> ray{ Vector<FLOAT, N>{}, Vector<FLOAT, N>{} };
+  for (size_t axis = 0u; axis < N; axis++) {
+    ray.origin[axis] = origin[axis][lane];
+    ray.direction[axis] = direction[axis][lane];
+  }
+  return ray;
+}
+
+// WIDTH values with the operations used by the packet intersections, one value per ray of a RayPacket
+// the generic version loops over the lanes, the specializations below use one SSE or AVX register
+template <class FLOAT, size_t WIDTH>
+struct Lanes {
+  std::array<FLOAT, WIDTH> values;
+
+  // the result of a comparison per lane
+  struct Mask {
+    std::array<bool, WIDTH> values;
+
+    friend Mask operator&(const Mask mask1, const Mask mask2) {
+      Mask mask;
+      for (size_t lane = 0u; lane < WIDTH; lane++) {
+        mask.values[lane] = mask1.values[lane] & mask2.values[lane];
+      }
+      return mask;
+    }
+
+    friend Mask operator|(const Mask mask1, const Mask mask2) {
+      Mask mask;
+      for (size_t lane = 0u; lane < WIDTH; lane++) {
+        mask.values[lane] = mask1.values[lane] | mask2.values[lane];
+      }
+      return mask;
+    }
+
+    // returns bit i set for each true lane i
+    std::uint32_t bits() const {
+      std::uint32_t bits = 0u;
+      for (size_t lane = 0u; lane < WIDTH; lane++) {
+        bits |= static_cast<std::uint32_t>(values[lane]) << lane;
+      }
+      return bits;
+    }
+  };
+
+  template <class OPERATION>
+  static Lanes apply(const Lanes lanes1, const Lanes lanes2, OPERATION operation) {
+    Lanes lanes;
+    for (size_t lane = 0u; lane < WIDTH; lane++) {
+      lanes.values[lane] = operation(lanes1.values[lane], lanes2.values[lane]);
+    }
+    return lanes;
+  }
+
+  template <class COMPARISON>
+  static Mask compare(const Lanes lanes1, const Lanes lanes2, COMPARISON comparison) {
+    Mask mask;
+    for (size_t lane = 0u; lane < WIDTH; lane++) {
+      mask.values[lane] = comparison(lanes1.values[lane], lanes2.values[lane]);
+    }
+    return mask;
+  }
+
+  static Lanes broadcast(FLOAT value) {
+    Lanes lanes;
+    lanes.values.fill(value);
+    return lanes;
+  }
+
+  static Lanes load(const std::array<FLOAT, WIDTH> & values) {
+    return Lanes{ values };
+  }
+
+  // loads WIDTH contiguous values, e.g. from an axis of a VectorArray
+  static Lanes load(const FLOAT * values) {
+    Lanes lanes;
+    std::copy(values, values + WIDTH, lanes.values.begin());
+    return lanes;
+  }
+
+  void store(std::array<FLOAT, WIDTH> & values) const {
+    values = this->values;
+  }
+
+  friend Lanes operator+(const Lanes lanes1, const Lanes lanes2) { return apply(lanes1, lanes2, [](FLOAT x, FLOAT y) { return x + y; }); }
+  friend Lanes operator-(const Lanes lanes1, const Lanes lanes2) { return apply(lanes1, lanes2, [](FLOAT x, FLOAT y) { return x - y; }); }
+  friend Lanes operator*(const Lanes lanes1, const Lanes lanes2) { return apply(lanes1, lanes2, [](FLOAT x, FLOAT y) { return x * y; }); }
+  friend Lanes operator/(const Lanes lanes1, const Lanes lanes2) { return apply(lanes1, lanes2, [](FLOAT x, FLOAT y) { return x / y; }); }
+  friend Lanes min(const Lanes lanes1, const Lanes lanes2) { return apply(lanes1, lanes2, [](FLOAT x, FLOAT y) { return y < x ? y : x; }); }
+  friend Lanes max(const Lanes lanes1, const Lanes lanes2) { return apply(lanes1, lanes2, [](FLOAT x, FLOAT y) { return x < y ? y : x; }); }
+  friend Lanes sqrt(const Lanes lanes) { return apply(lanes, lanes, [](FLOAT x, FLOAT) { return std::sqrt(x); }); }
+  friend Lanes abs(const Lanes lanes) { return apply(lanes, lanes, [](FLOAT x, FLOAT) { return std::fabs(x); }); }
+
+  friend Mask operator<(const Lanes lanes1, const Lanes lanes2) { return compare(lanes1, lanes2, [](FLOAT x, FLOAT y) { return x < y; }); }
+  friend Mask operator<=(const Lanes lanes1, const Lanes lanes2) { return compare(lanes1, lanes2, [](FLOAT x, FLOAT y) { return x <= y; }); }
+
+  // returns the lanes of lanes1 where mask is true, and of lanes2 elsewhere
+  friend Lanes select(const Mask mask, const Lanes lanes1, const Lanes lanes2) {
+    Lanes lanes;
+    for (size_t lane = 0u; lane < WIDTH; lane++) {
+      lanes.values[lane] = mask.values[lane] ? lanes1.values[lane] : lanes2.values[lane];
+    }
+    return lanes;
+  }
+};
+
+#if defined(__SSE__) && ! defined(MATH_NO_SIMD)
+// four float lanes in one SSE register, a mask has all bits of a true lane set
+template <>
+struct Lanes<float, 4u> {
+  __m128 values;
+
+  struct Mask {
+    __m128 values;
+
+    friend Mask operator&(const Mask mask1, const Mask mask2) { return { _mm_and_ps(mask1.values, mask2.values) }; }
+    friend Mask operator|(const Mask mask1, const Mask mask2) { return { _mm_or_ps(mask1.values, mask2.values) }; }
+
+    std::uint32_t bits() const { return static_cast<std::uint32_t>(_mm_movemask_ps(values)); }
+  };
+
+  static Lanes broadcast(float value) { return { _mm_set1_ps(value) }; }
+  static Lanes load(const std::array<float, 4u> & values) { return { _mm_loadu_ps(values.data()) }; }
+  static Lanes load(const float * values) { return { _mm_loadu_ps(values) }; }
+  void store(std::array<float, 4u> & values) const { _mm_storeu_ps(values.data(), this->values); }
+
+  friend Lanes operator+(const Lanes lanes1, const Lanes lanes2) { return { _mm_add_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes operator-(const Lanes lanes1, const Lanes lanes2) { return { _mm_sub_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes operator*(const Lanes lanes1, const Lanes lanes2) { return { _mm_mul_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes operator/(const Lanes lanes1, const Lanes lanes2) { return { _mm_div_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes min(const Lanes lanes1, const Lanes lanes2) { return { _mm_min_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes max(const Lanes lanes1, const Lanes lanes2) { return { _mm_max_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes sqrt(const Lanes lanes) { return { _mm_sqrt_ps(lanes.values) }; }
+  friend Lanes abs(const Lanes lanes) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), lanes.values) }; }
+
+  friend Mask operator<(const Lanes lanes1, const Lanes lanes2) { return { _mm_cmplt_ps(lanes1.values, lanes2.values) }; }
+  friend Mask operator<=(const Lanes lanes1, const Lanes lanes2) { return { _mm_cmple_ps(lanes1.values, lanes2.values) }; }
+
+  friend Lanes select(const Mask mask, const Lanes lanes1, const Lanes lanes2) {
+    return { _mm_or_ps(_mm_and_ps(mask.values, lanes1.values), _mm_andnot_ps(mask.values, lanes2.values)) };
+  }
+};
+
+#ifdef __AVX__
+// eight float lanes in one AVX register
+template <>
+struct Lanes<float, 8u> {
+  __m256 values;
+
+  struct Mask {
+    __m256 values;
+
+    friend Mask operator&(const Mask mask1, const Mask mask2) { return { _mm256_and_ps(mask1.values, mask2.values) }; }
+    friend Mask operator|(const Mask mask1, const Mask mask2) { return { _mm256_or_ps(mask1.values, mask2.values) }; }
+
+    std::uint32_t bits() const { return static_cast<std::uint32_t>(_mm256_movemask_ps(values)); }
+  };
+
+  static Lanes broadcast(float value) { return { _mm256_set1_ps(value) }; }
+  static Lanes load(const std::array<float, 8u> & values) { return { _mm256_loadu_ps(values.data()) }; }
+  static Lanes load(const float * values) { return { _mm256_loadu_ps(values) }; }
+  void store(std::array<float, 8u> & values) const { _mm256_storeu_ps(values.data(), this->values); }
+
+  friend Lanes operator+(const Lanes lanes1, const Lanes lanes2) { return { _mm256_add_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes operator-(const Lanes lanes1, const Lanes lanes2) { return { _mm256_sub_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes operator*(const Lanes lanes1, const Lanes lanes2) { return { _mm256_mul_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes operator/(const Lanes lanes1, const Lanes lanes2) { return { _mm256_div_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes min(const Lanes lanes1, const Lanes lanes2) { return { _mm256_min_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes max(const Lanes lanes1, const Lanes lanes2) { return { _mm256_max_ps(lanes1.values, lanes2.values) }; }
+  friend Lanes sqrt(const Lanes lanes) { return { _mm256_sqrt_ps(lanes.values) }; }
+  friend Lanes abs(const Lanes lanes) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), lanes.values) }; }
+
+  friend Mask operator<(const Lanes lanes1, const Lanes lanes2) { return { _mm256_cmp_ps(lanes1.values, lanes2.values, _CMP_LT_OQ) }; }
+  friend Mask operator<=(const Lanes lanes1, const Lanes lanes2) { return { _mm256_cmp_ps(lanes1.values, lanes2.values, _CMP_LE_OQ) }; }
+
+  friend Lanes select(const Mask mask, const Lanes lanes1, const Lanes lanes2) { return { _mm256_blendv_ps(lanes2.values, lanes1.values, mask.values) }; }
+};
+#else
+// eight float lanes in two SSE registers
+template <>
+struct Lanes<float, 8u> {
+  Lanes<float, 4u> low, high;
+
+  struct Mask {
+    Lanes<float, 4u>::Mask low, high;
+
+    friend Mask operator&(const Mask mask1, const Mask mask2) { return { mask1.low & mask2.low, mask1.high & mask2.high }; }
+    friend Mask operator|(const Mask mask1, const Mask mask2) { return { mask1.low | mask2.low, mask1.high | mask2.high }; }
+
+    std::uint32_t bits() const { return low.bits() | (high.bits() << 4); }
+  };
+
+  static Lanes broadcast(float value) { return { Lanes<float, 4u>::broadcast(value), Lanes<float, 4u>::broadcast(value) }; }
+  static Lanes load(const std::array<float, 8u> & values) {
+    return { { _mm_loadu_ps(values.data()) }, { _mm_loadu_ps(values.data() + 4) } };
+  }
+  static Lanes load(const float * values) { return { { _mm_loadu_ps(values) }, { _mm_loadu_ps(values + 4) } }; }
+  void store(std::array<float, 8u> & values) const {
+    _mm_storeu_ps(values.data(), low.values);
+    _mm_storeu_ps(values.data() + 4, high.values);
+  }
+
+  friend Lanes operator+(const Lanes lanes1, const Lanes lanes2) { return { lanes1.low + lanes2.low, lanes1.high + lanes2.high }; }
+  friend Lanes operator-(const Lanes lanes1, const Lanes lanes2) { return { lanes1.low - lanes2.low, lanes1.high - lanes2.high }; }
+  friend Lanes operator*(const Lanes lanes1, const Lanes lanes2) { return { lanes1.low * lanes2.low, lanes1.high * lanes2.high }; }
+  friend Lanes operator/(const Lanes lanes1, const Lanes lanes2) { return { lanes1.low / lanes2.low, lanes1.high / lanes2.high }; }
+  friend Lanes min(const Lanes lanes1, const Lanes lanes2) { return { min(lanes1.low, lanes2.low), min(lanes1.high, lanes2.high) }; }
+  friend Lanes max(const Lanes lanes1, const Lanes lanes2) { return { max(lanes1.low, lanes2.low), max(lanes1.high, lanes2.high) }; }
+  friend Lanes sqrt(const Lanes lanes) { return { sqrt(lanes.low), sqrt(lanes.high) }; }
+  friend Lanes abs(const Lanes lanes) { return { abs(lanes.low), abs(lanes.high) }; }
+
+  friend Mask operator<(const Lanes lanes1, const Lanes lanes2) { return { lanes1.low < lanes2.low, lanes1.high < lanes2.high }; }
+  friend Mask operator<=(const Lanes lanes1, const Lanes lanes2) { return { lanes1.low <= lanes2.low, lanes1.high <= lanes2.high }; }
+
+  friend Lanes select(const Mask mask, const Lanes lanes1, const Lanes lanes2) {
+    return { select(mask.low, lanes1.low, lanes2.low), select(mask.high, lanes1.high, lanes2.high) };
+  }
+};
+#endif
+#endif
+
+#endif
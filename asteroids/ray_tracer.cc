@@ -0,0 +1,6 @@
+#include "ray_tracer.h"
+#include "ray_tracer.tcc"
+
+template class Image<float>;
+template class Camera<float, 3u>;
+template class RayTracer<float, 3u>;
@@ -0,0 +1,130 @@
+#ifndef RAY_TRACER_H
+#define RAY_TRACER_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "math.h"
+#include "geometry.h"
+#include "bvh.h"
+
+// the surface of an object: the fractions of the light that it reflects and transmits,
+// the rest is lit diffusely with its color
+template <class FLOAT>
+struct Material {
+  Vector<FLOAT, 3u> color;
+  FLOAT reflection = 0.0,
+        transparency = 0.0,
+        refraction_index = 1.0; // relative to the surrounding medium
+};
+
+// a point light
+template <class FLOAT, size_t N>
+struct Light {
+  Vector<FLOAT, N> position;
+  Vector<FLOAT, 3u> color;
+};
+
+// an image with linear RGB values per pixel, the first row is the top one
+template <class FLOAT>
+class Image {
+  size_t width, height;
+  std::vector<FLOAT> values; // red, green and blue of each pixel
+public:
+  Image(size_t width, size_t height);
+
+  size_t get_width() const;
+  size_t get_height() const;
+
+  Vector<FLOAT, 3u> get_pixel(size_t x, size_t y) const;
+  void set_pixel(size_t x, size_t y, Vector<FLOAT, 3u> color);
+
+  // writes an 8 bit binary PPM with the values clamped to [0, 1] and gamma corrected for display,
+  // returns false if the file cannot be written
+  bool write_ppm(const std::string & path) const;
+
+  // writes a little endian PFM with the linear values, which keeps the range above 1
+  bool write_pfm(const std::string & path) const;
+};
+
+// a pinhole camera at position looking at look_at, field_of_view is the vertical opening angle in radians
+template <class FLOAT, size_t N>
+class Camera {
+  static_assert(N == 3u);
+  Vector<FLOAT, N> position,
+                   forward, // to the center of the image plane at distance 1
+                   right,   // to the right border of the image plane, scaled by the aspect ratio in get_ray
+                   up;      // to the upper border
+public:
+  Camera(Vector<FLOAT, N> position, Vector<FLOAT, N> look_at, Vector<FLOAT, N> up, FLOAT field_of_view);
+
+  // returns the normalized ray through the point x, y of an image with width times height pixels,
+  // e.g. x = 0.5, y = 0.5 is the center of the upper left pixel
+  Ray<FLOAT, N> get_ray(FLOAT x, FLOAT y, size_t width, size_t height) const;
+};
+
+// a Whitted ray tracer: each camera ray is followed to the closest surface, which is lit by the point lights that
+// it sees (shadow rays), and mirror reflections and refractions are followed recursively up to max_depth
+// the image is split into tiles of TILE_SIZE x TILE_SIZE pixels, which are rendered by a pool of threads,
+// each thread takes the tiles from the front of its own queue and steals from the back of the others when it runs out,
+// so that threads with cheap tiles (background) help the ones with expensive tiles (glass)
+template <class FLOAT, size_t N>
+class RayTracer {
+  static_assert(N == 3u);
+  static constexpr size_t TILE_SIZE = 16u;
+  static constexpr FLOAT OFFSET = 1e-4; // moves the origins of secondary rays off the surface against self intersections
+  static constexpr FLOAT AMBIENT = 0.1;
+
+  std::vector<Sphere<FLOAT, N>> spheres;
+  std::vector<Material<FLOAT>> sphere_materials;
+  std::vector<BoundingVolumeHierarchy<FLOAT, N>> meshes;
+  std::vector<Material<FLOAT>> mesh_materials;
+  std::vector<Light<FLOAT, N>> lights;
+  Vector<FLOAT, 3u> background = { 0.0, 0.0, 0.0 };
+  size_t max_depth = 5u;
+
+  // the tiles of one thread
+  struct TileQueue {
+    std::mutex mutex;
+    std::deque<size_t> tiles;
+  };
+
+  // returns true if the ray hits a surface, context is set to the closest intersection with a normalized normal
+  // facing the ray origin and material to the material of the surface
+  bool closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context, const Material<FLOAT> * & material) const;
+
+  // returns true if a surface is between the origin of the ray and distance
+  bool occluded(const Ray<FLOAT, N> & ray, FLOAT distance) const;
+
+  // returns the color seen along the normalized ray, inside is true if the ray runs inside a transparent object,
+  // rays counts the traced rays including shadow rays
+  Vector<FLOAT, 3u> trace(const Ray<FLOAT, N> & ray, size_t depth, bool inside, size_t & rays) const;
+
+  // renders the tile with the given index, returns the number of traced rays
+  size_t render_tile(const Camera<FLOAT, N> & camera, Image<FLOAT> & image, size_t tile) const;
+public:
+  void add_sphere(const Sphere<FLOAT, N> & sphere, const Material<FLOAT> & material);
+
+  // adds the triangles with one material, they are intersected through a BoundingVolumeHierarchy
+  void add_mesh(std::span<const Triangle<FLOAT, N>> triangles, const Material<FLOAT> & material);
+
+  void add_light(const Light<FLOAT, N> & light);
+  void set_background(Vector<FLOAT, 3u> color);
+
+  // sets the number of reflections and refractions followed from a camera ray
+  void set_max_depth(size_t depth);
+
+  // renders all pixels of the image with one ray through the center of each pixel,
+  // returns the number of traced rays (camera, secondary and shadow rays)
+  size_t render(const Camera<FLOAT, N> & camera, Image<FLOAT> & image, size_t threads = std::thread::hardware_concurrency()) const;
+};
+
+typedef Image<float> Imagef;
+typedef Camera<float, 3u> Camera3df;
+typedef RayTracer<float, 3u> RayTracer3df;
+
+#endif
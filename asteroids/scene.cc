@@ -0,0 +1,4 @@
+#include "scene.h"
+#include "scene.tcc"
+
+template class Scene<float, 3u>;
@@ -2,25 +2,51 @@
 #include <span>
 #include <utility>
 
+namespace {
 
-void SDL2Renderer::renderSpaceship(Vector2df position, float angle) {
-    static std::array<SDL_Point, 12> ship_points{SDL_Point{-6, 3},
-                                              SDL_Point{-6,-3},
-                                              SDL_Point{-10,-6},
-                                              SDL_Point{ 14, 0},
-                                              SDL_Point{-10, 6},
-                                              SDL_Point{-6, 3}};
-  
-  std::array<SDL_Point, ship_points.size()> points;
+// returns a copy of outline with every point multiplied by factor
+// used to build the size dependent outlines at compile time
+template <size_t SIZE>
+constexpr std::array<Vector2df, SIZE> scaled(const std::array<Vector2df, SIZE> & outline, float factor) {
+  std::array<Vector2df, SIZE> scaled_outline = outline;
+  for (Vector2df & point : scaled_outline) {
+    point *= factor;
+  }
+  return scaled_outline;
+}
+
+// outlines of an asteroid for the sizes 1 (small), 2 (medium), and 3 (big)
+template <size_t SIZE>
+constexpr std::array<std::array<Vector2df, SIZE>, 3> asteroid_sizes(const std::array<Vector2df, SIZE> & outline) {
+  return { scaled(outline, 0.25f), scaled(outline, 0.5f), scaled(outline, 1.0f) };
+}
 
-  float cos_angle = std::cos(angle);
-  float sin_angle = std::sin(angle);
-  for (size_t i = 0; i < ship_points.size(); i++) {
-    float x = ship_points[i].x;
-    float y = ship_points[i].y;
-    points[i].x = (cos_angle * x - sin_angle * y) + position[0];
-    points[i].y = (sin_angle * x + cos_angle * y) + position[1];
+// applies the affine transformation to all points of outline in one batch
+// and returns the resulting screen points
+template <size_t SIZE>
+std::array<SDL_Point, SIZE> to_screen(const Matrix3df & transformation, const std::array<Vector2df, SIZE> & outline) {
+  std::array<Vector2df, SIZE> transformed = outline;
+  transformation.transform_points(outline, transformed);
+  std::array<SDL_Point, SIZE> points;
+  for (size_t i = 0; i < SIZE; i++) {
+    points[i].x = transformed[i][0];
+    points[i].y = transformed[i][1];
   }
+  return points;
+}
+
+}
+
+
+void SDL2Renderer::renderSpaceship(Vector2df position, Vector2df direction) {
+    static constexpr std::array<Vector2df, 12> ship_points{Vector2df{-6, 3},
+                                                           Vector2df{-6,-3},
+                                                           Vector2df{-10,-6},
+                                                           Vector2df{ 14, 0},
+                                                           Vector2df{-10, 6},
+                                                           Vector2df{-6, 3}};
+  
+  std::array<SDL_Point, ship_points.size()> points = to_screen( affine_2d(direction, 1.0f, position), ship_points );
   SDL_SetRenderDrawColor( renderer, 0x00, 0xBF, 0xFF, 0xFF);
   SDL_RenderDrawLines(renderer, points.data(), points.size());
   SDL_SetRenderDrawColor( renderer, 0xFF, 0xFF, 0xFF, 0xFF);
@@ -28,41 +54,33 @@ void SDL2Renderer::renderSpaceship(Vector2df position, float angle) {
 }
 
 void SDL2Renderer::render(Spaceship * ship) {
-  static SDL_Point flame_points[] { {-6, 3}, {-12, 0}, {-6, -3} };
-  std::array<SDL_Point, std::span{flame_points}.size()> points;
+  static constexpr std::array<Vector2df, 3> flame_points{ Vector2df{-6, 3}, Vector2df{-12, 0}, Vector2df{-6, -3} };
 
   if (! ship->is_in_hyperspace()) {
     if (ship->is_accelerating()) {
-      float cos_angle = std::cos(ship->get_angle());
-      float sin_angle = std::sin(ship->get_angle());
-      for (size_t i = 0; i < points.size(); i++) {
-        float x = flame_points[i].x;
-        float y = flame_points[i].y;
-        points[i].x = (cos_angle * x - sin_angle * y) + ship->get_position()[0];
-        points[i].y = (sin_angle * x + cos_angle * y) + ship->get_position()[1];
-      }
+      std::array<SDL_Point, flame_points.size()> points = to_screen( affine_2d(to_float(ship->get_direction()), 1.0f, to_float(ship->get_position())),
+                                                                     flame_points );
       SDL_RenderDrawLines(renderer, points.data(), points.size());
     }
-  renderSpaceship(ship->get_position(), ship->get_angle());  
+  renderSpaceship(to_float(ship->get_position()), to_float(ship->get_direction()));  
   }
 }
 
 void SDL2Renderer::render(Saucer * saucer) {
-  static SDL_Point saucer_points[] = { {-16, -6}, {16, -6}, {40, 6}, {-40, 6}, {-16, 18}, {16, 18},
-                                       {40, 6}, {16, -6}, {8, -18}, {-8, -18}, {-16, -6}, {-40, 6} };
+  static constexpr std::array<Vector2df, 12> saucer_points = {
+    Vector2df{-16, -6}, Vector2df{16, -6}, Vector2df{40, 6}, Vector2df{-40, 6}, Vector2df{-16, 18}, Vector2df{16, 18},
+    Vector2df{40, 6}, Vector2df{16, -6}, Vector2df{8, -18}, Vector2df{-8, -18}, Vector2df{-16, -6}, Vector2df{-40, 6} };
+  // scaled outlines for the small (0) and big (1) saucer
+  static constexpr std::array<std::array<Vector2df, 12>, 2> saucer_outlines = { scaled(saucer_points, 0.25f),
+                                                                                scaled(saucer_points, 0.5f) };
   
-  std::array<SDL_Point, std::span{saucer_points}.size()> points;
+  std::array<SDL_Point, saucer_points.size()> points;
 
-  Vector2df position = saucer->get_position();
-  float scale = 0.5;
-  if ( saucer->get_size() == 0 ) {
-    scale = 0.25;
-  }
+  Vector2df position = to_float(saucer->get_position());
+  const auto & outline = saucer_outlines[ saucer->get_size() == 0 ? 0 : 1 ];
   for (size_t i = 0; i < points.size(); i++) {
-    float x = saucer_points[i].x;
-    float y = saucer_points[i].y;
-    points[i].x = scale * x + position[0];
-    points[i].y = scale * y + position[1];
+    points[i].x = outline[i][0] + position[0];
+    points[i].y = outline[i][1] + position[1];
   }
   SDL_SetRenderDrawColor( renderer, 0xFF, 0x0, 0x0, 0x0 );
   SDL_RenderDrawLines(renderer, points.data(), points.size());
@@ -72,46 +90,46 @@ void SDL2Renderer::render(Saucer * saucer) {
 
 void SDL2Renderer::render(Torpedo * torpedo) {
     SDL_SetRenderDrawColor( renderer, 0xFF, 0xFF, 0x00, 0xFF );
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0], torpedo->get_position()[1]);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0] + 1, torpedo->get_position()[1]);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0], torpedo->get_position()[1] - 1);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0], torpedo->get_position()[1] + 1);
-  SDL_RenderDrawPoint(renderer, torpedo->get_position()[0] - 1, torpedo->get_position()[1]);
+  Vector2df position = to_float(torpedo->get_position());
+  SDL_RenderDrawPoint(renderer, position[0], position[1]);
+  SDL_RenderDrawPoint(renderer, position[0] + 1, position[1]);
+  SDL_RenderDrawPoint(renderer, position[0], position[1] - 1);
+  SDL_RenderDrawPoint(renderer, position[0], position[1] + 1);
+  SDL_RenderDrawPoint(renderer, position[0] - 1, position[1]);
     SDL_SetRenderDrawColor( renderer, 0xFF, 0xFF, 0xFF, 0xFF );
 }
   
 void SDL2Renderer::render(Asteroid * asteroid) {
-  static SDL_Point asteroids_points1[] = {
-    { 0, -12}, {16, -24}, {32, -12}, {24, 0}, {32, 12}, {8, 24}, {-16, 24}, {-32, 12}, {-32, -12}, {-16, -24}, {0, -12}
-  };   
-  static SDL_Point asteroids_points2[] = {
-    { 16, -6}, {32, -12}, {16, -24}, {0, -16}, {-16, -24}, {-24, -12}, {-16, -0}, {-32, 12}, {-16, 24}, {-8, 16}, {16, 24}, {32, 6}, {16, -6}
-  }; 
-  static SDL_Point asteroids_points3[] = {
-    {-16, 0}, {-32, 6}, {-16, 24}, {0, 6}, {0, 24}, {16, 24}, {32, 6}, {32, 6}, {16, -24}, {-8, -24}, {-32, -6}, {-16, 0}
-  };
-  static SDL_Point asteroids_points4[] = {  
-    {8,0}, {32,-6}, {32, -12}, {8, -24}, {-16, -24}, {-8, -12}, {-32, -12}, {-32, 12}, {-16, 24}, {8, 16}, {16, 24}, {32, 12}, {8, 0}
-  };
-  static size_t sizes[] = {std::span{asteroids_points1}.size(),
-                           std::span{asteroids_points2}.size(),
-                           std::span{asteroids_points3}.size(),
-                           std::span{asteroids_points4}.size() };
-  size_t size = sizes[ asteroid->get_rock_type() ];
-  SDL_Point * asteroids_points = asteroids_points1;
-  if ( asteroid->get_rock_type() == 1 ) asteroids_points = asteroids_points2;
-  if ( asteroid->get_rock_type() == 2 ) asteroids_points = asteroids_points3;
-  if ( asteroid->get_rock_type() == 3 ) asteroids_points = asteroids_points4;
- 
-  SDL_Point points[std::span{asteroids_points4}.size()];
+  static constexpr auto asteroids_points1 = asteroid_sizes( std::array<Vector2df, 11>{
+    Vector2df{ 0, -12}, Vector2df{16, -24}, Vector2df{32, -12}, Vector2df{24, 0}, Vector2df{32, 12}, Vector2df{8, 24},
+    Vector2df{-16, 24}, Vector2df{-32, 12}, Vector2df{-32, -12}, Vector2df{-16, -24}, Vector2df{0, -12} } );
+  static constexpr auto asteroids_points2 = asteroid_sizes( std::array<Vector2df, 13>{
+    Vector2df{ 16, -6}, Vector2df{32, -12}, Vector2df{16, -24}, Vector2df{0, -16}, Vector2df{-16, -24}, Vector2df{-24, -12},
+    Vector2df{-16, -0}, Vector2df{-32, 12}, Vector2df{-16, 24}, Vector2df{-8, 16}, Vector2df{16, 24}, Vector2df{32, 6},
+    Vector2df{16, -6} } );
+  static constexpr auto asteroids_points3 = asteroid_sizes( std::array<Vector2df, 12>{
+    Vector2df{-16, 0}, Vector2df{-32, 6}, Vector2df{-16, 24}, Vector2df{0, 6}, Vector2df{0, 24}, Vector2df{16, 24},
+    Vector2df{32, 6}, Vector2df{32, 6}, Vector2df{16, -24}, Vector2df{-8, -24}, Vector2df{-32, -6}, Vector2df{-16, 0} } );
+  static constexpr auto asteroids_points4 = asteroid_sizes( std::array<Vector2df, 13>{
+    Vector2df{8,0}, Vector2df{32,-6}, Vector2df{32, -12}, Vector2df{8, -24}, Vector2df{-16, -24}, Vector2df{-8, -12},
+    Vector2df{-32, -12}, Vector2df{-32, 12}, Vector2df{-16, 24}, Vector2df{8, 16}, Vector2df{16, 24}, Vector2df{32, 12},
+    Vector2df{8, 0} } );
+  // outlines indexed by size - 1 and rock type
+  static constexpr std::span<const Vector2df> outlines[3][4] = {
+    { asteroids_points1[0], asteroids_points2[0], asteroids_points3[0], asteroids_points4[0] },
+    { asteroids_points1[1], asteroids_points2[1], asteroids_points3[1], asteroids_points4[1] },
+    { asteroids_points1[2], asteroids_points2[2], asteroids_points3[2], asteroids_points4[2] } };
+
+  size_t size_index = (asteroid->get_size() == 3 ? 2 : ( asteroid->get_size() == 2 ? 1 : 0 ));
+  std::span<const Vector2df> outline = outlines[ size_index ][ asteroid->get_rock_type() ];
+  SDL_Point points[asteroids_points4[0].size()];
   
-  float scale = (asteroid->get_size() == 3 ? 1.0 : ( asteroid->get_size() == 2 ? 0.5 : 0.25 ));
-  Vector2df position = asteroid->get_position();
-  for (size_t i = 0; i < size; i++) {
-    points[i].x = scale * asteroids_points[i].x + position[0];
-    points[i].y = scale * asteroids_points[i].y + position[1];
+  Vector2df position = to_float(asteroid->get_position());
+  for (size_t i = 0; i < outline.size(); i++) {
+    points[i].x = outline[i][0] + position[0];
+    points[i].y = outline[i][1] + position[1];
   }
-  SDL_RenderDrawLines(renderer, points, size);
+  SDL_RenderDrawLines(renderer, points, outline.size());
 }
 
 
@@ -122,11 +140,11 @@ void SDL2Renderer::render(SpaceshipDebris * debris) {
                                         { SDL_Point{3, -1}, SDL_Point{ -5, -7} },
                                         { SDL_Point{0, -4}, SDL_Point{-6, -6} },
                                         { SDL_Point{-2, 2}, SDL_Point{2, 5} } };
-  static std::array<Vector2df, 6> debris_direction = { Vector2df{-40, -23}, Vector2df{50, 15}, Vector2df{0, 45},
+  static constexpr std::array<Vector2df, 6> debris_direction = { Vector2df{-40, -23}, Vector2df{50, 15}, Vector2df{0, 45},
                                                        Vector2df{60, -15}, Vector2df{10, -52}, Vector2df{-40, 30} };
-  Vector2df position = debris->get_position();
+  Vector2df position = to_float(debris->get_position());
   std::array<SDL_Point, 4> points;
-  float scale =  0.2 * (SpaceshipDebris::TIME_TO_DELETE - debris->get_time_to_delete());
+  float scale =  0.2 * (SpaceshipDebris::TIME_TO_DELETE - static_cast<float>(debris->get_time_to_delete()));
   for (size_t i = 0; i < debris_direction.size(); i++) {
     points[0].x = scale * debris_direction[i][0] + ship_points[i][0].x + position[0];
     points[0].y = scale * debris_direction[i][1] + ship_points[i][0].y + position[1];
@@ -143,10 +161,10 @@ void SDL2Renderer::render(Debris * debris) {
   static SDL_Point debris_points[] = { {-32, 32}, {-32, -16}, {-16, 0}, {-16, -32}, {-8, 24}, {8, -24}, {24, 32}, {24, -24}, {24, -32}, {32, -8} };
 
   static SDL_Point point;
-  Vector2df position = debris->get_position();
+  Vector2df position = to_float(debris->get_position());
   for (size_t i = 0; i < std::span{debris_points}.size(); i++) {
-    point.x = (Debris::TIME_TO_DELETE - debris->get_time_to_delete()) * debris_points[i].x + position[0];
-    point.y = (Debris::TIME_TO_DELETE - debris->get_time_to_delete()) * debris_points[i].y + position[1];
+    point.x = (Debris::TIME_TO_DELETE - static_cast<float>(debris->get_time_to_delete())) * debris_points[i].x + position[0];
+    point.y = (Debris::TIME_TO_DELETE - static_cast<float>(debris->get_time_to_delete())) * debris_points[i].y + position[1];
     SDL_RenderDrawPoint(renderer, point.x, point.y);
   }
 }
@@ -157,7 +175,7 @@ void SDL2Renderer::renderFreeShips() {
   Vector2df position = {FREE_SHIP_X, FREE_SHIP_Y};
   
   for (int i = 0; i < game.get_no_of_ships(); i++) {
-    renderSpaceship( position, -PI / 2.0 );
+    renderSpaceship( position, Vector2df{0.0f, -1.0f} );
     position[0] += 20.0;
   }
 }
@@ -169,28 +187,20 @@ void SDL2Renderer::renderScore() {
   constexpr float SCORE_X = 128 - 48;
   constexpr float SCORE_Y = 48 - 4;
   
-  static SDL_Point digit_0[] = { {0,-8}, {4,-8}, {4,0}, {0,0}, {0, -8} };
-  static SDL_Point digit_1[] = { {4,0}, {4,-8} };
-  static SDL_Point digit_2[] = { {0,-8}, {4,-8}, {4,-4}, {0,-4}, {0,0}, {4,0}  };
-  static SDL_Point digit_3[] = { {0,0}, {4, 0}, {4,-4}, {0,-4}, {4,-4}, {4, -8}, {0, -8}  };
-  static SDL_Point digit_4[] = { {4,0}, {4,-8}, {4,-4}, {0,-4}, {0,-8}  };
-  static SDL_Point digit_5[] = { {0,0}, {4,0}, {4,-4}, {0,-4}, {0,-8}, {4, -8}  };
-  static SDL_Point digit_6[] = { {0,-8}, {0,0}, {4,0}, {4,-4}, {0,-4} };
-  static SDL_Point digit_7[] = { {0,-8}, {4,-8}, {4,0} };
-  static SDL_Point digit_8[] = { {0,-8}, {4,-8}, {4,0}, {0,0}, {0,-8}, {0, -4}, {4, -4} };
-  static SDL_Point digit_9[] = { {4, 0}, {4,-8}, {0,-8}, {0, -4}, {4, -4} };
+  // digit strokes, already scaled by 4 at compile time
+  static constexpr auto digit_0 = scaled( std::array{ Vector2df{0,-8}, Vector2df{4,-8}, Vector2df{4,0}, Vector2df{0,0}, Vector2df{0, -8} }, 4.0f );
+  static constexpr auto digit_1 = scaled( std::array{ Vector2df{4,0}, Vector2df{4,-8} }, 4.0f );
+  static constexpr auto digit_2 = scaled( std::array{ Vector2df{0,-8}, Vector2df{4,-8}, Vector2df{4,-4}, Vector2df{0,-4}, Vector2df{0,0}, Vector2df{4,0} }, 4.0f );
+  static constexpr auto digit_3 = scaled( std::array{ Vector2df{0,0}, Vector2df{4, 0}, Vector2df{4,-4}, Vector2df{0,-4}, Vector2df{4,-4}, Vector2df{4, -8}, Vector2df{0, -8} }, 4.0f );
+  static constexpr auto digit_4 = scaled( std::array{ Vector2df{4,0}, Vector2df{4,-8}, Vector2df{4,-4}, Vector2df{0,-4}, Vector2df{0,-8} }, 4.0f );
+  static constexpr auto digit_5 = scaled( std::array{ Vector2df{0,0}, Vector2df{4,0}, Vector2df{4,-4}, Vector2df{0,-4}, Vector2df{0,-8}, Vector2df{4, -8} }, 4.0f );
+  static constexpr auto digit_6 = scaled( std::array{ Vector2df{0,-8}, Vector2df{0,0}, Vector2df{4,0}, Vector2df{4,-4}, Vector2df{0,-4} }, 4.0f );
+  static constexpr auto digit_7 = scaled( std::array{ Vector2df{0,-8}, Vector2df{4,-8}, Vector2df{4,0} }, 4.0f );
+  static constexpr auto digit_8 = scaled( std::array{ Vector2df{0,-8}, Vector2df{4,-8}, Vector2df{4,0}, Vector2df{0,0}, Vector2df{0,-8}, Vector2df{0, -4}, Vector2df{4, -4} }, 4.0f );
+  static constexpr auto digit_9 = scaled( std::array{ Vector2df{4, 0}, Vector2df{4,-8}, Vector2df{0,-8}, Vector2df{0, -4}, Vector2df{4, -4} }, 4.0f );
   
-  static size_t sizes[] = { std::span{digit_0}.size(), 
-                            std::span{digit_1}.size(), 
-                            std::span{digit_2}.size(), 
-                            std::span{digit_3}.size(), 
-                            std::span{digit_4}.size(), 
-                            std::span{digit_5}.size(), 
-                            std::span{digit_6}.size(), 
-                            std::span{digit_7}.size(), 
-                            std::span{digit_8}.size(), 
-                            std::span{digit_9}.size() };
-  static SDL_Point * digits[] = {digit_0, digit_1, digit_2, digit_3, digit_4, digit_5, digit_6, digit_7, digit_8, digit_9 };
+  static constexpr std::span<const Vector2df> digits[] = { digit_0, digit_1, digit_2, digit_3, digit_4,
+                                                           digit_5, digit_6, digit_7, digit_8, digit_9 };
 
   std::array<SDL_Point, 7> points;
   long long score = game.get_score();
@@ -204,10 +214,10 @@ void SDL2Renderer::renderScore() {
   do {
     int d = score % 10;
     score /= 10;
-    size_t size = sizes[d];
+    size_t size = digits[d].size();
     for (size_t i = 0; i < size; i++) {
-      points[i].x = x +  4 * (digits[d] + i)->x;
-      points[i].y = y +  4 * (digits[d] + i)->y;
+      points[i].x = x + digits[d][i][0];
+      points[i].y = y + digits[d][i][1];
     }
     x -= 20;
     //SDL_SetRenderDrawColor( renderer, 0xFF, 0xFF, 0x00, 0xFF );
@@ -242,7 +252,7 @@ void SDL2Renderer::render() {
   SDL_RenderClear( renderer );
   SDL_SetRenderDrawColor( renderer, 0xFF, 0xFF, 0xFF, 0xFF );
   
-  for (Body2df * body : game.get_physics().get_bodies() ) {
+  for (GameBody * body : game.get_physics().get_bodies() ) {
     TypedBody * typed_body = static_cast<TypedBody *>(body);
     auto type = typed_body->get_type();
     if (type == BodyType::spaceship) {
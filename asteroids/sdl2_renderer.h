@@ -19,7 +19,7 @@ class SDL2Renderer : public Renderer {
   SDL_Renderer * renderer = nullptr;
 
   // render methods for the specific game objects, score, and free ships
-  void renderSpaceship(Vector2df position, float angle);
+  void renderSpaceship(Vector2df position, Vector2df direction);
   void render(Spaceship * ship); 
   void render(Torpedo * torpedo);
   void render(Asteroid * asteroid);
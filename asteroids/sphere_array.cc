@@ -0,0 +1,5 @@
+#include "sphere_array.h"
+#include "sphere_array.tcc"
+
+template class SphereArray<float, 2u>;
+template class SphereArray<float, 3u>;
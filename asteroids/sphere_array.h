@@ -0,0 +1,65 @@
+#ifndef SPHERE_ARRAY_H
+#define SPHERE_ARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+#include "math.h"
+#include "vector_array.h"
+#include "geometry.h"
+
+// spheres stored as structure of arrays: the centers in a VectorArray and the radii in one array,
+// so that the overlap kernels test one sphere against WIDTH spheres with one SIMD instruction per operation
+// the overlap test is the one of Sphere::intersects(Sphere): the squared distance of the centers is below
+// the squared sum of the radii, which needs no square root
+// the kernels are the narrow phase of a collision detection, they append the indices of the overlapping spheres
+// to a list, which stays short, since few spheres overlap
+template <class FLOAT, size_t N>
+class SphereArray {
+  static constexpr size_t WIDTH = 8u; // the spheres tested together
+  static constexpr size_t TILE_SIZE = 256u; // the spheres of each array kept in the cache by overlaps(others, pairs)
+
+  VectorArray<FLOAT, N> centers;
+  std::vector<FLOAT> radii;
+
+  // calls output(i) for each sphere i in [begin, end) that overlaps the sphere with center and radius
+  template <class OUTPUT>
+  void overlaps(const Vector<FLOAT, N> & center, FLOAT radius, size_t begin, size_t end, OUTPUT output) const;
+public:
+  // creates an array holding copies of the given spheres
+  explicit SphereArray(std::span<const Sphere<FLOAT, N>> spheres = {});
+
+  // returns the number of spheres stored in this array
+  size_t size() const;
+
+  // appends a copy of sphere
+  void push_back(const Sphere<FLOAT, N> & sphere);
+
+  Sphere<FLOAT, N> get(size_t i) const;
+  void set(size_t i, const Sphere<FLOAT, N> & sphere);
+
+  // appends the indices of the spheres overlapping sphere in ascending order to indices,
+  // returns the number of appended indices
+  size_t overlaps(const Sphere<FLOAT, N> & sphere, std::vector<std::uint32_t> & indices) const;
+
+  // appends the pairs (i, j) of each sphere i of this array that overlaps sphere j of others to pairs,
+  // the arrays are compared in tiles of TILE_SIZE x TILE_SIZE spheres, returns the number of appended pairs
+  size_t overlaps(const SphereArray & others, std::vector<std::pair<std::uint32_t, std::uint32_t>> & pairs) const;
+
+  // appends the pairs (i, j) with i < j of overlapping spheres of this array to pairs, ordered by i and then by j,
+  // like testing each pair once, returns the number of appended pairs
+  size_t overlaps(std::vector<std::pair<std::uint32_t, std::uint32_t>> & pairs) const;
+
+  // returns true iff sphere moving with velocity touches any sphere i of this array moving with velocities.get(i)
+  // within the time [0, dt], index, time and normal are set to the earliest impact (see Sphere::sweep),
+  // the lanes only select the candidates with an impact before dt, which are computed exactly one by one
+  bool sweep(const Sphere<FLOAT, N> & sphere, const Vector<FLOAT, N> & velocity, const VectorArray<FLOAT, N> & velocities, FLOAT dt,
+             size_t & index, FLOAT & time, Vector<FLOAT, N> & normal) const;
+};
+
+typedef SphereArray<float, 2u> SphereArray2df;
+typedef SphereArray<float, 3u> SphereArray3df;
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef SPHERE_ARRAY_TCC
+#define SPHERE_ARRAY_TCC
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include "sphere_array.h"
+#include "ray_packet.tcc"
+
+template <class FLOAT, size_t N>
+SphereArray<FLOAT, N>::SphereArray(std::span<const Sphere<FLOAT, N>> spheres) {
+  for (const Sphere<FLOAT, N> & sphere : spheres) {
+    push_back(sphere);
+  }
+}
+
+template <class FLOAT, size_t N>
+inline size_t SphereArray<FLOAT, N>::size() const {
+  return radii.size();
+}
+
+template <class FLOAT, size_t N>
+void SphereArray<FLOAT, N>::push_back(const Sphere<FLOAT, N> & sphere) {
+  centers.push_back(sphere.get_center());
+  radii.push_back(sphere.get_radius());
+}
+
+template <class FLOAT, size_t N>
+inline Sphere<FLOAT, N> SphereArray<FLOAT, N>::get(size_t i) const {
+  return { centers.get(i), radii[i] };
+}
+
+template <class FLOAT, size_t N>
+inline void SphereArray<FLOAT, N>::set(size_t i, const Sphere<FLOAT, N> & sphere) {
+  centers.set(i, sphere.get_center());
+  radii[i] = sphere.get_radius();
+}
+
+// the comparisons give a bit mask per WIDTH spheres, whose set bits are the overlapping spheres,
+// the spheres after the last full WIDTH are tested one by one
+template <class FLOAT, size_t N>
+template <class OUTPUT>
+inline void SphereArray<FLOAT, N>::overlaps(const Vector<FLOAT, N> & center, FLOAT radius, size_t begin, size_t end, OUTPUT output) const {
+  typedef Lanes<FLOAT, WIDTH> L;
+  std::array<const FLOAT *, N> axes;
+  std::array<L, N> center_lanes;
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis] = centers.axis(axis).data();
+    center_lanes[axis] = L::broadcast(center[axis]);
+  }
+  const L radius_lanes = L::broadcast(radius);
+  size_t i = begin;
+  for (; i + WIDTH <= end; i += WIDTH) {
+    L distance = L::broadcast(0.0);
+    for (size_t axis = 0u; axis < N; axis++) {
+      L difference = L::load(axes[axis] + i) - center_lanes[axis];
+      distance = distance + difference * difference;
+    }
+    L radii_sum = L::load(radii.data() + i) + radius_lanes;
+    for (std::uint32_t bits = (distance < radii_sum * radii_sum).bits(); bits != 0u; bits &= bits - 1u) {
+      output(i + std::countr_zero(bits));
+    }
+  }
+  for (; i < end; i++) {
+    FLOAT distance = 0.0;
+    for (size_t axis = 0u; axis < N; axis++) {
+      FLOAT difference = axes[axis][i] - center[axis];
+      distance += difference * difference;
+    }
+    FLOAT radii_sum = radii[i] + radius;
+    if (distance < radii_sum * radii_sum) {
+      output(i);
+    }
+  }
+}
+
+template <class FLOAT, size_t N>
+size_t SphereArray<FLOAT, N>::overlaps(const Sphere<FLOAT, N> & sphere, std::vector<std::uint32_t> & indices) const {
+  size_t count = indices.size();
+  overlaps(sphere.get_center(), sphere.get_radius(), 0u, size(), [&indices](size_t i) {
+    indices.push_back(static_cast<std::uint32_t>(i));
+  });
+  return indices.size() - count;
+}
+
+// the pairs of one tile of this array are appended before the next tile,
+// so that they are ordered by the tiles of this array, then by i, then by the tiles of others
+template <class FLOAT, size_t N>
+size_t SphereArray<FLOAT, N>::overlaps(const SphereArray & others, std::vector<std::pair<std::uint32_t, std::uint32_t>> & pairs) const {
+  assert(size() <= UINT32_MAX && others.size() <= UINT32_MAX);
+  size_t count = pairs.size();
+  for (size_t tile = 0u; tile < size(); tile += TILE_SIZE) {
+    for (size_t other_tile = 0u; other_tile < others.size(); other_tile += TILE_SIZE) {
+      for (size_t i = tile; i < std::min(tile + TILE_SIZE, size()); i++) {
+        others.overlaps(centers.get(i), radii[i], other_tile, std::min(other_tile + TILE_SIZE, others.size()), [&pairs, i](size_t j) {
+          pairs.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j));
+        });
+      }
+    }
+  }
+  return pairs.size() - count;
+}
+
+// sphere i is tested against the spheres after it, which are one contiguous range
+template <class FLOAT, size_t N>
+size_t SphereArray<FLOAT, N>::overlaps(std::vector<std::pair<std::uint32_t, std::uint32_t>> & pairs) const {
+  assert(size() <= UINT32_MAX);
+  size_t count = pairs.size();
+  for (size_t i = 0u; i < size(); i++) {
+    overlaps(centers.get(i), radii[i], i + 1u, size(), [&pairs, i](size_t j) {
+      pairs.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j));
+    });
+  }
+  return pairs.size() - count;
+}
+
+// the lanes evaluate the tests of Sphere::sweep without the square root, the few candidates get the exact time
+template <class FLOAT, size_t N>
+bool SphereArray<FLOAT, N>::sweep(const Sphere<FLOAT, N> & sphere, const Vector<FLOAT, N> & velocity, const VectorArray<FLOAT, N> & velocities, FLOAT dt,
+                                  size_t & index, FLOAT & time, Vector<FLOAT, N> & normal) const {
+  typedef Lanes<FLOAT, WIDTH> L;
+  assert(velocities.size() == size());
+  bool hit = false;
+  FLOAT candidate_time;
+  Vector<FLOAT, N> candidate_normal{};
+  auto candidate = [&](size_t i) {
+    if (sphere.sweep(get(i), velocity - velocities.get(i), dt, candidate_time, candidate_normal) && (! hit || candidate_time < time)) {
+      index = i;
+      time = candidate_time;
+      normal = candidate_normal;
+      hit = true;
+    }
+  };
+  std::array<const FLOAT *, N> axes, velocity_axes;
+  std::array<L, N> center_lanes, velocity_lanes;
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis] = centers.axis(axis).data();
+    velocity_axes[axis] = velocities.axis(axis).data();
+    center_lanes[axis] = L::broadcast(sphere.get_center()[axis]);
+    velocity_lanes[axis] = L::broadcast(velocity[axis]);
+  }
+  const L radius_lanes = L::broadcast(sphere.get_radius());
+  const L dt_lanes = L::broadcast(dt);
+  const L zero = L::broadcast(0.0);
+  size_t i = 0u;
+  for (; i + WIDTH <= size(); i += WIDTH) {
+    L a = zero, b = zero, c = zero;
+    for (size_t axis = 0u; axis < N; axis++) {
+      L distance = center_lanes[axis] - L::load(axes[axis] + i);
+      L relative_velocity = velocity_lanes[axis] - L::load(velocity_axes[axis] + i);
+      a = a + relative_velocity * relative_velocity;
+      b = b + distance * relative_velocity;
+      c = c + distance * distance;
+    }
+    L radii_sum = L::load(radii.data() + i) + radius_lanes;
+    c = c - radii_sum * radii_sum;
+    L at_dt = c + dt_lanes * (b + b + a * dt_lanes);
+    typename L::Mask candidates = (c < zero)
+      | ((b < zero) & (a * c <= b * b) & ((at_dt <= zero) | (zero - b < a * dt_lanes)));
+    for (std::uint32_t bits = candidates.bits(); bits != 0u; bits &= bits - 1u) {
+      candidate(i + std::countr_zero(bits));
+    }
+  }
+  for (; i < size(); i++) {
+    candidate(i);
+  }
+  return hit;
+}
+
+#endif
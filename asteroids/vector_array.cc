@@ -0,0 +1,7 @@
+#include "vector_array.h"
+#include "vector_array.tcc"
+
+// template instantiations for the 2-, 3- and 4-dimensional float cases
+template class VectorArray<float, 2u>;
+template class VectorArray<float, 3u>;
+template class VectorArray<float, 4u>;
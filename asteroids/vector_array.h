@@ -0,0 +1,73 @@
+#ifndef VECTOR_ARRAY_H
+#define VECTOR_ARRAY_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "math.h"
+
+// an array of Vectors stored as structure of arrays:
+// the values of each axis are stored contiguously, which lets the compiler
+// vectorize the batched kernels below over many Vectors at once
+// (build with -O3 -fno-math-errno to vectorize the square roots, too)
+template<class FLOAT_TYPE, size_t N>
+class VectorArray {
+  static_assert(N > 0u); // no zero length vectors allowed
+
+  // index 0, 1, 2, ... corresponds to x,y,z,... axis
+  std::array<std::vector<FLOAT_TYPE>, N> axes;
+public:
+  // creates an array of size null vectors
+  explicit VectorArray(size_t size = 0u);
+
+  // creates an array holding copies of the given vectors
+  VectorArray(std::span<const Vector<FLOAT_TYPE, N>> vectors);
+
+  // returns the number of Vectors stored in this array
+  size_t size() const;
+
+  // changes the number of Vectors, new Vectors are null vectors
+  void resize(size_t size);
+
+  // appends a copy of vector
+  void push_back(const Vector<FLOAT_TYPE, N> vector);
+
+  // gathers the i-th Vector from the axis arrays
+  Vector<FLOAT_TYPE, N> get(size_t i) const;
+
+  // scatters vector into the axis arrays at index i
+  void set(size_t i, const Vector<FLOAT_TYPE, N> vector);
+
+  // returns the contiguous values of the given axis
+  std::span<FLOAT_TYPE> axis(size_t axis);
+  std::span<const FLOAT_TYPE> axis(size_t axis) const;
+
+  // adds t * vectors to this array element by element (e.g. position += t * velocity)
+  // vectors must have the same size as this array
+  void axpy(FLOAT_TYPE t, const VectorArray & vectors);
+
+  // stores the scalar product of the i-th Vectors of this array and vectors in products[i]
+  void dot(const VectorArray & vectors, std::span<FLOAT_TYPE> products) const;
+
+  // stores the scalar product of the i-th Vector of this array and vector in products[i]
+  void dot(const Vector<FLOAT_TYPE, N> vector, std::span<FLOAT_TYPE> products) const;
+
+  // stores the (euclidian) length of the i-th Vector in lengths[i]
+  void lengths(std::span<FLOAT_TYPE> lengths) const;
+
+  // normalizes all Vectors of this array to the length 1
+  void normalize();
+
+  // returns the component wise minimum of all Vectors, +infinity for an empty array
+  Vector<FLOAT_TYPE, N> minimum() const;
+
+  // returns the component wise maximum of all Vectors, -infinity for an empty array
+  Vector<FLOAT_TYPE, N> maximum() const;
+};
+
+typedef VectorArray<float, 2u> VectorArray2df;
+typedef VectorArray<float, 3u> VectorArray3df;
+typedef VectorArray<float, 4u> VectorArray4df;
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "math.h"
+#include "geometry.h"
+
+// a bounding volume hierarchy (BVH) over triangles or spheres: a tree of axis aligned boxes, so that a ray
+// is tested only against the primitives in the few boxes it passes instead of against all of them
+// the tree is built top down with the binned surface area heuristic (SAH): the primitives of a node
+// are sorted into BINS buckets along each axis by the centers of their boxes, and the node is split
+// at the bucket boundary with the lowest expected cost of a ray, which is proportional to the
+// surface area times the number of primitives of each child
+// the nodes are stored depth first in one array, the first child of an inner node directly follows it
+// below MAX_SAH_DEPTH the nodes are split at the median instead, so that degenerate inputs, e.g. exponentially
+// spaced primitives, of which the SAH splits off only a few per level, cannot overflow the traversal stack
+// when the primitives move, refit updates the boxes bottom up instead of building the tree again,
+// and rebuilds only the subtrees whose SAH cost grew by more than REBUILD_FACTOR since they were built
+// triangles are stored only as PrecomputedTriangle, which takes 4 instead of the 6 Vectors of a Triangle,
+// so that the hierarchy holds one copy of each primitive
+template <class FLOAT, size_t N, class PRIMITIVE = Triangle<FLOAT, N>>
+class BoundingVolumeHierarchy {
+  static_assert(N == 3u); // the surface area and the triangle intersections need three dimensions
+public:
+  struct Node {
+    Vector<FLOAT, N> minimum, maximum; // the corners of the bounding box
+    std::uint32_t index; // the second child of an inner node, the first primitive of a leaf
+    std::uint32_t count; // the number of primitives of a leaf, zero for inner nodes
+  };
+
+  // the type of the stored primitives, which the rays are intersected with
+  typedef std::conditional_t<std::is_same_v<PRIMITIVE, Triangle<FLOAT, N>>, PrecomputedTriangle<FLOAT, N>, PRIMITIVE> StoredPrimitive;
+
+private:
+  static constexpr size_t BINS = 16u;
+  static constexpr size_t MAX_LEAF_SIZE = 8u;
+  static constexpr FLOAT TRAVERSAL_COST = 1.0; // relative to the cost of one ray-primitive test
+  static constexpr FLOAT REBUILD_FACTOR = 1.5;
+  static constexpr size_t MAX_SAH_DEPTH = 64u;
+  static constexpr size_t STACK_SIZE = MAX_SAH_DEPTH + 32u; // the median splits of at most 2^32 primitives add 32 levels
+
+  // returns a Vector with all components set to value
+  static Vector<FLOAT, N> filled(FLOAT value);
+
+  // a bounding box, which is empty until it grows
+  struct Bounds {
+    Vector<FLOAT, N> minimum = filled(INFINITY),
+                     maximum = filled(-INFINITY);
+
+    void grow(const Vector<FLOAT, N> point);
+    void grow(const Bounds & bounds);
+
+    // returns the half of the surface area
+    FLOAT half_area() const;
+  };
+
+  static Bounds bounds(const Triangle<FLOAT, N> & triangle);
+  static Bounds bounds(const Sphere<FLOAT, N> & sphere);
+
+  std::vector<Node> nodes;
+  std::vector<StoredPrimitive> primitives; // in the order of the leaves
+  std::vector<std::uint32_t> ids; // the index of each primitive in the span given to the constructor
+  std::vector<FLOAT> costs,       // the SAH cost of each subtree divided by the half area of its box
+                     build_costs; // the same when the subtree was built
+
+  // computes the boxes and centers of the primitives, which are given in the order of the constructor
+  static void measure(std::span<const PRIMITIVE> primitives, std::vector<Bounds> & boxes, std::vector<Vector<FLOAT, N>> & centers);
+
+  // appends the subtree of the primitives ids[begin], ..., ids[end - 1] to output and reorders them,
+  // so that the primitives of each leaf are contiguous, the second children are indices into output,
+  // depth is the number of nodes above the root of the subtree
+  void build(std::vector<Node> & output, size_t begin, size_t end, size_t depth,
+             const std::vector<Bounds> & boxes, const std::vector<Vector<FLOAT, N>> & centers);
+
+  // copies the primitives in the order of the leaves, precomputes the triangles
+  void store(std::span<const PRIMITIVE> primitives);
+
+  // sets the boxes of all nodes bottom up from the boxes of the primitives and updates costs
+  void update(const std::vector<Bounds> & boxes);
+
+  // builds the subtrees of the sorted nodes, given with their depths, again and replaces them,
+  // the following nodes move if their numbers of nodes change
+  void rebuild(const std::vector<std::pair<size_t, size_t>> & degraded, const std::vector<Bounds> & boxes, const std::vector<Vector<FLOAT, N>> & centers);
+
+  // returns the distance at which the ray enters the box of node,
+  // or INFINITY if it misses the box or enters it behind closest
+  static FLOAT entry(const Node & node, const PrecomputedRay<FLOAT, N> & ray, FLOAT closest);
+public:
+  // builds the hierarchy over a copy of primitives
+  explicit BoundingVolumeHierarchy(std::span<const PRIMITIVE> primitives);
+
+  // updates the hierarchy to the moved primitives, which are given in the same order and number as to the constructor
+  // the boxes are refitted in O(n), subtrees whose cost degraded too much are built again,
+  // returns the number of rebuilt subtrees
+  size_t refit(std::span<const PRIMITIVE> primitives);
+
+  // returns the SAH cost of the tree: the expected number of ray-primitive tests and traversal steps
+  // of a ray through the root box, which grows when refitted boxes overlap more and more
+  FLOAT get_cost() const;
+
+  // returns true if the ray intersects any primitive,
+  // context is set to the intersection with the smallest t (see PrecomputedTriangle::intersects and Sphere::intersects)
+  bool closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // the same, id is set to the index of the intersected primitive in the span given to the constructor
+  bool closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context, std::uint32_t & id) const;
+
+  // returns true if the ray intersects any primitive before tmax (see Sphere::occluded and PrecomputedTriangle::occluded),
+  // the traversal stops at the first one found and skips the intersection data, e.g. for shadow rays
+  bool occluded(const Ray<FLOAT, N> & ray, FLOAT tmax) const;
+
+  // the same, id is set to the index of the found primitive in the span given to the constructor
+  bool occluded(const Ray<FLOAT, N> & ray, FLOAT tmax, std::uint32_t & id) const;
+
+  // returns the nodes in depth first order, the root comes first
+  std::span<const Node> get_nodes() const;
+
+  // returns the primitives in the order of the leaves, triangles as PrecomputedTriangle
+  std::span<const StoredPrimitive> get_primitives() const;
+
+  // returns for each primitive in the order of the leaves its index in the span given to the constructor
+  std::span<const std::uint32_t> get_primitive_ids() const;
+};
+
+typedef BoundingVolumeHierarchy<float, 3u> BVH3df;
+typedef BoundingVolumeHierarchy<float, 3u, Sphere<float, 3u>> SphereBVH3df;
+
+#endif
@@ -0,0 +1,446 @@
+#ifndef BVH_TCC
+#define BVH_TCC
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+#include "bvh.h"
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+inline Vector<FLOAT, N> BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::filled(FLOAT value) {
+  Vector<FLOAT, N> vector = {};
+  for (size_t axis = 0u; axis < N; axis++) {
+    vector[axis] = value;
+  }
+  return vector;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+inline void BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::Bounds::grow(const Vector<FLOAT, N> point) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    minimum[axis] = std::min(minimum[axis], point[axis]);
+    maximum[axis] = std::max(maximum[axis], point[axis]);
+  }
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+inline void BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::Bounds::grow(const Bounds & bounds) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    minimum[axis] = std::min(minimum[axis], bounds.minimum[axis]);
+    maximum[axis] = std::max(maximum[axis], bounds.maximum[axis]);
+  }
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+inline FLOAT BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::Bounds::half_area() const {
+  Vector<FLOAT, N> extent = maximum - minimum;
+  return extent[0] * extent[1] + extent[1] * extent[2] + extent[2] * extent[0];
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+inline typename BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::Bounds BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::bounds(const Triangle<FLOAT, N> & triangle) {
+  Bounds bounds;
+  for (size_t vertex = 0u; vertex < 3u; vertex++) {
+    bounds.grow(triangle.get_vertex(vertex));
+  }
+  return bounds;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+inline typename BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::Bounds BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::bounds(const Sphere<FLOAT, N> & sphere) {
+  Vector<FLOAT, N> radius = filled(sphere.get_radius());
+  return { sphere.get_center() - radius, sphere.get_center() + radius };
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+void BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::measure(std::span<const PRIMITIVE> primitives, std::vector<Bounds> & boxes,
+                                                           std::vector<Vector<FLOAT, N>> & centers) {
+  boxes.resize(primitives.size());
+  centers.resize(primitives.size(), Vector<FLOAT, N>{});
+  for (size_t i = 0u; i < primitives.size(); i++) {
+    boxes[i] = bounds(primitives[i]);
+    centers[i] = static_cast<FLOAT>(0.5) * (boxes[i].minimum + boxes[i].maximum);
+  }
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::BoundingVolumeHierarchy(std::span<const PRIMITIVE> primitives) {
+  assert(primitives.size() <= UINT32_MAX);
+  std::vector<Bounds> boxes;
+  std::vector<Vector<FLOAT, N>> centers;
+  measure(primitives, boxes, centers);
+  ids.resize(primitives.size());
+  for (size_t i = 0u; i < primitives.size(); i++) {
+    ids[i] = static_cast<std::uint32_t>(i);
+  }
+  if (!primitives.empty()) {
+    nodes.reserve(2u * primitives.size() / MAX_LEAF_SIZE + 1u);
+    build(nodes, 0u, primitives.size(), 0u, boxes, centers);
+  }
+  store(primitives);
+  update(boxes);
+  build_costs = costs;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+void BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::store(std::span<const PRIMITIVE> primitives) {
+  this->primitives.clear();
+  this->primitives.reserve(primitives.size());
+  for (std::uint32_t i : ids) {
+    this->primitives.emplace_back(primitives[i]);
+  }
+}
+
+// the children follow their parent, so that going backwards through the nodes visits them before it
+// the cost of a leaf is the number of its primitives, the cost of an inner node is the traversal plus the costs
+// of its children weighted by the probability that a ray through the node also passes the child
+template <class FLOAT, size_t N, class PRIMITIVE>
+void BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::update(const std::vector<Bounds> & boxes) {
+  costs.resize(nodes.size());
+  for (size_t node = nodes.size(); node-- > 0u; ) {
+    Node & current = nodes[node];
+    Bounds bounds;
+    if (current.count == 0u) {
+      Bounds first{ nodes[node + 1u].minimum, nodes[node + 1u].maximum };
+      Bounds second{ nodes[current.index].minimum, nodes[current.index].maximum };
+      bounds.grow(first);
+      bounds.grow(second);
+      FLOAT area = bounds.half_area();
+      costs[node] = TRAVERSAL_COST + (area > 0.0 ? (first.half_area() * costs[node + 1u] + second.half_area() * costs[current.index]) / area
+                                                 : costs[node + 1u] + costs[current.index]);
+    } else {
+      for (size_t i = current.index; i < current.index + current.count; i++) {
+        bounds.grow(boxes[ids[i]]);
+      }
+      costs[node] = static_cast<FLOAT>(current.count);
+    }
+    current.minimum = bounds.minimum;
+    current.maximum = bounds.maximum;
+  }
+}
+
+// the subtree of a node ends with its last leaf, which is reached through the second children,
+// its primitives are the range from the one of its first leaf to the end of the last one
+// the nodes between the subtrees are copied, and their second children are moved to the new indices afterwards,
+// which is one pass over the nodes, however many subtrees are rebuilt
+template <class FLOAT, size_t N, class PRIMITIVE>
+void BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::rebuild(const std::vector<std::pair<size_t, size_t>> & degraded, const std::vector<Bounds> & boxes,
+                                                           const std::vector<Vector<FLOAT, N>> & centers) {
+  std::vector<Node> output;
+  output.reserve(nodes.size());
+  std::vector<FLOAT> output_costs;
+  output_costs.reserve(nodes.size());
+  std::vector<std::uint32_t> moved(nodes.size()); // the new index of each copied node and of each rebuilt subtree
+  std::vector<size_t> copied_inner_nodes;
+  auto copy = [&](size_t begin, size_t end) {
+    for (size_t node = begin; node < end; node++) {
+      moved[node] = static_cast<std::uint32_t>(output.size());
+      if (nodes[node].count == 0u) {
+        copied_inner_nodes.push_back(output.size());
+      }
+      output.push_back(nodes[node]);
+      output_costs.push_back(build_costs[node]);
+    }
+  };
+  size_t next = 0u;
+  for (auto [node, depth] : degraded) {
+    copy(next, node);
+    size_t first = node;
+    while (nodes[first].count == 0u) {
+      first++;
+    }
+    size_t last = node;
+    while (nodes[last].count == 0u) {
+      last = nodes[last].index;
+    }
+    moved[node] = static_cast<std::uint32_t>(output.size());
+    build(output, nodes[first].index, nodes[last].index + nodes[last].count, depth, boxes, centers);
+    output_costs.resize(output.size(), NAN); // set after the next update
+    next = last + 1u;
+  }
+  copy(next, nodes.size());
+  for (size_t node : copied_inner_nodes) {
+    output[node].index = moved[output[node].index];
+  }
+  nodes.swap(output);
+  build_costs.swap(output_costs);
+}
+
+// the degraded subtrees are searched top down, so that a subtree is rebuilt as a whole and not in parts
+template <class FLOAT, size_t N, class PRIMITIVE>
+size_t BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::refit(std::span<const PRIMITIVE> primitives) {
+  assert(primitives.size() == ids.size());
+  std::vector<Bounds> boxes;
+  std::vector<Vector<FLOAT, N>> centers;
+  measure(primitives, boxes, centers);
+  update(boxes);
+
+  std::vector<std::pair<size_t, size_t>> degraded, stack; // the nodes and their depths
+  if (!nodes.empty()) {
+    stack.push_back({ 0u, 0u });
+  }
+  while (!stack.empty()) {
+    auto [node, depth] = stack.back();
+    stack.pop_back();
+    if (nodes[node].count > 0u) {
+      continue;
+    }
+    if (costs[node] > REBUILD_FACTOR * build_costs[node]) {
+      degraded.push_back({ node, depth });
+    } else {
+      stack.push_back({ nodes[node].index, depth + 1u });
+      stack.push_back({ node + 1u, depth + 1u });
+    }
+  }
+  std::sort(degraded.begin(), degraded.end());
+  if (!degraded.empty()) {
+    rebuild(degraded, boxes, centers);
+  }
+  store(primitives);
+  if (!degraded.empty()) {
+    update(boxes);
+    for (size_t node = 0u; node < nodes.size(); node++) {
+      build_costs[node] = std::isnan(build_costs[node]) ? costs[node] : build_costs[node];
+    }
+  }
+  return degraded.size();
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+FLOAT BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::get_cost() const {
+  return costs.empty() ? static_cast<FLOAT>(0.0) : costs[0];
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+void BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::build(std::vector<Node> & output, size_t begin, size_t end, size_t depth,
+                                                         const std::vector<Bounds> & boxes, const std::vector<Vector<FLOAT, N>> & centers) {
+  Bounds bounds, center_bounds;
+  for (size_t i = begin; i < end; i++) {
+    bounds.grow(boxes[ids[i]]);
+    center_bounds.grow(centers[ids[i]]);
+  }
+  const size_t node = output.size();
+  const size_t count = end - begin;
+  output.push_back(Node{ bounds.minimum, bounds.maximum, static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(count) });
+  if (count == 1u) {
+    return;
+  }
+
+  // the cost of a split is the sum of surface area times number of primitives of both children
+  // the bucket of a center is computed the same way for binning and partitioning
+  FLOAT best_cost = INFINITY;
+  size_t best_axis = 0u;
+  size_t best_split = 0u;
+  auto bin = [&center_bounds](const Vector<FLOAT, N> & center, size_t axis, FLOAT scale) -> size_t {
+    return std::min(BINS - 1u, static_cast<size_t>((center[axis] - center_bounds.minimum[axis]) * scale));
+  };
+  for (size_t axis = 0u; axis < N && depth < MAX_SAH_DEPTH; axis++) {
+    const FLOAT extent = center_bounds.maximum[axis] - center_bounds.minimum[axis];
+    if (!(extent > static_cast<FLOAT>(0.0))) {
+      continue;
+    }
+    const FLOAT scale = static_cast<FLOAT>(BINS) / extent;
+    std::array<Bounds, BINS> bins;
+    std::array<size_t, BINS> counts{};
+    for (size_t i = begin; i < end; i++) {
+      const size_t b = bin(centers[ids[i]], axis, scale);
+      bins[b].grow(boxes[ids[i]]);
+      counts[b]++;
+    }
+    // sweeps from the left and from the right over the bucket boundaries
+    std::array<FLOAT, BINS - 1u> left_costs;
+    std::array<size_t, BINS - 1u> left_counts;
+    Bounds left;
+    size_t left_count = 0u;
+    for (size_t split = 1u; split < BINS; split++) {
+      left.grow(bins[split - 1u]);
+      left_count += counts[split - 1u];
+      left_counts[split - 1u] = left_count;
+      left_costs[split - 1u] = left_count == 0u ? static_cast<FLOAT>(0.0) : left.half_area() * static_cast<FLOAT>(left_count);
+    }
+    Bounds right;
+    size_t right_count = 0u;
+    for (size_t split = BINS - 1u; split > 0u; split--) {
+      right.grow(bins[split]);
+      right_count += counts[split];
+      if (right_count == 0u || left_counts[split - 1u] == 0u) {
+        continue;
+      }
+      const FLOAT cost = left_costs[split - 1u] + right.half_area() * static_cast<FLOAT>(right_count);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_split = split;
+      }
+    }
+  }
+
+  // a leaf costs count ray-primitive tests, an inner node the traversal plus the expected tests of its children
+  size_t middle;
+  if (best_cost < INFINITY) {
+    if (count <= MAX_LEAF_SIZE && best_cost >= (static_cast<FLOAT>(count) - TRAVERSAL_COST) * bounds.half_area()) {
+      return;
+    }
+    const FLOAT scale = static_cast<FLOAT>(BINS) / (center_bounds.maximum[best_axis] - center_bounds.minimum[best_axis]);
+    middle = std::partition(ids.begin() + begin, ids.begin() + end, [&](std::uint32_t i) {
+      return bin(centers[i], best_axis, scale) < best_split;
+    }) - ids.begin();
+  } else {
+    // all centers are the same, so that no split separates them, or the tree is deeper than MAX_SAH_DEPTH:
+    // the median along the longest axis halves the primitives, so that the depth stays below STACK_SIZE
+    if (count <= MAX_LEAF_SIZE) {
+      return;
+    }
+    size_t longest = 0u;
+    for (size_t axis = 1u; axis < N; axis++) {
+      if (center_bounds.maximum[axis] - center_bounds.minimum[axis] > center_bounds.maximum[longest] - center_bounds.minimum[longest]) {
+        longest = axis;
+      }
+    }
+    middle = begin + count / 2u;
+    std::nth_element(ids.begin() + begin, ids.begin() + middle, ids.begin() + end, [&](std::uint32_t i, std::uint32_t j) {
+      return centers[i][longest] < centers[j][longest];
+    });
+  }
+  output[node].count = 0u;
+  build(output, begin, middle, depth + 1u, boxes, centers);
+  output[node].index = static_cast<std::uint32_t>(output.size());
+  build(output, middle, end, depth + 1u, boxes, centers);
+}
+
+// the slab test: intersects the ray with the planes of the box per axis
+template <class FLOAT, size_t N, class PRIMITIVE>
+inline FLOAT BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::entry(const Node & node, const PrecomputedRay<FLOAT, N> & ray, FLOAT closest) {
+  FLOAT tmin = 0.0;
+  FLOAT tmax = closest;
+  return ray.slabs(node.minimum, node.maximum, tmin, tmax) ? tmin : INFINITY;
+}
+
+// visits the nearer child first and postpones the other one on a stack together with its entry distance,
+// postponed nodes behind the closest intersection found so far are skipped
+template <class FLOAT, size_t N, class PRIMITIVE>
+bool BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context) const {
+  std::uint32_t id;
+  return closest_hit(ray, context, id);
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+bool BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context,
+                                                               std::uint32_t & id) const {
+  PrecomputedRay<FLOAT, N> precomputed{ray};
+  if (nodes.empty() || entry(nodes[0], precomputed, INFINITY) == INFINITY) {
+    return false;
+  }
+  FLOAT closest = INFINITY;
+  bool hit = false;
+  std::array<std::pair<std::uint32_t, FLOAT>, STACK_SIZE> stack;
+  size_t size = 0u;
+  std::uint32_t node = 0u;
+  while (true) {
+    const Node & current = nodes[node];
+    if (current.count == 0u) {
+      std::uint32_t first = node + 1u;
+      std::uint32_t second = current.index;
+      FLOAT first_entry = entry(nodes[first], precomputed, closest);
+      FLOAT second_entry = entry(nodes[second], precomputed, closest);
+      if (second_entry < first_entry) {
+        std::swap(first, second);
+        std::swap(first_entry, second_entry);
+      }
+      if (first_entry < INFINITY) {
+        if (second_entry < INFINITY) {
+          assert(size < STACK_SIZE);
+          stack[size++] = { second, second_entry };
+        }
+        node = first;
+        continue;
+      }
+    } else {
+      Intersection_Context<FLOAT, N> candidate;
+      for (size_t i = current.index; i < current.index + current.count; i++) {
+        if (primitives[i].intersects(ray, candidate) && candidate.t < closest) {
+          closest = candidate.t;
+          context = candidate;
+          id = ids[i];
+          hit = true;
+        }
+      }
+    }
+    do {
+      if (size == 0u) {
+        return hit;
+      }
+      size--;
+    } while (stack[size].second >= closest);
+    node = stack[size].first;
+  }
+}
+
+// the traversal of closest_hit with the boxes clipped to tmax instead of to the closest hit, any hit ends it,
+// the nearer child is still visited first, since a blocker near the origin is found sooner
+template <class FLOAT, size_t N, class PRIMITIVE>
+bool BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::occluded(const Ray<FLOAT, N> & ray, FLOAT tmax) const {
+  std::uint32_t id;
+  return occluded(ray, tmax, id);
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+bool BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::occluded(const Ray<FLOAT, N> & ray, FLOAT tmax, std::uint32_t & id) const {
+  PrecomputedRay<FLOAT, N> precomputed{ray};
+  if (nodes.empty() || entry(nodes[0], precomputed, tmax) == INFINITY) {
+    return false;
+  }
+  std::array<std::uint32_t, STACK_SIZE> stack;
+  size_t size = 0u;
+  std::uint32_t node = 0u;
+  while (true) {
+    const Node & current = nodes[node];
+    if (current.count == 0u) {
+      std::uint32_t first = node + 1u;
+      std::uint32_t second = current.index;
+      FLOAT first_entry = entry(nodes[first], precomputed, tmax);
+      FLOAT second_entry = entry(nodes[second], precomputed, tmax);
+      if (second_entry < first_entry) {
+        std::swap(first, second);
+        std::swap(first_entry, second_entry);
+      }
+      if (first_entry < INFINITY) {
+        if (second_entry < INFINITY) {
+          assert(size < STACK_SIZE);
+          stack[size++] = second;
+        }
+        node = first;
+        continue;
+      }
+    } else {
+      for (size_t i = current.index; i < current.index + current.count; i++) {
+        if (primitives[i].occluded(ray, tmax)) {
+          id = ids[i];
+          return true;
+        }
+      }
+    }
+    if (size == 0u) {
+      return false;
+    }
+    node = stack[--size];
+  }
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+std::span<const typename BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::Node> BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::get_nodes() const {
+  return nodes;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+std::span<const typename BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::StoredPrimitive> BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::get_primitives() const {
+  return primitives;
+}
+
+template <class FLOAT, size_t N, class PRIMITIVE>
+std::span<const std::uint32_t> BoundingVolumeHierarchy<FLOAT, N, PRIMITIVE>::get_primitive_ids() const {
+  return ids;
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "bvh.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// measures the build time and the closest hit queries of BVH3df on meshes of a bumpy sphere
+// with 10k to 1M triangles, and for the smallest mesh the test of every triangle for comparison
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc geometry.cc bvh.cc bvh_benchmark.cc -o bvh_benchmark
+// with a logarithmic number of visited nodes the time per ray grows only slowly with the mesh size
+
+namespace {
+
+constexpr size_t IMAGE_SIZE = 256u; // rays per axis
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+// returns the point of the unit sphere with bumps at the given angles
+Vector3df bumpy_sphere(float theta, float phi) {
+  float radius = 1.0f + 0.05f * std::sin(8.0f * theta) * std::sin(8.0f * phi);
+  return { radius * std::sin(theta) * std::cos(phi), radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta) };
+}
+
+// returns 2 * rings * segments triangles of the bumpy sphere
+std::vector<Triangle3df> mesh(size_t rings, size_t segments) {
+  std::vector<Triangle3df> triangles;
+  triangles.reserve(2u * rings * segments);
+  for (size_t ring = 0u; ring < rings; ring++) {
+    float theta0 = PI * ring / rings;
+    float theta1 = PI * (ring + 1u) / rings;
+    for (size_t segment = 0u; segment < segments; segment++) {
+      float phi0 = 2.0f * PI * segment / segments;
+      float phi1 = 2.0f * PI * (segment + 1u) / segments;
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0), bumpy_sphere(theta1, phi0), bumpy_sphere(theta1, phi1) } );
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0), bumpy_sphere(theta1, phi1), bumpy_sphere(theta0, phi1) } );
+    }
+  }
+  return triangles;
+}
+
+// returns the rays of a camera at z = 3 looking at the origin, stride selects every stride-th ray
+std::vector<Ray3df> camera_rays(size_t stride) {
+  std::vector<Ray3df> rays;
+  for (size_t y = 0u; y < IMAGE_SIZE; y += stride) {
+    for (size_t x = 0u; x < IMAGE_SIZE; x += stride) {
+      Vector3df target = { 2.5f * x / IMAGE_SIZE - 1.25f, 2.5f * y / IMAGE_SIZE - 1.25f, 0.0f };
+      rays.push_back( Ray3df{ {0.0f, 0.0f, 3.0f}, target - Vector3df{0.0f, 0.0f, 3.0f} } );
+    }
+  }
+  return rays;
+}
+
+// traces all rays with closest_hit and returns the average time per ray in nanoseconds
+template <class CLOSEST_HIT>
+double measure(const std::vector<Ray3df> & rays, CLOSEST_HIT closest_hit, size_t & hits) {
+  Intersection_Context<float, 3u> context;
+  float sum = 0.0f;
+  hits = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (const Ray3df & ray : rays) {
+    if (closest_hit(ray, context)) {
+      hits++;
+      sum += context.t;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = sum;
+  return std::chrono::duration<double, std::nano>(end - start).count() / rays.size();
+}
+
+}
+
+int main() {
+  std::vector<Ray3df> rays = camera_rays(1u);
+  for (size_t rings : { 71u, 224u, 708u }) {
+    std::vector<Triangle3df> triangles = mesh(rings, rings);
+    auto start = std::chrono::steady_clock::now();
+    BVH3df bvh{triangles};
+    auto end = std::chrono::steady_clock::now();
+    size_t hits;
+    double bvh_time = measure(rays, [&bvh](const Ray3df & ray, Intersection_Context<float, 3u> & context) {
+      return bvh.closest_hit(ray, context);
+    }, hits);
+    std::cout << triangles.size() << " triangles: build " << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms (" << bvh.get_nodes().size() << " nodes), closest hit " << bvh_time << " ns/ray ("
+              << hits << " hits of " << rays.size() << " rays)" << std::endl;
+    if (rings == 71u) {
+      std::vector<Ray3df> some_rays = camera_rays(16u);
+      double all_time = measure(some_rays, [&triangles](const Ray3df & ray, Intersection_Context<float, 3u> & context) {
+        return closest_hit<float, 3u>(triangles, ray, context);
+      }, hits);
+      std::vector<PrecomputedTriangle3df> precomputed_triangles(triangles.begin(), triangles.end());
+      double all_precomputed_time = measure(some_rays, [&precomputed_triangles](const Ray3df & ray, Intersection_Context<float, 3u> & context) {
+        return closest_hit<float, 3u>(precomputed_triangles, ray, context);
+      }, hits);
+      std::cout << triangles.size() << " triangles: testing all triangles " << all_time << " ns/ray, all precomputed triangles "
+                << all_precomputed_time << " ns/ray" << std::endl;
+    }
+  }
+  return 0;
+}
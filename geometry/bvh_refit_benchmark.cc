@@ -0,0 +1,116 @@
+#include "bvh.h"
+#include "vector_random.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// compares refitting with building the hierarchy again for every frame of moving primitives:
+// a field of 100k asteroids (spheres) moving with their velocities, and a waving mesh of 200k triangles,
+// for each the time per frame and the closest hit time of rays through the final hierarchies are printed
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc vector_random.cc geometry.cc ray_packet.cc bvh.cc bvh_refit_benchmark.cc -o bvh_refit_benchmark
+// refitting is 5 to 15 times cheaper per frame, on the mesh the rays stay as fast as on a new hierarchy,
+// the asteroids cross many boxes and the rays get slower until the cost of the root exceeds REBUILD_FACTOR
+
+namespace {
+
+constexpr size_t FRAMES = 60u;
+constexpr size_t IMAGE_SIZE = 256u; // rays per axis
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+double milliseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// returns the average closest hit time in nanoseconds of rays from a camera at distance looking at the origin
+template <class HIERARCHY>
+double trace(const HIERARCHY & hierarchy, float distance, float size) {
+  Intersection_Context<float, 3u> context;
+  float sum = 0.0f;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t y = 0u; y < IMAGE_SIZE; y++) {
+    for (size_t x = 0u; x < IMAGE_SIZE; x++) {
+      Vector3df target = { size * x / IMAGE_SIZE - 0.5f * size, size * y / IMAGE_SIZE - 0.5f * size, 0.0f };
+      Ray3df ray{ {0.0f, 0.0f, distance}, target - Vector3df{0.0f, 0.0f, distance} };
+      sum += hierarchy.closest_hit(ray, context) ? context.t : 0.0f;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = sum;
+  return 1.0e6 * milliseconds(start, end) / (IMAGE_SIZE * IMAGE_SIZE);
+}
+
+// moves the primitives for FRAMES frames with move(frame, primitives), refits one hierarchy and builds another one
+// every frame, and prints the times
+template <class PRIMITIVE, class MOVE>
+void compare(const std::string & name, std::vector<PRIMITIVE> primitives, MOVE move, float distance, float size) {
+  BoundingVolumeHierarchy<float, 3u, PRIMITIVE> refitted{primitives};
+  double refit_time = 0.0, build_time = 0.0;
+  size_t rebuilt = 0u;
+  for (size_t frame = 1u; frame <= FRAMES; frame++) {
+    move(frame, primitives);
+    auto start = std::chrono::steady_clock::now();
+    rebuilt += refitted.refit(primitives);
+    auto middle = std::chrono::steady_clock::now();
+    BoundingVolumeHierarchy<float, 3u, PRIMITIVE> built{primitives};
+    auto end = std::chrono::steady_clock::now();
+    refit_time += milliseconds(start, middle);
+    build_time += milliseconds(middle, end);
+    sink = built.get_cost();
+  }
+  BoundingVolumeHierarchy<float, 3u, PRIMITIVE> built{primitives};
+  std::cout << name << ": refit " << refit_time / FRAMES << " ms/frame (" << rebuilt << " subtrees rebuilt in "
+            << FRAMES << " frames), rebuild " << build_time / FRAMES << " ms/frame" << std::endl;
+  std::cout << "  after " << FRAMES << " frames: SAH cost refitted " << refitted.get_cost() << ", rebuilt " << built.get_cost()
+            << ", closest hit refitted " << trace(refitted, distance, size) << " ns/ray, rebuilt " << trace(built, distance, size)
+            << " ns/ray" << std::endl;
+}
+
+Vector3df bumpy_sphere(float theta, float phi, float phase) {
+  float radius = 1.0f + 0.05f * std::sin(8.0f * theta + phase) * std::sin(8.0f * phi);
+  return { radius * std::sin(theta) * std::cos(phi), radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta) };
+}
+
+// returns the triangles of a bumpy sphere whose bumps wander with phase
+std::vector<Triangle3df> mesh(size_t rings, float phase) {
+  std::vector<Triangle3df> triangles;
+  triangles.reserve(2u * rings * rings);
+  for (size_t ring = 0u; ring < rings; ring++) {
+    float theta0 = PI * ring / rings;
+    float theta1 = PI * (ring + 1u) / rings;
+    for (size_t segment = 0u; segment < rings; segment++) {
+      float phi0 = 2.0f * PI * segment / rings;
+      float phi1 = 2.0f * PI * (segment + 1u) / rings;
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0, phase), bumpy_sphere(theta1, phi0, phase), bumpy_sphere(theta1, phi1, phase) } );
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0, phase), bumpy_sphere(theta1, phi1, phase), bumpy_sphere(theta0, phi1, phase) } );
+    }
+  }
+  return triangles;
+}
+
+}
+
+int main() {
+  constexpr size_t ASTEROIDS = 100000u;
+  VectorRandom3df random{3u};
+  std::vector<Vector3df> centers(ASTEROIDS, Vector3df{}), velocities(ASTEROIDS, Vector3df{});
+  random.in_box({-100.0f, -100.0f, -100.0f}, {100.0f, 100.0f, 100.0f}, centers);
+  random.in_box({-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}, velocities); // per frame
+  std::vector<Sphere3df> asteroids;
+  for (const Vector3df & center : centers) {
+    asteroids.push_back( Sphere3df{ center, 0.5f } );
+  }
+  compare("100k asteroids", asteroids, [&](size_t, std::vector<Sphere3df> & spheres) {
+    for (size_t i = 0u; i < spheres.size(); i++) {
+      centers[i] += velocities[i];
+      spheres[i] = Sphere3df{ centers[i], 0.5f };
+    }
+  }, 300.0f, 200.0f);
+
+  constexpr size_t RINGS = 316u;
+  compare("200k triangles waving mesh", mesh(RINGS, 0.0f), [](size_t frame, std::vector<Triangle3df> & triangles) {
+    triangles = mesh(RINGS, 0.1f * frame);
+  }, 3.0f, 2.5f);
+  return 0;
+}
@@ -1,17 +1,38 @@
 #include "geometry.h"
+#include "fixed_point.h"
 #include "geometry.tcc"
 
 template class Intersection_Context<float,3u>;
 
 template class Ray<float, 2u>;
 template class Ray<float, 3u>; 
+template struct PrecomputedRay<float, 2u>;
+template struct PrecomputedRay<float, 3u>;
 
 template class AxisAlignedBoundingBox<float, 2u>;
 template class AxisAlignedBoundingBox<float, 3u>; 
 
 template class Sphere<float, 2u>;
 template class Sphere<float, 3u>; 
+template class Sphere<Q16_16, 2u>;
+template class Sphere<Q32_32, 2u>;
 
 template class Triangle<float, 3u>; 
+template class PrecomputedTriangle<float, 3u>;
+template bool closest_hit<float, 3u>(std::span<const Triangle<float, 3u>> triangles, const Ray<float, 3u> & ray, Intersection_Context<float, 3u> & context);
+template bool closest_hit<float, 3u>(std::span<const PrecomputedTriangle<float, 3u>> triangles, const Ray<float, 3u> & ray, Intersection_Context<float, 3u> & context);
+template bool occluded<float, 2u>(std::span<const Sphere<float, 2u>> spheres, const Ray<float, 2u> & ray, float tmax);
+template bool occluded<float, 3u>(std::span<const Sphere<float, 3u>> spheres, const Ray<float, 3u> & ray, float tmax);
+template bool occluded<float, 3u>(std::span<const Triangle<float, 3u>> triangles, const Ray<float, 3u> & ray, float tmax);
+template bool occluded<float, 3u>(std::span<const PrecomputedTriangle<float, 3u>> triangles, const Ray<float, 3u> & ray, float tmax);
+
+template std::uint32_t AxisAlignedBoundingBox<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+template std::uint32_t AxisAlignedBoundingBox<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
+template std::uint32_t Sphere<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+template std::uint32_t Sphere<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
+template std::uint32_t Triangle<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+template std::uint32_t Triangle<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
+template std::uint32_t PrecomputedTriangle<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+template std::uint32_t PrecomputedTriangle<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
 
 template bool refract<float, 3u>(float refraction_index, Vector<float, 3u> normal, Vector<float, 3u> direction, Vector<float, 3> & transmission);
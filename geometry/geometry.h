@@ -3,7 +3,10 @@
 
 
 #include "math.h"
+#include "ray_packet.h"
+#include <cstdint>
 #include <iostream>
+#include <span>
 #include <vector>
 
 // contains geometric shapes and related stuff, like spheres, triangles, intersection algorithms.
@@ -15,6 +18,35 @@ struct Ray {
                   direction;
 };
 
+// a Ray with the inverse of the direction and its signs computed once, for intersecting it with many boxes
+// a zero component of the direction gives an infinite inverse, so the slab of that axis either
+// contains the origin and does not limit t, or it does not and the ray misses, without a special case
+template <class FLOAT, size_t N>
+struct PrecomputedRay {
+  Vector<FLOAT, N> origin,
+                   direction,
+                   inverse_direction;
+  std::array<bool, N> negative; // the sign of inverse_direction, selects the near and the far side of each slab
+
+  explicit PrecomputedRay(const Ray<FLOAT, N> & ray);
+
+  // intersects the ray with the box from minimum to maximum within the interval [tmin, tmax], e.g. [0, closest hit]
+  // returns false if the ray misses the box in the interval, otherwise [tmin, tmax] is narrowed to the part inside the box
+  // defined here, so that traversal code in other translation units inlines it
+  bool slabs(const Vector<FLOAT, N> & minimum, const Vector<FLOAT, N> & maximum, FLOAT & tmin, FLOAT & tmax) const {
+    for (size_t i = 0; i < N; i++) {
+      FLOAT t0 = (minimum[i] - origin[i]) * inverse_direction[i];
+      FLOAT t1 = (maximum[i] - origin[i]) * inverse_direction[i];
+      FLOAT tnear = negative[i] ? t1 : t0;
+      FLOAT tfar = negative[i] ? t0 : t1;
+      // an origin on the slab with a zero direction gives NaN, which fails both comparisons and keeps the interval
+      tmin = tnear > tmin ? tnear : tmin;
+      tmax = tfar < tmax ? tfar : tmax;
+    }
+    return tmin <= tmax;
+  }
+};
+
 // collection of intersection specific values, like intersection point, normal etc
 template <class FLOAT, size_t N>
 struct Intersection_Context {
@@ -66,6 +98,10 @@ public:
   // checks if this aabb is intersected by the given ray
   bool intersects(Ray<FLOAT,N> ray) const;
 
+  // checks if this aabb is intersected by the given ray within [tmin, tmax] (see PrecomputedRay::slabs),
+  // if so, tmin and tmax are set to the distances at which the ray enters and leaves it
+  bool intersects(const PrecomputedRay<FLOAT, N> & ray, FLOAT & tmin, FLOAT & tmax) const;
+
   // checks if an intersection exists with an aabb moving in the given direction
   bool intersects(AxisAlignedBoundingBox<FLOAT,N> aabb, Vector<FLOAT, N> direction) const;
   
@@ -73,6 +109,11 @@ public:
   // returns the normal (length not normalized) of the face that had been hit, or the null vector 
   // if no intersections occured
   Vector<FLOAT, N> sweep_intersects(AxisAlignedBoundingBox<FLOAT,N> aabb, Vector<FLOAT, N> direction) const;
+
+  // checks all rays of the packet like intersects(ray), returns bit i set if ray i intersects this aabb,
+  // t[i] is set to the distance at which ray i enters the aabb, or zero if it misses
+  template <size_t WIDTH>
+  std::uint32_t intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const;
 };
 
 // a sphere with a center and a radius
@@ -94,12 +135,30 @@ public:
   // t is zero if no intersection occured
   FLOAT intersects(const Ray<FLOAT, N> &ray) const;
 
+  // returns true iff the given ray intersects this sphere with 0 < t < tmax, e.g. the distance to a light,
+  // like intersects(ray) but without a square root and without computing the intersection (any hit)
+  bool occluded(const Ray<FLOAT, N> &ray, FLOAT tmax) const;
+
   // returns true iff this Sphere intersects with the given sphere
   bool intersects(Sphere<FLOAT, N> sphere) const;
+
+  // returns true iff this Sphere moving with relative_velocity (its velocity minus the one of other)
+  // touches other within the time [0, dt], which catches fast spheres passing small ones between two ticks
+  // time is set to the earliest time of impact, normal to the unit contact normal pointing from other to this sphere,
+  // spheres overlapping already get time zero and the normal along their centers (the null vector for equal centers)
+  bool sweep(const Sphere<FLOAT, N> & other, const Vector<FLOAT, N> & relative_velocity, FLOAT dt, FLOAT & time, Vector<FLOAT, N> & normal) const;
+
+  // intersects all rays of the packet like intersects(ray), returns bit i set if ray i intersects this sphere,
+  // t[i] is set to the t of ray i, or zero if it misses
+  template <size_t WIDTH>
+  std::uint32_t intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const;
  
   
   // returns true iff the given point is inside this Sphere or on its surface
   bool inside(const Vector<FLOAT, N> p) const;
+
+  Vector<FLOAT, N> get_center() const;
+  FLOAT get_radius() const;
  
 };
 
@@ -134,11 +193,78 @@ public:
   //   context.t is set to a value with intersection = ray.origin + t * ray.direction
   //   context.normal points away from the surface (clockwise order of a,b, and c)
   bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns true if this Triangle intersects the given ray with 0 <= t < tmax,
+  // with the Moeller-Trumbore algorithm of PrecomputedTriangle and without computing the intersection
+  bool occluded(const Ray<FLOAT, N> &ray, FLOAT tmax) const;
+
+  // intersects all rays of the packet with the Moeller-Trumbore algorithm of PrecomputedTriangle
+  template <size_t WIDTH>
+  std::uint32_t intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const;
+
+  // returns the edge point a (vertex 0), b (vertex 1) or c (vertex 2)
+  Vector<FLOAT, N> get_vertex(size_t vertex) const;
 };
 
+// a Triangle with the values that do not depend on the ray computed once: the point a, the edges
+// and the normal, so that a ray is intersected with the Moeller-Trumbore algorithm, which gets t and
+// the barycentric coordinates from one determinant instead of four cross products and three lengths
+// use it for intersecting many rays with the same triangles, e.g. a mesh
+template <class FLOAT, size_t N>
+class PrecomputedTriangle {
+protected:
+  Vector<FLOAT, N> a,
+                   edge1,   // b - a
+                   edge2,   // c - a
+                   normal;  // (b - a) x (c - a), like the normal of Triangle::intersects
+
+  // returns the cross product with the usual orientation of the y component (see Triangle::intersects)
+  static Vector<FLOAT, N> cross(const Vector<FLOAT, N> & v, const Vector<FLOAT, N> & w);
+public:
+  explicit PrecomputedTriangle(const Triangle<FLOAT, N> & triangle);
+
+  // the same as Triangle::intersects, the results differ only by rounding
+  bool intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & intersection, FLOAT & u, FLOAT & v, FLOAT & t) const;
+  bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns true if this triangle intersects the given ray with 0 <= t < tmax, skips the normal, point and u, v
+  bool occluded(const Ray<FLOAT, N> &ray, FLOAT tmax) const;
+
+  // returns the edge point a (vertex 0), a + edge1 (vertex 1) or a + edge2 (vertex 2),
+  // which differ from the points of the Triangle by rounding
+  Vector<FLOAT, N> get_vertex(size_t vertex) const;
+
+  // intersects all rays of the packet, returns bit i set if ray i intersects this triangle,
+  // t[i] is set to the t of ray i, or zero if it misses
+  template <size_t WIDTH>
+  std::uint32_t intersects(const RayPacket<FLOAT, N, WIDTH> &packet, std::array<FLOAT, WIDTH> & t) const;
+};
+
+// returns true if the ray intersects any of the triangles,
+// context is set to the intersection with the smallest t
+// testing every triangle is only worth it for small meshes, large ones need a BoundingVolumeHierarchy
+template <class FLOAT, size_t N>
+bool closest_hit(std::span<const Triangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context);
+
+template <class FLOAT, size_t N>
+bool closest_hit(std::span<const PrecomputedTriangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context);
+
+// returns true if the ray intersects any of the primitives before tmax, it stops at the first one found (any hit),
+// which is all that shadow rays and line of sight tests need
+template <class FLOAT, size_t N>
+bool occluded(std::span<const Sphere<FLOAT, N>> spheres, const Ray<FLOAT, N> & ray, FLOAT tmax);
+
+template <class FLOAT, size_t N>
+bool occluded(std::span<const Triangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, FLOAT tmax);
+
+template <class FLOAT, size_t N>
+bool occluded(std::span<const PrecomputedTriangle<FLOAT, N>> triangles, const Ray<FLOAT, N> & ray, FLOAT tmax);
+
 
 typedef Ray<float, 2u> Ray2df;
 typedef Ray<float, 3u> Ray3df;
+typedef PrecomputedRay<float, 2u> PrecomputedRay2df;
+typedef PrecomputedRay<float, 3u> PrecomputedRay3df;
 
 typedef AxisAlignedBoundingBox<float, 2u> AABB2df;
 typedef AxisAlignedBoundingBox<float, 3u> AABB3df;
@@ -147,6 +273,43 @@ typedef Sphere<float, 2u> Sphere2df;
 typedef Sphere<float, 3u> Sphere3df;
 
 typedef Triangle<float, 3u> Triangle3df;
+typedef PrecomputedTriangle<float, 3u> PrecomputedTriangle3df;
+
+// with INLINE_TEMPLATES defined, the definitions are visible in every translation unit,
+// so that small functions like Sphere::intersects are inlined without link time optimization,
+// the explicit instantiation declarations keep the larger ones compiled only once in geometry.cc
+#ifdef INLINE_TEMPLATES
+#include "geometry.tcc"
+
+extern template class Intersection_Context<float, 3u>;
+extern template class Ray<float, 2u>;
+extern template class Ray<float, 3u>;
+extern template struct PrecomputedRay<float, 2u>;
+extern template struct PrecomputedRay<float, 3u>;
+extern template class AxisAlignedBoundingBox<float, 2u>;
+extern template class AxisAlignedBoundingBox<float, 3u>;
+extern template class Sphere<float, 2u>;
+extern template class Sphere<float, 3u>;
+extern template class Triangle<float, 3u>;
+extern template class PrecomputedTriangle<float, 3u>;
+extern template bool closest_hit<float, 3u>(std::span<const Triangle<float, 3u>> triangles, const Ray<float, 3u> & ray, Intersection_Context<float, 3u> & context);
+extern template bool closest_hit<float, 3u>(std::span<const PrecomputedTriangle<float, 3u>> triangles, const Ray<float, 3u> & ray, Intersection_Context<float, 3u> & context);
+extern template bool occluded<float, 2u>(std::span<const Sphere<float, 2u>> spheres, const Ray<float, 2u> & ray, float tmax);
+extern template bool occluded<float, 3u>(std::span<const Sphere<float, 3u>> spheres, const Ray<float, 3u> & ray, float tmax);
+extern template bool occluded<float, 3u>(std::span<const Triangle<float, 3u>> triangles, const Ray<float, 3u> & ray, float tmax);
+extern template bool occluded<float, 3u>(std::span<const PrecomputedTriangle<float, 3u>> triangles, const Ray<float, 3u> & ray, float tmax);
+extern template bool refract<float, 3u>(float refraction_index, Vector<float, 3u> normal, Vector<float, 3u> direction, Vector<float, 3> & transmission);
+extern template struct RayPacket<float, 3u, 4u>;
+extern template struct RayPacket<float, 3u, 8u>;
+extern template std::uint32_t AxisAlignedBoundingBox<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+extern template std::uint32_t AxisAlignedBoundingBox<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
+extern template std::uint32_t Sphere<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+extern template std::uint32_t Sphere<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
+extern template std::uint32_t Triangle<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+extern template std::uint32_t Triangle<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
+extern template std::uint32_t PrecomputedTriangle<float, 3u>::intersects<4u>(const RayPacket<float, 3u, 4u> &packet, std::array<float, 4u> & t) const;
+extern template std::uint32_t PrecomputedTriangle<float, 3u>::intersects<8u>(const RayPacket<float, 3u, 8u> &packet, std::array<float, 8u> & t) const;
+#endif
 
 
 #endif
@@ -0,0 +1,124 @@
+#include "geometry.h"
+#include "geometry.tcc" // lets the compiler inline refract like the formula it is compared with
+#include "vector_expression.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// micro benchmark of the ray and refraction paths of the geometry module
+// compares the formulas written with plain Vector operators (a temporary per operator)
+// against the expression template versions used by the library
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc geometry.cc geometry_benchmark.cc -o geometry_benchmark
+// the ray-triangle and ray-sphere throughput depends on the Vector3df layout, build it again with
+//   g++ -std=c++20 -O2 -DNDEBUG -DMATH_PADDED_VECTOR3 math.cc geometry.cc geometry_benchmark.cc -o geometry_benchmark_padded
+// to compare the packed 12 byte layout against the padded 16 byte one
+// run it with "perf stat -e instructions" to compare instruction counts
+
+namespace {
+
+constexpr size_t NO_OF_RAYS = 1024u;
+constexpr size_t REPETITIONS = 20000u;
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+// calls operation for every ray REPETITIONS times and prints the average time per call
+template <class OPERATION>
+void measure(const char * name, const std::vector<Ray3df> & rays, OPERATION operation) {
+  float sum = 0.0f;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < REPETITIONS; repetition++) {
+    for (const Ray3df & ray : rays) {
+      sum += operation(ray);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = sum;
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << name << ": " << nanoseconds / (REPETITIONS * rays.size()) << " ns/op" << std::endl;
+}
+
+// tests every ray against every primitive INTERSECTION_REPETITIONS times
+// and prints the average time per test
+template <class PRIMITIVE>
+void measure_intersections(const char * name, const std::vector<Ray3df> & rays, const std::vector<PRIMITIVE> & primitives) {
+  constexpr size_t INTERSECTION_REPETITIONS = 100u;
+  Intersection_Context<float, 3u> context;
+  size_t hits = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < INTERSECTION_REPETITIONS; repetition++) {
+    for (const Ray3df & ray : rays) {
+      for (const PRIMITIVE & primitive : primitives) {
+        hits += primitive.intersects(ray, context);
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = context.t;
+  double tests = static_cast<double>(INTERSECTION_REPETITIONS) * rays.size() * primitives.size();
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << name << ": " << nanoseconds / tests << " ns/test (" << hits / INTERSECTION_REPETITIONS << " hits)" << std::endl;
+}
+
+// the refraction as written with plain Vector operators
+bool refract_with_temporaries(float refraction_index, Vector3df normal, Vector3df direction, Vector3df & transmission) {
+  float cos_theta = direction * normal;
+  float sin_phi_squared = refraction_index * refraction_index * (1.0f - cos_theta * cos_theta);
+  if ( sin_phi_squared > 1.0f ) {
+    return false;
+  }
+  float cos_phi = std::sqrt( 1.0f - sin_phi_squared );
+  transmission = refraction_index * (direction - cos_theta * normal  ) - cos_phi * normal;
+  return true;
+}
+
+}
+
+int main() {
+  std::vector<Ray3df> rays;
+  for (size_t i = 0u; i < NO_OF_RAYS; i++) {
+    Vector3df direction = { 0.1f * (i % 7) - 0.3f, 0.1f * (i % 5) - 0.2f, -1.0f };
+    direction.normalize();
+    rays.push_back( Ray3df{ Vector3df{ 0.01f * i, 0.0f, 5.0f }, direction } );
+  }
+  const Vector3df normal = {0.0f, 0.0f, 1.0f};
+
+  measure("reflective with temporaries", rays, [&](const Ray3df & ray) {
+    Vector3df reflective = ray.direction - 2.0f * (ray.direction * normal) * normal;
+    return reflective[0];
+  });
+  measure("reflective with expression templates", rays, [&](const Ray3df & ray) {
+    return ray.direction.get_reflective(normal)[0];
+  });
+  measure("refract with temporaries", rays, [&](const Ray3df & ray) {
+    Vector3df transmission = {};
+    refract_with_temporaries(0.75f, normal, ray.direction, transmission);
+    return transmission[0];
+  });
+  measure("refract with expression templates", rays, [&](const Ray3df & ray) {
+    Vector3df transmission = {};
+    refract(0.75f, normal, ray.direction, transmission);
+    return transmission[0];
+  });
+  measure("ray point with temporaries", rays, [&](const Ray3df & ray) {
+    Vector3df point = ray.origin + 2.5f * ray.direction;
+    return point[2];
+  });
+  measure("ray point with expression templates", rays, [&](const Ray3df & ray) {
+    Vector3df point = lazy(ray.origin) + 2.5f * lazy(ray.direction);
+    return point[2];
+  });
+
+  std::vector<Triangle3df> triangles;
+  std::vector<Sphere3df> spheres;
+  for (size_t i = 0u; i < 64u; i++) {
+    Vector3df center = { 1.25f * (i % 8), 0.5f * (i / 8) - 2.0f, -0.25f * (i % 5) };
+    triangles.push_back( Triangle3df{ center, center + Vector3df{1.0f, 0.0f, 0.0f}, center + Vector3df{0.0f, 1.0f, 0.0f} } );
+    spheres.push_back( Sphere3df{ center, 0.3f } );
+  }
+  std::cout << "Vector3df: " << sizeof(Vector3df) << " bytes, aligned to " << alignof(Vector3df) << " bytes" << std::endl;
+  measure_intersections("ray-triangle", rays, triangles);
+  std::vector<PrecomputedTriangle3df> precomputed_triangles(triangles.begin(), triangles.end());
+  measure_intersections("ray-triangle precomputed (Moeller-Trumbore)", rays, precomputed_triangles);
+  measure_intersections("ray-sphere", rays, spheres);
+  return 0;
+}
@@ -1,4 +1,15 @@
 #include "geometry.h"
+#include "bvh.h"
+#include "bvh.tcc" // for the hierarchy of double spheres, which bvh.cc and geometry.cc do not instantiate
+#include "geometry.tcc"
+#include "mesh.h"
+#include "ray_tracer.h"
+#include "scene.h"
+#include "sphere_array.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include "vector_random.h"
 #include "gtest/gtest.h"
 
 namespace {
@@ -47,6 +58,43 @@ TEST(AABB, Intersects2dfWithRay_2) {
   EXPECT_TRUE( box1.intersects(ray) );
 }
 
+TEST(AABB, Intersects2dfWithPrecomputedRay_1) {
+  AABB2df box1 = { {0.0, 0.0}, {1.0, 1.0} };
+  PrecomputedRay2df ray{ Ray2df{ {-3.0, 0.5}, {2.0, 0.0} } };
+  float tmin = 0.0f, tmax = INFINITY;
+
+  EXPECT_TRUE( box1.intersects(ray, tmin, tmax) );
+  EXPECT_FLOAT_EQ( 1.0f, tmin );
+  EXPECT_FLOAT_EQ( 2.0f, tmax );
+
+  tmin = 0.0f;
+  tmax = 0.5f; // the box is behind the closest hit
+  EXPECT_FALSE( box1.intersects(ray, tmin, tmax) );
+}
+
+TEST(AABB, Intersects2dfWithPrecomputedRay_2) {
+  AABB2df box1 = { {0.0, 0.0}, {1.0, 1.0} };
+  // the ray runs along the edge and from the inside in negative direction
+  PrecomputedRay2df ray1{ Ray2df{ {-3.0, 1.0}, {1.0, 0.0} } };
+  PrecomputedRay2df ray2{ Ray2df{ {0.5, 0.0}, {0.0, -1.0} } };
+  PrecomputedRay2df ray3{ Ray2df{ {-3.0, 1.5}, {1.0, 0.0} } };
+  float tmin = 0.0f, tmax = INFINITY;
+
+  EXPECT_TRUE( box1.intersects(ray1, tmin, tmax) );
+  EXPECT_FLOAT_EQ( 2.0f, tmin );
+  EXPECT_FLOAT_EQ( 4.0f, tmax );
+
+  tmin = 0.0f;
+  tmax = INFINITY;
+  EXPECT_TRUE( box1.intersects(ray2, tmin, tmax) );
+  EXPECT_FLOAT_EQ( 0.0f, tmin );
+  EXPECT_FLOAT_EQ( 1.0f, tmax );
+
+  tmin = 0.0f;
+  tmax = INFINITY;
+  EXPECT_FALSE( box1.intersects(ray3, tmin, tmax) );
+}
+
 TEST(AABB, Intersects2dfWithMovingAABB_1) {
   AABB2df box1 = { {0.0, 0.0}, {1.0, 1.0} };
   AABB2df box2 = { {-2.0, -2.0}, {0.5, .5} };
@@ -265,6 +313,235 @@ TEST(SPHERE, NotInside_1) {
   EXPECT_FALSE( sphere.inside( Vector3df{-0.5f, 0.0f, 0.0f}) );
 }
 
+// the ray hits the sphere at t = 4 and t = 6
+TEST(SPHERE, Occluded3df) {
+  Sphere3df sphere{ {5.0f, 0.0f, 0.0f}, 1.0f };
+  Ray3df ray{ {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f} };
+  EXPECT_TRUE( sphere.occluded(ray, 4.5f) );
+  EXPECT_TRUE( sphere.occluded(ray, INFINITY) );
+  EXPECT_FALSE( sphere.occluded(ray, 3.5f) );
+  EXPECT_FALSE( sphere.occluded(Ray3df{ {0.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f} }, INFINITY) );
+  EXPECT_FALSE( sphere.occluded(Ray3df{ {0.0f, 2.0f, 0.0f}, {1.0f, 0.0f, 0.0f} }, INFINITY) );
+  // from inside only the exit counts
+  EXPECT_TRUE( sphere.occluded(Ray3df{ {5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f} }, 1.5f) );
+  EXPECT_FALSE( sphere.occluded(Ray3df{ {5.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f} }, 0.5f) );
+}
+
+// occluded(ray, tmax) is true iff intersects finds t < tmax, for primitives, spans and the hierarchies
+TEST(SPHERE, OccludedLikeIntersects) {
+  VectorRandom3df random{29u};
+  std::vector<Vector3df> centers(200u, Vector3df{}), rays(2000u, Vector3df{});
+  random.in_box({-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f}, centers);
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, rays);
+  std::vector<Sphere3df> spheres;
+  for (const Vector3df & center : centers) {
+    spheres.push_back( Sphere3df{ center, 0.5f } );
+  }
+  SphereBVH3df bvh{spheres};
+  size_t occluded_rays = 0;
+  for (size_t i = 0; i < rays.size(); i += 2) {
+    Ray3df ray{ 10.0f * rays[i], rays[i + 1] };
+    float tmax = 10.0f;
+    bool any = false;
+    for (const Sphere3df & sphere : spheres) {
+      float t = sphere.intersects(ray);
+      ASSERT_EQ(t > 0.0f && t < tmax, sphere.occluded(ray, tmax));
+      any = any || (t > 0.0f && t < tmax);
+    }
+    EXPECT_EQ(any, (occluded<float, 3>(spheres, ray, tmax)));
+    EXPECT_EQ(any, bvh.occluded(ray, tmax));
+    occluded_rays += any;
+  }
+  EXPECT_LT(20u, occluded_rays);
+}
+
+TEST(SPHERE, Sweep3df) {
+  Sphere3df sphere{ {0.0f, 0.0f, 0.0f}, 1.0f }, other{ {10.0f, 0.0f, 0.0f}, 2.0f };
+  float time;
+  Vector3df normal{};
+  EXPECT_TRUE( sphere.sweep(other, {2.0f, 0.0f, 0.0f}, 5.0f, time, normal) );
+  EXPECT_NEAR(3.5f, time, 0.00001f);
+  EXPECT_NEAR(-1.0f, normal[0], 0.00001f);
+  EXPECT_NEAR(0.0f, normal[1], 0.00001f);
+  // too late, passing by, moving apart
+  EXPECT_FALSE( sphere.sweep(other, {2.0f, 0.0f, 0.0f}, 3.0f, time, normal) );
+  EXPECT_FALSE( sphere.sweep(other, {2.0f, 1.0f, 0.0f}, 5.0f, time, normal) );
+  EXPECT_FALSE( sphere.sweep(other, {-2.0f, 0.0f, 0.0f}, 5.0f, time, normal) );
+  EXPECT_FALSE( sphere.sweep(other, {0.0f, 0.0f, 0.0f}, 5.0f, time, normal) );
+  // grazing the other sphere at its side
+  EXPECT_TRUE( sphere.sweep(other, {1.0f, 0.25f, 0.0f}, 10.0f, time, normal) );
+  EXPECT_NEAR(1.0f, normal.length(), 0.00001f);
+  // overlapping at the start
+  EXPECT_TRUE( sphere.sweep(Sphere3df{ {0.0f, 2.0f, 0.0f}, 2.0f }, {-2.0f, 0.0f, 0.0f}, 1.0f, time, normal) );
+  EXPECT_EQ(0.0f, time);
+  EXPECT_NEAR(-1.0f, normal[1], 0.00001f);
+}
+
+// a torpedo passing a small asteroid between two ticks is in front of it at the first tick and behind it at the next one
+TEST(SPHERE, SweepTorpedo2df) {
+  float dt = 1.0f / 20.0f;
+  Vector2df velocity = { 768.0f, 0.0f };
+  Sphere2df torpedo{ {0.0f, 0.0f}, 1.0f }, asteroid{ {20.0f, 0.0f}, 8.0f };
+  EXPECT_FALSE( torpedo.intersects(asteroid) );
+  EXPECT_FALSE( (Sphere2df{ torpedo.get_center() + dt * velocity, 1.0f }.intersects(asteroid)) );
+  float time;
+  Vector2df normal{};
+  EXPECT_TRUE( torpedo.sweep(asteroid, velocity, dt, time, normal) );
+  EXPECT_NEAR(11.0f / 768.0f, time, 0.00001f);
+  EXPECT_NEAR(-1.0f, normal[0], 0.00001f);
+  EXPECT_NEAR(0.0f, normal[1], 0.00001f);
+}
+
+TEST(TRIANGLE, OccludedLikeIntersects) {
+  VectorRandom3df random{31u};
+  std::vector<Vector3df> points(3000u, Vector3df{}), rays(2000u, Vector3df{});
+  random.in_box({-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f}, points);
+  std::vector<Triangle3df> triangles;
+  for (size_t i = 0; i < points.size(); i += 3) {
+    triangles.push_back( Triangle3df{ points[i], points[i] + 0.2f * points[i + 1], points[i] + 0.2f * points[i + 2] } );
+  }
+  std::vector<PrecomputedTriangle3df> precomputed_triangles(triangles.begin(), triangles.end());
+  BVH3df bvh{triangles};
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, rays);
+  size_t occluded_rays = 0;
+  for (size_t i = 0; i < rays.size(); i += 2) {
+    Ray3df ray{ 10.0f * rays[i], rays[i + 1] };
+    float tmax = 12.0f;
+    bool any = false;
+    for (const PrecomputedTriangle3df & triangle : precomputed_triangles) {
+      Intersection_Context<float, 3> context;
+      bool hit = triangle.intersects(ray, context) && context.t < tmax;
+      ASSERT_EQ(hit, triangle.occluded(ray, tmax));
+      any = any || hit;
+    }
+    EXPECT_EQ(any, (occluded<float, 3>(precomputed_triangles, ray, tmax)));
+    EXPECT_EQ(any, (occluded<float, 3>(triangles, ray, tmax)));
+    EXPECT_EQ(any, bvh.occluded(ray, tmax));
+    occluded_rays += any;
+  }
+  EXPECT_LT(20u, occluded_rays);
+}
+
+// the kernels find the same overlaps as Sphere::intersects(Sphere) for each pair, the sizes are no multiples
+// of the SIMD width and larger than a tile
+template <size_t N>
+void expect_overlaps_like_intersects(unsigned seed) {
+  VectorRandom<float, N> random{seed};
+  std::vector<Vector<float, N>> centers(700u, Vector<float, N>{}), other_centers(300u, Vector<float, N>{});
+  Vector<float, N> minimum{}, maximum{};
+  for (size_t axis = 0; axis < N; axis++) {
+    minimum[axis] = -50.0f;
+    maximum[axis] = 50.0f;
+  }
+  random.in_box(minimum, maximum, centers);
+  random.in_box(minimum, maximum, other_centers);
+  std::vector<Sphere<float, N>> spheres, other_spheres;
+  for (size_t i = 0; i < centers.size(); i++) {
+    spheres.push_back( Sphere<float, N>{ centers[i], 1.0f + 0.5f * (i % 7) } );
+  }
+  for (size_t i = 0; i < other_centers.size(); i++) {
+    other_spheres.push_back( Sphere<float, N>{ other_centers[i], 2.0f } );
+  }
+  SphereArray<float, N> array{spheres}, others{other_spheres};
+  ASSERT_EQ(spheres.size(), array.size());
+
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> expected_pairs, pairs;
+  for (size_t i = 0; i < spheres.size(); i++) {
+    for (size_t j = i + 1; j < spheres.size(); j++) {
+      if (spheres[i].intersects(spheres[j])) {
+        expected_pairs.emplace_back(i, j);
+      }
+    }
+  }
+  EXPECT_EQ(expected_pairs.size(), array.overlaps(pairs));
+  EXPECT_EQ(expected_pairs, pairs);
+  EXPECT_LT(10u, pairs.size());
+
+  expected_pairs.clear();
+  pairs.clear();
+  for (size_t i = 0; i < spheres.size(); i++) {
+    for (size_t j = 0; j < other_spheres.size(); j++) {
+      if (spheres[i].intersects(other_spheres[j])) {
+        expected_pairs.emplace_back(i, j);
+      }
+    }
+  }
+  EXPECT_EQ(expected_pairs.size(), array.overlaps(others, pairs));
+  std::sort(pairs.begin(), pairs.end());
+  EXPECT_EQ(expected_pairs, pairs);
+
+  std::vector<std::uint32_t> expected_indices, indices = { 42u }; // the indices are appended
+  for (size_t i = 0; i < spheres.size(); i++) {
+    if (other_spheres[0].intersects(spheres[i])) {
+      expected_indices.push_back(i);
+    }
+  }
+  EXPECT_EQ(expected_indices.size(), array.overlaps(other_spheres[0], indices));
+  expected_indices.insert(expected_indices.begin(), 42u);
+  EXPECT_EQ(expected_indices, indices);
+}
+
+TEST(SPHERE_ARRAY, OverlapsLikeIntersects2df) {
+  expect_overlaps_like_intersects<2u>(37u);
+}
+
+TEST(SPHERE_ARRAY, OverlapsLikeIntersects3df) {
+  expect_overlaps_like_intersects<3u>(41u);
+}
+
+TEST(SPHERE_ARRAY, GetAndSet) {
+  SphereArray2df array;
+  array.push_back( Sphere2df{ {1.0f, 2.0f}, 3.0f } );
+  array.push_back( Sphere2df{ {4.0f, 5.0f}, 6.0f } );
+  array.set(0u, Sphere2df{ {7.0f, 8.0f}, 9.0f } );
+  EXPECT_EQ(2u, array.size());
+  EXPECT_EQ(7.0f, array.get(0u).get_center()[0]);
+  EXPECT_EQ(9.0f, array.get(0u).get_radius());
+  EXPECT_EQ(5.0f, array.get(1u).get_center()[1]);
+}
+
+// the batched sweep finds the earliest impact of Sphere::sweep for each pair, the size is no multiple of the SIMD width
+TEST(SPHERE_ARRAY, SweepLikeSphereSweep) {
+  VectorRandom2df random{43u};
+  std::vector<Vector2df> centers(301u, Vector2df{}), velocities(301u, Vector2df{}), others(200u, Vector2df{});
+  random.in_box({-100.0f, -100.0f}, {100.0f, 100.0f}, centers);
+  random.in_box({-20.0f, -20.0f}, {20.0f, 20.0f}, velocities);
+  random.in_box({-100.0f, -100.0f}, {100.0f, 100.0f}, others);
+  SphereArray2df array;
+  VectorArray2df array_velocities;
+  for (size_t i = 0; i < centers.size(); i++) {
+    array.push_back( Sphere2df{ centers[i], 1.0f + 0.5f * (i % 9) } );
+    array_velocities.push_back(velocities[i]);
+  }
+  size_t hits = 0;
+  for (size_t j = 0; j < others.size(); j++) {
+    Sphere2df sphere{ others[j], 1.0f };
+    Vector2df velocity = { 200.0f, 50.0f * (j % 5) - 100.0f };
+    float dt = 0.05f;
+    bool expected_hit = false;
+    size_t expected_index = 0;
+    float expected_time = 0.0f, time, candidate_time;
+    Vector2df normal{}, candidate_normal{};
+    for (size_t i = 0; i < array.size(); i++) {
+      if (sphere.sweep(array.get(i), velocity - velocities[i], dt, candidate_time, candidate_normal)
+          && (! expected_hit || candidate_time < expected_time)) {
+        expected_hit = true;
+        expected_index = i;
+        expected_time = candidate_time;
+      }
+    }
+    size_t index;
+    ASSERT_EQ(expected_hit, array.sweep(sphere, velocity, array_velocities, dt, index, time, normal));
+    if (expected_hit) {
+      EXPECT_EQ(expected_index, index);
+      EXPECT_EQ(expected_time, time);
+      EXPECT_NEAR(1.0f, normal.length(), 0.0001f);
+      hits++;
+    }
+  }
+  EXPECT_LT(10u, hits);
+}
+
 TEST(TRIANGLE, Intersects3dfWithRay_1) {
   Triangle3df triangle = { {0.0, 0.0, 0.0}, {0.0, 3.0, 0.0},{3.0, 0.0, 0.0}  };
   Ray3df ray{ {0.0, 0.0, 2.0}, {0.0, 0.0, -1.0} };
@@ -413,6 +690,19 @@ TEST(TRIANGLE, Intersects3dfWithRay_10) {
   EXPECT_TRUE(triangle1.intersects(ray, normal, intersection, u, v, t) );
 }
 
+// the intersection lies in the plane of a triangle, which is not parallel to an axis
+TEST(TRIANGLE, Intersects3dfWithRay_11) {
+  Triangle3df triangle = { {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f} };
+  Ray3df ray{ {0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f} };
+  Intersection_Context<float, 3> context;
+
+  EXPECT_TRUE(triangle.intersects(ray, context));
+  EXPECT_NEAR(1.0f / 6.0f, context.t, 0.00001);
+  EXPECT_NEAR(1.0, context.intersection[0] + context.intersection[1] + context.intersection[2], 0.00001);
+  EXPECT_NEAR(0.0, context.normal[0] - context.normal[1], 0.00001);
+  EXPECT_NEAR(0.0, context.normal[1] - context.normal[2], 0.00001);
+}
+
 TEST(FRESNEL, Refract_1) {
   Vector3df eye = {0.0f, 0.0f, 0.0f};
   Vector3df direction = {0.0f, -1.0f, 0.0f};
@@ -428,6 +718,501 @@ TEST(FRESNEL, Refract_1) {
   EXPECT_NEAR( 0.0f, transmission[2], 0.00001);
 }
 
+// the Moeller-Trumbore intersection of the precomputed triangles gives the results of Triangle::intersects
+TEST(TRIANGLE, PrecomputedLikeTriangle) {
+  VectorRandom3df random{11u};
+  std::vector<Vector3df> points(3000u, Vector3df{});
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, points);
+  size_t hits = 0;
+  for (size_t i = 0; i < points.size(); i += 6) {
+    Triangle3df triangle{ points[i], points[i + 1], points[i + 2] };
+    PrecomputedTriangle3df precomputed{ triangle };
+    Ray3df ray{ 3.0f * points[i + 3], points[i + 4] - 3.0f * points[i + 3] };
+    Intersection_Context<float, 3> expected, context;
+    bool hit = triangle.intersects(ray, expected);
+    // rays through an edge may hit one and miss the other because of the rounding
+    if (hit != precomputed.intersects(ray, context)) {
+      EXPECT_TRUE(expected.u < 0.0001f || expected.v < 0.0001f || expected.u + expected.v > 0.9999f);
+      continue;
+    }
+    if (hit) {
+      hits++;
+      EXPECT_NEAR(expected.t, context.t, 0.0001);
+      EXPECT_NEAR(expected.u, context.u, 0.0001);
+      EXPECT_NEAR(expected.v, context.v, 0.0001);
+      for (size_t axis = 0; axis < 3; axis++) {
+        EXPECT_NEAR(expected.normal[axis], context.normal[axis], 0.00001);
+        EXPECT_NEAR(expected.intersection[axis], context.intersection[axis], 0.0001);
+      }
+    }
+  }
+  EXPECT_LT(20u, hits);
+
+  std::vector<Triangle3df> mesh = { Triangle3df{ {-1.0f, -1.0f, 2.0f}, {1.0f, -1.0f, 2.0f}, {0.0f, 1.0f, 2.0f} },
+                                    Triangle3df{ {-1.0f, -1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}, {0.0f, 1.0f, 1.0f} } };
+  std::vector<PrecomputedTriangle3df> precomputed_mesh(mesh.begin(), mesh.end());
+  Ray3df ray{ {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f} };
+  Intersection_Context<float, 3> context;
+  EXPECT_TRUE((closest_hit<float, 3>(mesh, ray, context)));
+  EXPECT_NEAR(1.0, context.t, 0.00001);
+  EXPECT_TRUE((closest_hit<float, 3>(precomputed_mesh, ray, context)));
+  EXPECT_NEAR(1.0, context.t, 0.00001);
+}
+
+// the closest hit of the hierarchy is the closest hit of all triangles
+// intersects packets of random rays with random primitives and compares every lane with the single ray
+template <size_t WIDTH>
+void expect_packet_like_single_rays(unsigned seed) {
+  VectorRandom3df random{seed};
+  std::vector<Vector3df> points(600u * WIDTH, Vector3df{});
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, points);
+  size_t hits[3] = {0, 0, 0};
+  for (size_t i = 0; i + 2 * WIDTH + 3 <= points.size(); i += 2 * WIDTH + 3) {
+    std::vector<Ray3df> rays;
+    for (size_t lane = 0; lane < WIDTH; lane++) {
+      rays.push_back( Ray3df{ 3.0f * points[i + 2 * lane], points[i + 2 * lane + 1] - 3.0f * points[i + 2 * lane] } );
+    }
+    rays[0].origin = 0.1f * points[i]; // one ray starts inside the sphere
+    RayPacket<float, 3u, WIDTH> packet{rays};
+    const Vector3df * p = &points[i + 2 * WIDTH];
+    Sphere3df sphere{ p[0], 0.5f + 0.5f * std::fabs(p[1][0]) };
+    AABB3df aabb{ p[0], {0.5f, 0.25f, 0.75f} };
+    Triangle3df triangle{ p[0], p[1], p[2] };
+    PrecomputedTriangle3df precomputed{triangle};
+    std::array<float, WIDTH> sphere_t, aabb_t, triangle_t, precomputed_t;
+    std::uint32_t sphere_hits = sphere.intersects(packet, sphere_t),
+                  aabb_hits = aabb.intersects(packet, aabb_t),
+                  triangle_hits = triangle.intersects(packet, triangle_t),
+                  precomputed_hits = precomputed.intersects(packet, precomputed_t);
+    EXPECT_EQ(triangle_hits, precomputed_hits);
+    for (size_t lane = 0; lane < WIDTH; lane++) {
+      const Ray3df & ray = rays[lane];
+      EXPECT_EQ(ray.origin[1], packet.get_ray(lane).origin[1]);
+      EXPECT_EQ(ray.direction[2], packet.get_ray(lane).direction[2]);
+
+      float t = sphere.intersects(ray);
+      EXPECT_EQ(t > 0.0f, (sphere_hits >> lane) & 1u);
+      EXPECT_NEAR(t > 0.0f ? t : 0.0f, sphere_t[lane], 0.0001);
+      hits[0] += t > 0.0f;
+
+      EXPECT_EQ(aabb.intersects(ray), (aabb_hits >> lane) & 1u);
+      hits[1] += aabb.intersects(ray);
+
+      Intersection_Context<float, 3> context;
+      bool hit = precomputed.intersects(ray, context);
+      EXPECT_EQ(hit, (precomputed_hits >> lane) & 1u);
+      EXPECT_NEAR(hit ? context.t : 0.0f, precomputed_t[lane], 0.0001);
+      EXPECT_EQ(precomputed_t[lane], triangle_t[lane]);
+      hits[2] += hit;
+    }
+  }
+  EXPECT_LT(20u, hits[0]);
+  EXPECT_LT(20u, hits[1]);
+  EXPECT_LT(20u, hits[2]);
+}
+
+TEST(RAY_PACKET, IntersectsLikeSingleRays4) {
+  expect_packet_like_single_rays<4u>(13u);
+}
+
+TEST(RAY_PACKET, IntersectsLikeSingleRays8) {
+  expect_packet_like_single_rays<8u>(17u);
+}
+
+TEST(BVH, ClosestHitLikeAllTriangles) {
+  VectorRandom3df random{7u};
+  std::vector<Vector3df> points(3000u, Vector3df{}), rays(1000u, Vector3df{});
+  random.in_box({-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f}, points);
+  std::vector<Triangle3df> triangles;
+  for (size_t i = 0; i < points.size(); i += 3) {
+    triangles.push_back( Triangle3df{ points[i], points[i] + 0.1f * points[i + 1], points[i] + 0.1f * points[i + 2] } );
+  }
+  BVH3df bvh{triangles};
+  EXPECT_EQ(triangles.size(), bvh.get_primitives().size());
+
+  std::vector<PrecomputedTriangle3df> precomputed_triangles(triangles.begin(), triangles.end());
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, rays);
+  size_t hits = 0;
+  for (size_t i = 0; i < rays.size(); i += 2) {
+    Ray3df ray{ 10.0f * rays[i], rays[i + 1] };
+    Intersection_Context<float, 3> closest, context;
+    bool hit = closest_hit<float, 3>(precomputed_triangles, ray, closest);
+    ASSERT_EQ(hit, bvh.closest_hit(ray, context));
+    if (hit) {
+      hits++;
+      EXPECT_EQ(closest.t, context.t);
+      EXPECT_EQ(closest.intersection[0], context.intersection[0]);
+    }
+  }
+  EXPECT_LT(20u, hits);
+}
+
+// moves the spheres with their velocities for some frames and checks the refitted hierarchy against testing all spheres
+TEST(BVH, RefitSpheresLikeAllSpheres) {
+  VectorRandom3df random{19u};
+  std::vector<Vector3df> centers(500u, Vector3df{}), velocities(500u, Vector3df{}), rays(1000u, Vector3df{});
+  random.in_box({-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f}, centers);
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, velocities);
+  std::vector<Sphere3df> spheres;
+  for (const Vector3df & center : centers) {
+    spheres.push_back( Sphere3df{ center, 0.5f } );
+  }
+  SphereBVH3df bvh{spheres};
+  float cost = bvh.get_cost();
+  size_t rebuilt = 0;
+  for (size_t frame = 0; frame < 20; frame++) {
+    for (size_t i = 0; i < spheres.size(); i++) {
+      centers[i] += velocities[i];
+      spheres[i] = Sphere3df{ centers[i], 0.5f };
+    }
+    rebuilt += bvh.refit(spheres);
+  }
+  EXPECT_LT(0u, rebuilt); // the spheres spread over eight times the volume
+  EXPECT_GT(2.0f * SphereBVH3df{spheres}.get_cost(), bvh.get_cost());
+  EXPECT_LT(0.0f, cost);
+
+  std::span<const SphereBVH3df::Node> nodes = bvh.get_nodes();
+  for (const SphereBVH3df::Node & node : nodes) {
+    for (size_t j = node.index; node.count > 0 && j < node.index + node.count; j++) {
+      EXPECT_EQ(centers[bvh.get_primitive_ids()[j]][0], bvh.get_primitives()[j].get_center()[0]);
+      for (size_t axis = 0; axis < 3; axis++) {
+        EXPECT_LE(node.minimum[axis], bvh.get_primitives()[j].get_center()[axis] - 0.5f);
+        EXPECT_GE(node.maximum[axis], bvh.get_primitives()[j].get_center()[axis] + 0.5f);
+      }
+    }
+  }
+
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, rays);
+  size_t hits = 0;
+  for (size_t i = 0; i < rays.size(); i += 2) {
+    Ray3df ray{ 20.0f * rays[i], rays[i + 1] };
+    float closest = INFINITY;
+    for (const Sphere3df & sphere : spheres) {
+      float t = sphere.intersects(ray);
+      closest = t > 0.0f && t < closest ? t : closest;
+    }
+    Intersection_Context<float, 3> context;
+    ASSERT_EQ(closest < INFINITY, bvh.closest_hit(ray, context));
+    if (closest < INFINITY) {
+      hits++;
+      EXPECT_EQ(closest, context.t);
+    }
+  }
+  EXPECT_LT(20u, hits);
+}
+
+TEST(BVH, RefitTrianglesAfterSmallMotion) {
+  VectorRandom3df random{23u};
+  std::vector<Vector3df> points(3000u, Vector3df{}), rays(1000u, Vector3df{});
+  random.in_box({-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f}, points);
+  std::vector<Triangle3df> triangles;
+  for (size_t i = 0; i < points.size(); i += 3) {
+    triangles.push_back( Triangle3df{ points[i], points[i] + 0.1f * points[i + 1], points[i] + 0.1f * points[i + 2] } );
+  }
+  BVH3df bvh{triangles};
+  Vector3df offset = { 0.05f, -0.02f, 0.01f };
+  for (size_t i = 0; i < points.size(); i += 3) {
+    triangles[i / 3] = Triangle3df{ points[i] + offset, points[i] + offset + 0.1f * points[i + 1], points[i] + offset + 0.1f * points[i + 2] };
+  }
+  EXPECT_EQ(0u, bvh.refit(triangles));
+
+  std::vector<PrecomputedTriangle3df> precomputed_triangles(triangles.begin(), triangles.end());
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, rays);
+  size_t hits = 0;
+  for (size_t i = 0; i < rays.size(); i += 2) {
+    Ray3df ray{ 10.0f * rays[i], rays[i + 1] };
+    Intersection_Context<float, 3> closest, context;
+    bool hit = closest_hit<float, 3>(precomputed_triangles, ray, closest);
+    ASSERT_EQ(hit, bvh.closest_hit(ray, context));
+    if (hit) {
+      hits++;
+      EXPECT_EQ(closest.t, context.t);
+    }
+  }
+  EXPECT_LT(20u, hits);
+}
+
+// the first child of an inner node follows it, and the boxes contain their triangles
+TEST(BVH, DepthFirstNodes) {
+  std::vector<Triangle3df> triangles;
+  for (size_t i = 0; i < 100; i++) {
+    Vector3df corner = { 1.0f * (i % 10), 1.0f * (i / 10), 0.1f * (i % 7) };
+    triangles.push_back( Triangle3df{ corner, corner + Vector3df{0.5f, 0.0f, 0.0f}, corner + Vector3df{0.0f, 0.5f, 0.5f} } );
+  }
+  BVH3df bvh{triangles};
+  std::span<const BVH3df::Node> nodes = bvh.get_nodes();
+  size_t leaf_triangles = 0;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (nodes[i].count == 0) {
+      ASSERT_LT(i + 1, nodes[i].index);
+      for (size_t child : { i + 1, static_cast<size_t>(nodes[i].index) }) {
+        for (size_t axis = 0; axis < 3; axis++) {
+          EXPECT_LE(nodes[i].minimum[axis], nodes[child].minimum[axis]);
+          EXPECT_GE(nodes[i].maximum[axis], nodes[child].maximum[axis]);
+        }
+      }
+    } else {
+      for (size_t j = nodes[i].index; j < nodes[i].index + nodes[i].count; j++, leaf_triangles++) {
+        for (size_t vertex = 0; vertex < 3; vertex++) {
+          for (size_t axis = 0; axis < 3; axis++) {
+            EXPECT_LE(nodes[i].minimum[axis], bvh.get_primitives()[j].get_vertex(vertex)[axis]);
+            EXPECT_GE(nodes[i].maximum[axis], bvh.get_primitives()[j].get_vertex(vertex)[axis]);
+          }
+        }
+      }
+    }
+  }
+  EXPECT_EQ(triangles.size(), leaf_triangles);
 
+  Intersection_Context<float, 3> context;
+  EXPECT_FALSE( BVH3df{std::span<const Triangle3df>{}}.closest_hit(Ray3df{ {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f} }, context) );
+}
+
+// the SAH splits off only a few of the spheres at 2^i per level, which makes a tree of depth 208,
+// the median splits below a depth of 64 keep it within the traversal stack, also when refit builds it again
+TEST(BVH, DepthOfExponentiallySpacedSpheres) {
+  typedef BoundingVolumeHierarchy<double, 3u, Sphere<double, 3u>> SphereBVH3dd;
+  std::vector<Sphere<double, 3u>> spheres, shuffled;
+  for (int i = 0; i < 1000; i++) {
+    spheres.push_back( Sphere<double, 3u>{ {std::ldexp(1.0, i), 0.0, 0.0}, 0.25 } );
+  }
+  for (int i = 0; i < 1000; i++) {
+    shuffled.push_back(spheres[7 * i % 1000]);
+  }
+  auto depth = [](std::span<const SphereBVH3dd::Node> nodes) {
+    size_t depth = 0;
+    std::vector<std::pair<size_t, size_t>> stack = { {0, 1} };
+    while (!stack.empty()) {
+      auto [node, level] = stack.back();
+      stack.pop_back();
+      depth = std::max(depth, level);
+      if (nodes[node].count == 0) {
+        stack.push_back({ node + 1, level + 1 });
+        stack.push_back({ nodes[node].index, level + 1 });
+      }
+    }
+    return depth;
+  };
+  SphereBVH3dd built{spheres}, refitted{shuffled};
+  EXPECT_LT(0u, refitted.refit(spheres));
+  for (const SphereBVH3dd * bvh : { &built, &refitted }) {
+    EXPECT_LT(64u, depth(bvh->get_nodes()));
+    EXPECT_GE(96u, depth(bvh->get_nodes()));
+    Intersection_Context<double, 3> context;
+    std::uint32_t id;
+    ASSERT_TRUE(bvh->closest_hit(Ray<double, 3u>{ {-1.0, 0.0, 0.0}, {1.0, 0.0, 0.0} }, context, id));
+    EXPECT_EQ(0u, id);
+    EXPECT_DOUBLE_EQ(1.75, context.t);
+    ASSERT_TRUE(bvh->closest_hit(Ray<double, 3u>{ {std::ldexp(1.0, 999) + 1.0, 0.0, 0.0}, {-1.0, 0.0, 0.0} }, context, id));
+    EXPECT_EQ(999u, id);
+    EXPECT_TRUE(bvh->occluded(Ray<double, 3u>{ {std::ldexp(1.0, 500), 1.0, 0.0}, {0.0, -1.0, 0.0} }, 2.0, id));
+    EXPECT_EQ(500u, id);
+  }
+}
+
+TEST(SCENE, Ids) {
+  Scene3df scene;
+  std::vector<Triangle3df> triangles = { Triangle3df{ {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f} },
+                                         Triangle3df{ {0.0f, 0.0f, 5.0f}, {1.0f, 0.0f, 5.0f}, {0.0f, 1.0f, 5.0f} } };
+  EXPECT_EQ(0u, scene.add(Sphere3df{ {0.2f, 0.2f, 10.0f}, 1.0f }));
+  EXPECT_EQ(1u, scene.add(triangles));
+  EXPECT_EQ(3u, scene.add(Sphere3df{ {0.2f, 0.2f, -10.0f}, 1.0f }));
+  EXPECT_EQ(4u, scene.size());
+
+  Ray3df ray{ {0.2f, 0.2f, 20.0f}, {0.0f, 0.0f, -1.0f} };
+  Intersection_Context<float, 3> context;
+  std::uint32_t id;
+  for (bool build : { false, true }) {
+    if (build) {
+      scene.build();
+    }
+    EXPECT_EQ(build, scene.is_built());
+    ASSERT_TRUE(scene.closest_hit(ray, context, id));
+    EXPECT_EQ(0u, id);
+    EXPECT_FLOAT_EQ(9.0f, context.t);
+    ASSERT_TRUE(scene.closest_hit(Ray3df{ {0.2f, 0.2f, 8.0f}, {0.0f, 0.0f, -1.0f} }, context, id));
+    EXPECT_EQ(2u, id);
+    EXPECT_FALSE(scene.any_hit(Ray3df{ {0.2f, 0.2f, 8.0f}, {0.0f, 0.0f, -1.0f} }, 2.0f, id));
+    EXPECT_TRUE(scene.any_hit(Ray3df{ {0.2f, 0.2f, 8.0f}, {0.0f, 0.0f, -1.0f} }, 4.0f, id));
+    EXPECT_EQ(2u, id);
+  }
+  scene.add(Sphere3df{ {5.0f, 5.0f, 5.0f}, 1.0f });
+  EXPECT_FALSE(scene.is_built());
+}
+
+// the closest hit of the scene is the one of all spheres and triangles, with and without the hierarchies,
+// the t of the scene without them differs by rounding, since it intersects Triangle instead of PrecomputedTriangle
+TEST(SCENE, ClosestHitLikeAllPrimitives) {
+  VectorRandom3df random{43u};
+  std::vector<Vector3df> points(1500u, Vector3df{}), rays(2000u, Vector3df{});
+  random.in_box({-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f}, points);
+  random.in_box({-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, rays);
+  std::vector<Sphere3df> spheres;
+  std::vector<PrecomputedTriangle3df> triangles;
+  std::vector<std::uint32_t> sphere_ids, triangle_ids;
+  Scene3df scene;
+  for (size_t i = 0; i < points.size(); i += 3) {
+    if (i % 2 == 0) {
+      spheres.push_back( Sphere3df{ points[i], 0.3f } );
+      sphere_ids.push_back(scene.add(spheres.back()));
+    } else {
+      Triangle3df triangle{ points[i], points[i] + 0.2f * points[i + 1], points[i] + 0.2f * points[i + 2] };
+      triangles.emplace_back(triangle);
+      triangle_ids.push_back(scene.add(triangle));
+    }
+  }
+  Scene3df built = scene;
+  built.build();
+  size_t hits = 0;
+  for (size_t r = 0; r < rays.size(); r += 2) {
+    Ray3df ray{ 10.0f * rays[r], rays[r + 1] };
+    Intersection_Context<float, 3> expected{}, candidate{};
+    std::uint32_t expected_id = 0;
+    bool hit = false;
+    for (size_t i = 0; i < spheres.size(); i++) {
+      if (spheres[i].intersects(ray, candidate) && (! hit || candidate.t < expected.t)) {
+        expected = candidate;
+        expected_id = sphere_ids[i];
+        hit = true;
+      }
+    }
+    for (size_t i = 0; i < triangles.size(); i++) {
+      if (triangles[i].intersects(ray, candidate) && (! hit || candidate.t < expected.t)) {
+        expected = candidate;
+        expected_id = triangle_ids[i];
+        hit = true;
+      }
+    }
+    for (const Scene3df * tested : { &scene, &built }) {
+      Intersection_Context<float, 3> context;
+      std::uint32_t id = 0;
+      ASSERT_EQ(hit, tested->closest_hit(ray, context, id));
+      if (hit) {
+        EXPECT_NEAR(expected.t, context.t, 1e-5f);
+        EXPECT_EQ(expected_id, id);
+      }
+      float tmax = 12.0f;
+      ASSERT_EQ(hit && expected.t < tmax, tested->any_hit(ray, tmax, id));
+    }
+    hits += hit;
+  }
+  EXPECT_LT(20u, hits);
+}
+
+TEST(MESH, LoadObjAndBinary) {
+  std::string obj = testing::TempDir() + "mesh_test.obj";
+  std::string binary = testing::TempDir() + "mesh_test.mesh";
+  // a unit square in the z = 0 plane as a quad and a pyramid tip above it referenced with negative indices
+  std::ofstream{obj} << "# square\r\nv 0 0 0\r\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvn 0 0 1\n"
+                        "f 1//1 2//1 3//1 4//1\nv 0.5 0.5 +1.0\nf -4 -3 -1\ng ignored\n";
+  Mesh3df mesh;
+  ASSERT_TRUE( mesh.load_obj(obj) );
+  ASSERT_EQ( 5u, mesh.get_vertex_count() );
+  ASSERT_EQ( 3u, mesh.get_triangle_count() );
+  std::vector<std::uint32_t> indices(mesh.get_indices().begin(), mesh.get_indices().end());
+  EXPECT_EQ( (std::vector<std::uint32_t>{ 0, 1, 2, 0, 2, 3, 1, 2, 4 }), indices );
+  EXPECT_FLOAT_EQ( 1.0f, mesh.get_position(4)[2] );
+  // the normal of vertex 3 comes from the square only, and the one of the tip from the side (1,0,0), (1,1,0), tip
+  EXPECT_FLOAT_EQ( 1.0f, mesh.get_normal(3)[2] );
+  EXPECT_NEAR( 1.0f / std::sqrt(1.25f), mesh.get_normal(4)[0], 0.00001 );
+  EXPECT_NEAR( 0.5f / std::sqrt(1.25f), mesh.get_normal(4)[2], 0.00001 );
+
+  // the normal of the triangle intersection agrees with the vertex normals
+  Intersection_Context<float, 3> context;
+  Ray3df ray{ {0.25f, 0.5f, -1.0f}, {0.0f, 0.0f, 1.0f} };
+  ASSERT_TRUE( mesh.get_triangles()[0].intersects(ray, context) || mesh.get_triangles()[1].intersects(ray, context) );
+  EXPECT_LT( 0.0f, context.normal[2] );
+
+  ASSERT_TRUE( mesh.save_binary(binary) );
+  Mesh3df loaded;
+  ASSERT_TRUE( loaded.load_binary(binary) );
+  ASSERT_EQ( mesh.get_vertex_count(), loaded.get_vertex_count() );
+  EXPECT_TRUE( std::equal(indices.begin(), indices.end(), loaded.get_indices().begin(), loaded.get_indices().end()) );
+  for (size_t vertex = 0; vertex < mesh.get_vertex_count(); vertex++) {
+    for (size_t axis = 0; axis < 3; axis++) {
+      EXPECT_EQ( mesh.get_position(vertex)[axis], loaded.get_position(vertex)[axis] );
+      EXPECT_EQ( mesh.get_normal(vertex)[axis], loaded.get_normal(vertex)[axis] );
+    }
+  }
+
+  std::ofstream{obj} << "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 4\n";
+  EXPECT_FALSE( mesh.load_obj(obj) ); // index out of range
+  EXPECT_EQ( 0u, mesh.get_vertex_count() );
+  std::ofstream{obj} << "v 0 0\n";
+  EXPECT_FALSE( mesh.load_obj(obj) );
+  EXPECT_FALSE( mesh.load_obj(testing::TempDir() + "missing.obj") );
+  EXPECT_FALSE( mesh.load_binary(obj) );
+}
+
+TEST(MESH, LoadObjInParallelChunks) {
+  std::string obj = testing::TempDir() + "mesh_test_large.obj";
+  // a strip of 2 * 100000 triangles with faces referring to earlier chunks, more than 1 MB
+  {
+    std::ofstream file{obj};
+    for (size_t i = 0; i <= 100000; i++) {
+      file << "v " << i << " 0 0\nv " << i << " 1 0\n";
+      if (i > 0) {
+        file << "f " << 2 * i - 1 << " " << 2 * i + 1 << " -1 " << 2 * i << "\n";
+      }
+    }
+  }
+  Mesh3df single, parallel;
+  ASSERT_TRUE( single.load_obj(obj, 1) );
+  ASSERT_TRUE( parallel.load_obj(obj, 4) );
+  EXPECT_EQ( 200002u, parallel.get_vertex_count() );
+  EXPECT_EQ( 200000u, parallel.get_triangle_count() );
+  EXPECT_TRUE( std::equal(single.get_indices().begin(), single.get_indices().end(),
+                          parallel.get_indices().begin(), parallel.get_indices().end()) );
+  EXPECT_EQ( 100000.0f, parallel.get_position(200000)[0] );
+  EXPECT_EQ( 200001u, parallel.get_indices()[3 * 199998 + 2] ); // the last vertex referred to by -1
+}
+
+TEST(RAY_TRACER, RenderSphereWithShadow) {
+  RayTracer3df tracer;
+  tracer.add_sphere( Sphere3df{ {0.0f, 0.0f, 0.0f}, 1.0f }, Material<float>{ {1.0f, 0.0f, 0.0f} } );
+  // a floor below the sphere with the light straight above
+  std::vector<Triangle3df> floor = { Triangle3df{ {-10.0f, -1.0f, -10.0f}, {10.0f, -1.0f, -10.0f}, {0.0f, -1.0f, 10.0f} } };
+  tracer.add_mesh( floor, Material<float>{ {1.0f, 1.0f, 1.0f} } );
+  tracer.add_light( Light<float, 3>{ {0.0f, 10.0f, 0.0f}, {1.0f, 1.0f, 1.0f} } );
+  tracer.set_background( {0.0f, 0.0f, 1.0f} );
+  Camera3df camera{ {0.0f, 0.0f, 5.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 1.0f };
+
+  Imagef image{32, 32}, parallel{32, 32};
+  size_t rays = tracer.render(camera, image, 1);
+  EXPECT_LT( 32u * 32u, rays );
+  EXPECT_EQ( rays, tracer.render(camera, parallel, 3) );
+  for (size_t y = 0; y < 32; y++) {
+    for (size_t x = 0; x < 32; x++) {
+      EXPECT_EQ( image.get_pixel(x, y)[0], parallel.get_pixel(x, y)[0] );
+    }
+  }
+  EXPECT_EQ( 1.0f, image.get_pixel(0, 0)[2] ); // background
+  EXPECT_LT( 0.1f, image.get_pixel(16, 12)[0] ); // the lit top of the sphere
+  EXPECT_EQ( 0.0f, image.get_pixel(16, 12)[1] );
+  // the floor in front of the sphere is lit, the floor hidden behind the sphere from the light is in the shadow
+  EXPECT_LT( 0.5f, image.get_pixel(2, 31)[1] );
+  Camera3df side{ {3.0f, -0.5f, 0.0f}, {0.6f, -1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, 0.1f };
+  Imagef shadow{8, 8};
+  tracer.render(side, shadow, 2);
+  EXPECT_NEAR( 0.1f, shadow.get_pixel(4, 4)[1], 0.001 ); // only the ambient light of the floor next to the sphere
+
+  // a glass sphere without refraction shows what is behind it
+  Imagef glass{32, 32};
+  tracer.add_sphere( Sphere3df{ {0.0f, 0.0f, 3.0f}, 0.5f }, Material<float>{ {0.0f, 0.0f, 0.0f}, 0.0f, 1.0f, 1.0f } );
+  tracer.render(camera, glass, 2);
+  EXPECT_NEAR( image.get_pixel(16, 12)[0], glass.get_pixel(16, 12)[0], 0.01 );
+
+  std::string ppm = testing::TempDir() + "ray_tracer_test.ppm";
+  std::string pfm = testing::TempDir() + "ray_tracer_test.pfm";
+  ASSERT_TRUE( image.write_ppm(ppm) );
+  ASSERT_TRUE( image.write_pfm(pfm) );
+  std::ifstream file{ppm, std::ios::binary};
+  std::string header((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  EXPECT_EQ( std::string("P6\n32 32\n255\n").size() + 32 * 32 * 3, header.size() );
+  EXPECT_EQ( 0, header.compare(0, 3, "P6\n") );
+  std::ifstream float_file{pfm, std::ios::binary};
+  std::string floats((std::istreambuf_iterator<char>(float_file)), std::istreambuf_iterator<char>());
+  EXPECT_EQ( std::string("PF\n32 32\n-1.0\n").size() + 32 * 32 * 12, floats.size() );
+}
 
 }
@@ -5,94 +5,193 @@
 #include <array>
 #include <cstddef>
 #include <cmath>
+#include <span>
+
+// storage policy of Vector: by default the N scalar values are packed without padding
+// with MATH_PADDED_VECTOR3 defined, Vector<float, 3u> is padded with a zero to 16 bytes and aligned to 16 bytes,
+// so that the SSE kernels load and store it with single aligned instructions
+// (all translation units of a program must be compiled with the same setting)
+// VectorPadding is stored behind the N scalar values
+template<class FLOAT_TYPE, size_t N>
+struct VectorPadding {
+  static constexpr bool PADDED = false;
+  static constexpr size_t ALIGNMENT = alignof(std::array<FLOAT_TYPE, N>);
+};
+
+#ifdef MATH_PADDED_VECTOR3
+template<>
+struct VectorPadding<float, 3u> {
+  static constexpr bool PADDED = true;
+  static constexpr size_t ALIGNMENT = 16u;
+  float zero = 0.0f;
+};
+#endif
 
 // A Vector consisting of N scalar values of type FLOAT_TYPE
+// all operations except the angle based ones can be used in constant expressions
 template<class FLOAT_TYPE, size_t N>
-struct Vector {
+struct alignas(VectorPadding<FLOAT_TYPE, N>::ALIGNMENT) Vector {
   static_assert(N > 0u); // no zero length vectors allowed
   
   // stores the N scalar values of this Vector
   // index 0, 1, 2, ... corresponds to x,y,z,... axis
   std::array<FLOAT_TYPE, N> vector;
 
+  // takes no space unless padded
+  [[no_unique_address]] VectorPadding<FLOAT_TYPE, N> padding;
+
   // creates a new Vector with the given scalar values
   // if values is empty, then this->vector is initilized with zeros
   // if less than N values are given, then all remaining values of this->vector
   //   are initialized with the last given value 
-  Vector( std::initializer_list<FLOAT_TYPE> values );
+  constexpr Vector( std::initializer_list<FLOAT_TYPE> values );
   
   // creates a unit vector pointing to the given angle (in radians) in the x/y plane
   // angle = 0 points in the direction of the x-axis
   explicit Vector(FLOAT_TYPE angle);
 
   // adds addend to this Vector and returns the resulting sum
-  Vector & operator+=(const Vector addend);
+  constexpr Vector & operator+=(const Vector addend);
 
   // subtracts minuend from this Vector and returns the resulting difference
-  Vector & operator-=(const Vector minuend);
+  constexpr Vector & operator-=(const Vector minuend);
 
   // multiplies the scalar factor to this vector and returns the result
-  Vector & operator*=(const FLOAT_TYPE factor);
+  constexpr Vector & operator*=(const FLOAT_TYPE factor);
 
   // divides this vector by the given factor and returns the result
-  Vector & operator/=(const FLOAT_TYPE factor);
+  constexpr Vector & operator/=(const FLOAT_TYPE factor);
 
   // returns the reference of the i-th scalar component of this vector      
-  FLOAT_TYPE & operator[](std::size_t i);
+  constexpr FLOAT_TYPE & operator[](std::size_t i);
 
   // returns the i-th scalar component of this Vector
-  FLOAT_TYPE operator[](std::size_t i) const;
+  constexpr FLOAT_TYPE operator[](std::size_t i) const;
 
   // returns the i-th scalar component of this Vector
   // throws an exception if i >= N
   FLOAT_TYPE at(std::size_t i) const;
   
   // normalize this Vector to the length 1  
-  void normalize();
+  constexpr void normalize();
   
   // returns the specular reflective "ray" Vector wrt the give normal vector
   // normal must be a normalized vector
-  Vector get_reflective(Vector normal) const;
+  constexpr Vector get_reflective(Vector normal) const;
   
   // returns the angle of this Vector between the two given axis in radians
   FLOAT_TYPE angle(size_t axis_1, size_t axis_2) const;
 
   // returns the cross product of this Vector with the Vector v
   // only three-dimensional case
-  Vector<FLOAT_TYPE, 3u> cross_product(const Vector<FLOAT_TYPE, 3u> v) const;
+  constexpr Vector<FLOAT_TYPE, 3u> cross_product(const Vector<FLOAT_TYPE, 3u> v) const;
   
   // returns the scalar product of the given scalar and value
   template <class F, size_t K>    
-  friend Vector<F, K> operator*(F scalar, Vector<F, K> value);
+  friend constexpr Vector<F, K> operator*(F scalar, Vector<F, K> value);
 
   // returns the vector sum of the to given vectors
   template <class F, size_t K>    
-  friend Vector<F, K> operator+(const Vector<F, K> value, const Vector<F, K> addend);
+  friend constexpr Vector<F, K> operator+(const Vector<F, K> value, const Vector<F, K> addend);
 
   // returns the vector difference value - minuend
   template <class F, size_t K>    
-  friend Vector<F, K> operator-(const Vector<F, K> value, const Vector<F, K> minuend);
+  friend constexpr Vector<F, K> operator-(const Vector<F, K> value, const Vector<F, K> minuend);
 
 
   // returns the (euclidian) length of this Vector
-  FLOAT_TYPE length() const;
+  constexpr FLOAT_TYPE length() const;
   
 
   // returns the square of the this Vector's length
-  FLOAT_TYPE square_of_length() const;
+  constexpr FLOAT_TYPE square_of_length() const;
 
 
   // returns the scalar (inner) product of two Vectors
   template <class F, size_t K>    
-  friend F operator*(Vector<F, K> vector1, const Vector<F, K> vector2);
+  friend constexpr F operator*(Vector<F, K> vector1, const Vector<F, K> vector2);
   
 };
 
-static const long double PI = std::acos(-1.0L);
+constexpr long double PI = 3.141592653589793238462643383279502884L;
 
 // shorter comfortable type names
 typedef Vector<float, 2u> Vector2df;
 typedef Vector<float, 3u> Vector3df;
 typedef Vector<float, 4u> Vector4df;
 
+
+// A R x C Matrix of FLOAT_TYPE values stored row by row
+template<class FLOAT_TYPE, size_t R, size_t C>
+struct Matrix {
+  static_assert(R > 0u && C > 0u); // no empty matrices allowed
+
+  // stores the R rows of this Matrix
+  std::array<Vector<FLOAT_TYPE, C>, R> rows;
+
+  // creates a new Matrix with the given rows
+  // if less than R rows are given, then all remaining rows are null vectors
+  constexpr Matrix( std::initializer_list<Vector<FLOAT_TYPE, C>> rows );
+
+  // returns the identity matrix (ones on the diagonal, zeros everywhere else)
+  static constexpr Matrix identity();
+
+  // returns the reference of the i-th row of this Matrix
+  constexpr Vector<FLOAT_TYPE, C> & operator[](std::size_t i);
+
+  // returns the i-th row of this Matrix
+  constexpr Vector<FLOAT_TYPE, C> operator[](std::size_t i) const;
+
+  // returns the product of this Matrix with the given vector
+  constexpr Vector<FLOAT_TYPE, R> operator*(const Vector<FLOAT_TYPE, C> vector) const;
+
+  // returns the matrix product of this Matrix and matrix
+  template <size_t K>
+  constexpr Matrix<FLOAT_TYPE, R, K> operator*(const Matrix<FLOAT_TYPE, C, K> & matrix) const;
+
+  // multiplies every vector with this Matrix and stores the result at the same index of transformed
+  // vectors and transformed may be the same span
+  void transform(std::span<const Vector<FLOAT_TYPE, C>> vectors, std::span<Vector<FLOAT_TYPE, R>> transformed) const;
+
+  // applies this affine transformation to every point (homogeneous coordinate 1)
+  // and stores the result at the same index of transformed; the last row is expected to be 0 ... 0 1
+  // only for square matrices, points and transformed may be the same span
+  void transform_points(std::span<const Vector<FLOAT_TYPE, C - 1>> points, std::span<Vector<FLOAT_TYPE, R - 1>> transformed) const;
+};
+
+// returns the 2 x 2 Matrix rotating by the given angle (in radians) in the x/y plane
+template<class FLOAT_TYPE>
+Matrix<FLOAT_TYPE, 2u, 2u> rotation(FLOAT_TYPE angle);
+
+// returns the 3 x 3 affine Matrix which rotates 2d points around the origin so that the x-axis
+// points to the unit vector direction, scales them by scale, and finally translates them by translation
+template<class FLOAT_TYPE>
+constexpr Matrix<FLOAT_TYPE, 3u, 3u> affine_2d(Vector<FLOAT_TYPE, 2u> direction, FLOAT_TYPE scale, Vector<FLOAT_TYPE, 2u> translation);
+
+// the same as above for a rotation by the given angle (in radians)
+template<class FLOAT_TYPE>
+Matrix<FLOAT_TYPE, 3u, 3u> affine_2d(FLOAT_TYPE angle, FLOAT_TYPE scale, Vector<FLOAT_TYPE, 2u> translation);
+
+typedef Matrix<float, 2u, 2u> Matrix2df;
+typedef Matrix<float, 3u, 3u> Matrix3df;
+typedef Matrix<float, 4u, 4u> Matrix4df;
+
+// the definitions are needed in every translation unit for constant expressions
+#include "math.tcc"
+
+// with INLINE_TEMPLATES defined, the explicit instantiation declarations keep the functions
+// which are neither constexpr nor inline compiled only once in math.cc
+#ifdef INLINE_TEMPLATES
+extern template class Vector<float, 2u>;
+extern template class Vector<float, 3u>;
+extern template class Vector<float, 4u>;
+
+extern template class Matrix<float, 2u, 2u>;
+extern template class Matrix<float, 3u, 3u>;
+extern template class Matrix<float, 4u, 4u>;
+
+extern template Matrix<float, 2u, 2u> rotation(float angle);
+extern template Matrix<float, 3u, 3u> affine_2d(float angle, float scale, Vector<float, 2u> translation);
+#endif
+
 #endif
@@ -0,0 +1,46 @@
+#include "mesh.h"
+#include "mesh.tcc"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string & path) {
+  int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    return;
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) == 0) {
+    size = static_cast<size_t>(status.st_size);
+    if (size == 0u) {
+      open = true; // an empty file cannot be mapped
+    } else {
+      void * address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (address != MAP_FAILED) {
+        madvise(address, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(address);
+        open = true;
+      } else {
+        size = 0u;
+      }
+    }
+  }
+  close(descriptor); // the mapping stays valid
+}
+
+MappedFile::~MappedFile() {
+  if (data != nullptr) {
+    munmap(const_cast<char *>(data), size);
+  }
+}
+
+bool MappedFile::is_open() const {
+  return open;
+}
+
+std::span<const char> MappedFile::get_data() const {
+  return { data, size };
+}
+
+template class Mesh<float, 3u>;
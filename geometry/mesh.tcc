@@ -0,0 +1,291 @@
+#ifndef MESH_TCC
+#define MESH_TCC
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include "mesh.h"
+
+template <class FLOAT, size_t N>
+inline std::string_view Mesh<FLOAT, N>::next_line(std::string_view text, size_t & position) {
+  size_t end = text.find('\n', position);
+  if (end == std::string_view::npos) {
+    end = text.size();
+  }
+  std::string_view line = text.substr(position, end - position);
+  position = end + 1u;
+  if (! line.empty() && line.back() == '\r') {
+    line.remove_suffix(1u);
+  }
+  return line;
+}
+
+template <class FLOAT, size_t N>
+inline bool Mesh<FLOAT, N>::parse(std::string_view & text, FLOAT & value) {
+  size_t begin = text.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) {
+    return false;
+  }
+  begin += text[begin] == '+'; // from_chars accepts no plus sign
+  auto [end, error] = std::from_chars(text.data() + begin, text.data() + text.size(), value);
+  text.remove_prefix(end - text.data());
+  return error == std::errc{};
+}
+
+template <class FLOAT, size_t N>
+inline bool Mesh<FLOAT, N>::parse(std::string_view & text, long & value) {
+  size_t begin = text.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) {
+    return false;
+  }
+  auto [end, error] = std::from_chars(text.data() + begin, text.data() + text.size(), value);
+  text.remove_prefix(end - text.data());
+  return error == std::errc{};
+}
+
+template <class FLOAT, size_t N>
+size_t Mesh<FLOAT, N>::count_vertices(std::string_view text) {
+  size_t count = 0u;
+  size_t position = 0u;
+  while (position < text.size()) {
+    std::string_view line = next_line(text, position);
+    count += line.size() > 1u && line[0] == 'v' && (line[1] == ' ' || line[1] == '\t');
+  }
+  return count;
+}
+
+template <class FLOAT, size_t N>
+bool Mesh<FLOAT, N>::parse_chunk(std::string_view text, size_t first_vertex, std::vector<std::uint32_t> & triangle_indices) {
+  const size_t vertex_count = positions[0].size();
+  size_t vertex = first_vertex;
+  size_t position = 0u;
+  while (position < text.size()) {
+    std::string_view line = next_line(text, position);
+    if (line.size() < 2u || (line[1] != ' ' && line[1] != '\t')) {
+      continue;
+    }
+    if (line[0] == 'v') {
+      line.remove_prefix(1u);
+      for (size_t axis = 0u; axis < N; axis++) {
+        if (! parse(line, positions[axis][vertex])) {
+          return false;
+        }
+      }
+      vertex++;
+    } else if (line[0] == 'f') {
+      line.remove_prefix(1u);
+      // the corners are "v", "v/vt", "v//vn" or "v/vt/vn", negative indices count back from the last vertex
+      std::uint32_t first = 0u, previous = 0u;
+      size_t corners = 0u;
+      long index;
+      while (parse(line, index)) {
+        size_t end = line.find_first_of(" \t");
+        line.remove_prefix(end == std::string_view::npos ? line.size() : end);
+        long resolved = index > 0 ? index - 1 : static_cast<long>(vertex) + index;
+        if (index == 0 || resolved < 0 || static_cast<size_t>(resolved) >= vertex_count) {
+          return false;
+        }
+        std::uint32_t current = static_cast<std::uint32_t>(resolved);
+        if (corners == 0u) {
+          first = current;
+        } else if (corners >= 2u) {
+          triangle_indices.insert(triangle_indices.end(), { first, previous, current });
+        }
+        previous = current;
+        corners++;
+      }
+      if (corners < 3u || line.find_first_not_of(" \t") != std::string_view::npos) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <class FLOAT, size_t N>
+void Mesh<FLOAT, N>::compute_normals() {
+  for (size_t axis = 0u; axis < N; axis++) {
+    normals[axis].assign(positions[axis].size(), static_cast<FLOAT>(0.0));
+  }
+  for (size_t i = 0u; i < indices.size(); i += 3u) {
+    Vector<FLOAT, N> a = get_position(indices[i]),
+                     edge1 = get_position(indices[i + 1u]) - a,
+                     edge2 = get_position(indices[i + 2u]) - a;
+    // (b - a) x (c - a), its length is twice the area
+    FLOAT normal[N] = { edge1[1] * edge2[2] - edge1[2] * edge2[1],
+                        edge1[2] * edge2[0] - edge1[0] * edge2[2],
+                        edge1[0] * edge2[1] - edge1[1] * edge2[0] };
+    for (size_t corner = i; corner < i + 3u; corner++) {
+      for (size_t axis = 0u; axis < N; axis++) {
+        normals[axis][indices[corner]] += normal[axis];
+      }
+    }
+  }
+  for (size_t vertex = 0u; vertex < normals[0].size(); vertex++) {
+    FLOAT length = std::sqrt(normals[0][vertex] * normals[0][vertex] + normals[1][vertex] * normals[1][vertex]
+                           + normals[2][vertex] * normals[2][vertex]);
+    if (length > 0.0) {
+      for (size_t axis = 0u; axis < N; axis++) {
+        normals[axis][vertex] /= length;
+      }
+    }
+  }
+}
+
+// the file is split into one chunk per thread at line breaks, the threads count the vertices of their chunks
+// first, so that each one knows where its vertices go and how to resolve negative indices, and then parse them
+template <class FLOAT, size_t N>
+bool Mesh<FLOAT, N>::load_obj(const std::string & path, size_t threads) {
+  *this = Mesh{};
+  MappedFile file{path};
+  if (! file.is_open()) {
+    return false;
+  }
+  std::string_view text{ file.get_data().data(), file.get_data().size() };
+  threads = std::clamp<size_t>(text.size() / MIN_CHUNK_SIZE, 1u, std::max<size_t>(threads, 1u));
+
+  std::vector<size_t> begins(threads + 1u, text.size());
+  begins[0] = 0u;
+  for (size_t chunk = 1u; chunk < threads; chunk++) {
+    size_t end = text.find('\n', std::max(begins[chunk - 1u], text.size() * chunk / threads));
+    begins[chunk] = end == std::string_view::npos ? text.size() : end + 1u;
+  }
+  auto parallel = [threads](auto function) {
+    std::vector<std::thread> workers;
+    for (size_t chunk = 1u; chunk < threads; chunk++) {
+      workers.emplace_back(function, chunk);
+    }
+    function(0u);
+    for (std::thread & worker : workers) {
+      worker.join();
+    }
+  };
+  auto chunk_text = [&text, &begins](size_t chunk) { return text.substr(begins[chunk], begins[chunk + 1u] - begins[chunk]); };
+
+  std::vector<size_t> first_vertices(threads + 1u, 0u);
+  parallel([&](size_t chunk) { first_vertices[chunk + 1u] = count_vertices(chunk_text(chunk)); });
+  for (size_t chunk = 0u; chunk < threads; chunk++) {
+    first_vertices[chunk + 1u] += first_vertices[chunk];
+  }
+  if (first_vertices[threads] > UINT32_MAX) {
+    return false;
+  }
+  for (size_t axis = 0u; axis < N; axis++) {
+    positions[axis].resize(first_vertices[threads]);
+  }
+
+  std::vector<std::vector<std::uint32_t>> chunk_indices(threads);
+  std::vector<char> valid(threads);
+  parallel([&](size_t chunk) { valid[chunk] = parse_chunk(chunk_text(chunk), first_vertices[chunk], chunk_indices[chunk]); });
+  if (std::find(valid.begin(), valid.end(), false) != valid.end()) {
+    *this = Mesh{};
+    return false;
+  }
+  size_t index_count = 0u;
+  for (const std::vector<std::uint32_t> & chunk : chunk_indices) {
+    index_count += chunk.size();
+  }
+  indices.reserve(index_count);
+  for (const std::vector<std::uint32_t> & chunk : chunk_indices) {
+    indices.insert(indices.end(), chunk.begin(), chunk.end());
+  }
+  compute_normals();
+  return true;
+}
+
+template <class FLOAT, size_t N>
+bool Mesh<FLOAT, N>::load_binary(const std::string & path) {
+  *this = Mesh{};
+  MappedFile file{path};
+  std::span<const char> data = file.get_data();
+  BinaryHeader header;
+  if (! file.is_open() || data.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+  size_t vertex_bytes = sizeof(FLOAT) * header.vertices;
+  size_t index_bytes = 3u * sizeof(std::uint32_t) * header.triangles;
+  if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 || header.float_size != sizeof(FLOAT)
+      || data.size() != sizeof(header) + 2u * N * vertex_bytes + index_bytes) {
+    return false;
+  }
+  const char * source = data.data() + sizeof(header);
+  for (std::array<std::vector<FLOAT>, N> * arrays : { &positions, &normals }) {
+    for (std::vector<FLOAT> & array : *arrays) {
+      array.resize(header.vertices);
+      std::memcpy(array.data(), source, vertex_bytes);
+      source += vertex_bytes;
+    }
+  }
+  indices.resize(3u * header.triangles);
+  std::memcpy(indices.data(), source, index_bytes);
+  if (std::any_of(indices.begin(), indices.end(), [&header](std::uint32_t index) { return index >= header.vertices; })) {
+    *this = Mesh{};
+    return false;
+  }
+  return true;
+}
+
+template <class FLOAT, size_t N>
+bool Mesh<FLOAT, N>::save_binary(const std::string & path) const {
+  std::ofstream file{path, std::ios::binary};
+  BinaryHeader header;
+  std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  header.float_size = sizeof(FLOAT);
+  header.vertices = static_cast<std::uint32_t>(get_vertex_count());
+  header.triangles = static_cast<std::uint32_t>(get_triangle_count());
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const std::array<std::vector<FLOAT>, N> * arrays : { &positions, &normals }) {
+    for (const std::vector<FLOAT> & array : *arrays) {
+      file.write(reinterpret_cast<const char *>(array.data()), sizeof(FLOAT) * array.size());
+    }
+  }
+  file.write(reinterpret_cast<const char *>(indices.data()), sizeof(std::uint32_t) * indices.size());
+  return file.good();
+}
+
+template <class FLOAT, size_t N>
+inline size_t Mesh<FLOAT, N>::get_vertex_count() const {
+  return positions[0].size();
+}
+
+template <class FLOAT, size_t N>
+inline size_t Mesh<FLOAT, N>::get_triangle_count() const {
+  return indices.size() / 3u;
+}
+
+template <class FLOAT, size_t N>
+inline Vector<FLOAT, N> Mesh<FLOAT, N>::get_position(size_t vertex) const {
+  return { positions[0][vertex], positions[1][vertex], positions[2][vertex] };
+}
+
+template <class FLOAT, size_t N>
+inline Vector<FLOAT, N> Mesh<FLOAT, N>::get_normal(size_t vertex) const {
+  return { normals[0][vertex], normals[1][vertex], normals[2][vertex] };
+}
+
+template <class FLOAT, size_t N>
+inline std::span<const std::uint32_t> Mesh<FLOAT, N>::get_indices() const {
+  return indices;
+}
+
+template <class FLOAT, size_t N>
+Triangle<FLOAT, N> Mesh<FLOAT, N>::get_triangle(size_t triangle) const {
+  const std::uint32_t * corners = &indices[3u * triangle];
+  return { get_position(corners[0]), get_position(corners[1]), get_position(corners[2]),
+           get_normal(corners[0]), get_normal(corners[1]), get_normal(corners[2]) };
+}
+
+template <class FLOAT, size_t N>
+std::vector<Triangle<FLOAT, N>> Mesh<FLOAT, N>::get_triangles() const {
+  std::vector<Triangle<FLOAT, N>> triangles;
+  triangles.reserve(get_triangle_count());
+  for (size_t triangle = 0u; triangle < get_triangle_count(); triangle++) {
+    triangles.push_back(get_triangle(triangle));
+  }
+  return triangles;
+}
+
+#endif
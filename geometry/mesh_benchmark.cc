@@ -0,0 +1,75 @@
+#include "mesh.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// writes an OBJ file of a bumpy sphere with 2M triangles and measures loading it with one and with all threads,
+// and storing and loading it in the binary format
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc geometry.cc ray_packet.cc mesh.cc mesh_benchmark.cc -o mesh_benchmark -pthread
+// the first load reads the file from the disk, the others from the page cache
+
+namespace {
+
+constexpr size_t RINGS = 1000u;
+constexpr size_t SEGMENTS = 1000u;
+
+// writes the grid of (RINGS + 1) * SEGMENTS vertices and two triangles per grid cell
+void write_obj(const std::string & path) {
+  std::ofstream file{path};
+  char line[64];
+  for (size_t ring = 0u; ring <= RINGS; ring++) {
+    float theta = PI * ring / RINGS;
+    for (size_t segment = 0u; segment < SEGMENTS; segment++) {
+      float phi = 2.0f * PI * segment / SEGMENTS;
+      float radius = 1.0f + 0.05f * std::sin(8.0f * theta) * std::sin(8.0f * phi);
+      std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", radius * std::sin(theta) * std::cos(phi),
+                    radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta));
+      file << line;
+    }
+  }
+  for (size_t ring = 0u; ring < RINGS; ring++) {
+    for (size_t segment = 0u; segment < SEGMENTS; segment++) {
+      size_t a = ring * SEGMENTS + segment + 1u;
+      size_t b = ring * SEGMENTS + (segment + 1u) % SEGMENTS + 1u;
+      file << "f " << a << ' ' << a + SEGMENTS << ' ' << b + SEGMENTS << "\nf " << a << ' ' << b + SEGMENTS << ' ' << b << '\n';
+    }
+  }
+}
+
+template <class FUNCTION>
+double seconds(FUNCTION function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string & name, double time, const std::string & path, const Mesh3df & mesh) {
+  double megabytes = std::filesystem::file_size(path) / 1.0e6;
+  std::cout << name << ": " << time << " s, " << megabytes / time << " MB/s, "
+            << mesh.get_triangle_count() / time / 1.0e6 << " M triangles/s" << std::endl;
+}
+
+}
+
+int main() {
+  std::string obj = (std::filesystem::temp_directory_path() / "mesh_benchmark.obj").string();
+  std::string binary = (std::filesystem::temp_directory_path() / "mesh_benchmark.mesh").string();
+  write_obj(obj);
+  std::cout << std::filesystem::file_size(obj) / 1.0e6 << " MB OBJ file" << std::endl;
+
+  Mesh3df mesh;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  report("load OBJ with 1 thread", seconds([&]() { mesh.load_obj(obj, 1u); }), obj, mesh);
+  report("load OBJ with " + std::to_string(threads) + " threads", seconds([&]() { mesh.load_obj(obj, threads); }), obj, mesh);
+  report("save binary", seconds([&]() { mesh.save_binary(binary); }), binary, mesh);
+  report("load binary", seconds([&]() { mesh.load_binary(binary); }), binary, mesh);
+  std::cout << mesh.get_vertex_count() << " vertices, " << mesh.get_triangle_count() << " triangles" << std::endl;
+
+  std::filesystem::remove(obj);
+  std::filesystem::remove(binary);
+  return 0;
+}
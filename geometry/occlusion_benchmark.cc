@@ -0,0 +1,130 @@
+#include "bvh.h"
+#include "vector_random.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// compares occluded(ray, tmax), which stops at any hit, with closest_hit followed by t < tmax for shadow rays
+// from random points to a light: 1000 spheres tested one by one, 100k spheres and a mesh of 200k triangles in a BVH
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc vector_random.cc geometry.cc ray_packet.cc bvh.cc occlusion_benchmark.cc -o occlusion_benchmark
+// the any hit query skips the square roots and the hit data, and in a BVH the search for a closer hit,
+// which makes it 1.1 to 1.3 times faster, more so the more rays are blocked early
+
+namespace {
+
+constexpr size_t RAYS = 200000u;
+
+volatile size_t sink; // keeps the compiler from removing the measured work
+
+struct ShadowRay {
+  Ray3df ray;
+  float distance;
+};
+
+// returns normalized rays from random points in the box from minimum to maximum to the light
+std::vector<ShadowRay> shadow_rays(Vector3df minimum, Vector3df maximum, Vector3df light) {
+  VectorRandom3df random{5u};
+  std::vector<Vector3df> origins(RAYS, Vector3df{});
+  random.in_box(minimum, maximum, origins);
+  std::vector<ShadowRay> rays;
+  for (const Vector3df & origin : origins) {
+    Vector3df direction = light - origin;
+    float distance = direction.length();
+    direction *= 1.0f / distance;
+    rays.push_back( ShadowRay{ Ray3df{ origin, direction }, distance } );
+  }
+  return rays;
+}
+
+// prints the rays per second of query(ray, distance), which returns true if the ray is blocked
+template <class QUERY>
+double measure(const std::string & name, const std::vector<ShadowRay> & rays, QUERY query) {
+  size_t blocked = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (const ShadowRay & shadow : rays) {
+    blocked += query(shadow.ray, shadow.distance);
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = blocked;
+  double rays_per_second = rays.size() / std::chrono::duration<double>(end - start).count();
+  std::cout << "  " << name << ": " << rays_per_second / 1.0e6 << " M rays/s, " << 100.0 * blocked / rays.size() << "% blocked" << std::endl;
+  return rays_per_second;
+}
+
+template <class CLOSEST, class OCCLUDED>
+void compare(const std::string & name, const std::vector<ShadowRay> & rays, CLOSEST closest, OCCLUDED occluded) {
+  std::cout << name << std::endl;
+  double closest_rate = measure("closest hit", rays, closest);
+  double occluded_rate = measure("occluded   ", rays, occluded);
+  std::cout << "  speedup " << occluded_rate / closest_rate << std::endl;
+}
+
+Vector3df bumpy_sphere(float theta, float phi) {
+  float radius = 1.0f + 0.05f * std::sin(8.0f * theta) * std::sin(8.0f * phi);
+  return { radius * std::sin(theta) * std::cos(phi), radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta) };
+}
+
+std::vector<Triangle3df> mesh(size_t rings) {
+  std::vector<Triangle3df> triangles;
+  for (size_t ring = 0u; ring < rings; ring++) {
+    float theta0 = PI * ring / rings;
+    float theta1 = PI * (ring + 1u) / rings;
+    for (size_t segment = 0u; segment < rings; segment++) {
+      float phi0 = 2.0f * PI * segment / rings;
+      float phi1 = 2.0f * PI * (segment + 1u) / rings;
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0), bumpy_sphere(theta1, phi0), bumpy_sphere(theta1, phi1) } );
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0), bumpy_sphere(theta1, phi1), bumpy_sphere(theta0, phi1) } );
+    }
+  }
+  return triangles;
+}
+
+std::vector<Sphere3df> spheres(size_t count, float size, float radius) {
+  VectorRandom3df random{3u};
+  std::vector<Vector3df> centers(count, Vector3df{});
+  random.in_box({-size, -size, -size}, {size, size, size}, centers);
+  std::vector<Sphere3df> result;
+  for (const Vector3df & center : centers) {
+    result.push_back( Sphere3df{ center, radius } );
+  }
+  return result;
+}
+
+}
+
+int main() {
+  std::vector<Sphere3df> few = spheres(1000u, 50.0f, 1.0f);
+  std::vector<ShadowRay> rays = shadow_rays({-50.0f, -50.0f, -50.0f}, {50.0f, 50.0f, 50.0f}, {0.0f, 200.0f, 0.0f});
+  compare("1000 spheres one by one", rays, [&](const Ray3df & ray, float distance) {
+    Intersection_Context<float, 3u> candidate;
+    float closest = INFINITY;
+    for (const Sphere3df & sphere : few) {
+      if (sphere.intersects(ray, candidate) && candidate.t < closest) {
+        closest = candidate.t;
+      }
+    }
+    return closest < distance;
+  }, [&](const Ray3df & ray, float distance) {
+    return occluded<float, 3u>(few, ray, distance);
+  });
+
+  SphereBVH3df asteroids{spheres(100000u, 100.0f, 0.5f)};
+  rays = shadow_rays({-100.0f, -100.0f, -100.0f}, {100.0f, 100.0f, 100.0f}, {0.0f, 300.0f, 0.0f});
+  compare("100k spheres in a BVH", rays, [&](const Ray3df & ray, float distance) {
+    Intersection_Context<float, 3u> context;
+    return asteroids.closest_hit(ray, context) && context.t < distance;
+  }, [&](const Ray3df & ray, float distance) {
+    return asteroids.occluded(ray, distance);
+  });
+
+  BVH3df bumpy{mesh(316u)};
+  rays = shadow_rays({-1.5f, -1.5f, -1.5f}, {1.5f, 1.5f, 1.5f}, {0.0f, 5.0f, 0.0f});
+  compare("200k triangles in a BVH", rays, [&](const Ray3df & ray, float distance) {
+    Intersection_Context<float, 3u> context;
+    return bumpy.closest_hit(ray, context) && context.t < distance;
+  }, [&](const Ray3df & ray, float distance) {
+    return bumpy.occluded(ray, distance);
+  });
+  return 0;
+}
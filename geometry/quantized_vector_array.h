@@ -0,0 +1,74 @@
+#ifndef QUANTIZED_VECTOR_ARRAY_H
+#define QUANTIZED_VECTOR_ARRAY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "math.h"
+#include "vector_array.h"
+
+// an array of Vectors compressed to 16 bits per component, quantized relative to a bounding box:
+// the values of each axis are mapped linearly from [minimum, maximum] to the integers [0, 65535],
+// values outside of the box are clamped to it
+// the error of each component is at most (maximum - minimum) / 131070, e.g. 0.008 for positions
+// on a 1024 pixel wide screen or 1.6e-5 for the components of unit normals in the box [-1, 1]
+// like VectorArray the values of each axis are stored contiguously, so that pack and unpack
+// from and to a VectorArray are plain loops, which the compiler turns into SIMD instructions
+// a Vector<float, 3u> needs 6 instead of 12 bytes, which halves the memory traffic of bulk arrays
+template<class FLOAT_TYPE, size_t N>
+class QuantizedVectorArray {
+  static_assert(N > 0u); // no zero length vectors allowed
+
+  static constexpr FLOAT_TYPE LEVELS = 65535.0;
+
+  Vector<FLOAT_TYPE, N> minimum;
+  Vector<FLOAT_TYPE, N> maximum;
+  Vector<FLOAT_TYPE, N> step;      // the difference of consecutive quantized values per axis
+  Vector<FLOAT_TYPE, N> inverse_step;
+
+  // index 0, 1, 2, ... corresponds to x,y,z,... axis
+  std::array<std::vector<std::uint16_t>, N> axes;
+
+  // returns the nearest quantized value of value (already scaled to [0, 65535]), clamped to the box
+  static std::uint16_t quantize(FLOAT_TYPE value);
+public:
+  // creates an array of size Vectors (set to minimum) quantized relative to the box [minimum, maximum]
+  QuantizedVectorArray(const Vector<FLOAT_TYPE, N> minimum, const Vector<FLOAT_TYPE, N> maximum, size_t size = 0u);
+
+  // returns the number of Vectors stored in this array
+  size_t size() const;
+
+  // changes the number of Vectors, new Vectors are set to minimum
+  void resize(size_t size);
+
+  // returns the corners of the bounding box
+  Vector<FLOAT_TYPE, N> get_minimum() const;
+  Vector<FLOAT_TYPE, N> get_maximum() const;
+
+  // decompresses the i-th Vector
+  Vector<FLOAT_TYPE, N> get(size_t i) const;
+
+  // compresses vector and stores it at index i
+  void set(size_t i, const Vector<FLOAT_TYPE, N> vector);
+
+  // returns the contiguous quantized values of the given axis
+  std::span<const std::uint16_t> axis(size_t axis) const;
+
+  // compresses all Vectors of vectors into this array, which gets the size of vectors
+  void pack(const VectorArray<FLOAT_TYPE, N> & vectors);
+  void pack(std::span<const Vector<FLOAT_TYPE, N>> vectors);
+
+  // decompresses all Vectors of this array into vectors, which gets the size of this array
+  void unpack(VectorArray<FLOAT_TYPE, N> & vectors) const;
+
+  // decompresses the Vectors with the indices start, start + 1, ... into vectors
+  void unpack(std::span<Vector<FLOAT_TYPE, N>> vectors, size_t start = 0u) const;
+};
+
+typedef QuantizedVectorArray<float, 2u> QuantizedVectorArray2df;
+typedef QuantizedVectorArray<float, 3u> QuantizedVectorArray3df;
+typedef QuantizedVectorArray<float, 4u> QuantizedVectorArray4df;
+
+#endif
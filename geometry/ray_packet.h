@@ -0,0 +1,32 @@
+#ifndef RAY_PACKET_H
+#define RAY_PACKET_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include "math.h"
+
+template <class FLOAT, size_t N> struct Ray;
+
+// WIDTH rays, which are intersected together with one SIMD instruction per operation (one ray per lane)
+// the components are stored per axis, e.g. origin[0] holds the x coordinates of all origins
+// packets pay off for coherent rays like the primary rays of neighboring pixels,
+// the intersections return a bit mask of the lanes that hit (bit i for ray i) and the t values per lane
+template <class FLOAT, size_t N, size_t WIDTH>
+struct RayPacket {
+  std::array<std::array<FLOAT, WIDTH>, N> origin,
+                                          direction;
+
+  RayPacket() = default;
+
+  // packs the WIDTH rays
+  explicit RayPacket(std::span<const Ray<FLOAT, N>> rays);
+
+  // returns the ray of the given lane
+  Ray<FLOAT, N> get_ray(size_t lane) const;
+};
+
+typedef RayPacket<float, 3u, 4u> RayPacket4;
+typedef RayPacket<float, 3u, 8u> RayPacket8;
+
+#endif
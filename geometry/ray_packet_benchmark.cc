@@ -0,0 +1,136 @@
+#include "geometry.h"
+#include "vector_random.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// measures the closest hit of camera rays with 64 spheres, boxes and triangles, one ray at a time
+// and in packets of 4 and 8 rays of neighboring pixels, and prints million rays per second
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc vector_random.cc geometry.cc ray_packet.cc ray_packet_benchmark.cc -o ray_packet_benchmark
+// add -mavx to use one AVX register for the packets of 8 rays instead of two SSE registers
+
+namespace {
+
+constexpr size_t IMAGE_SIZE = 256u;
+constexpr size_t PRIMITIVES = 64u;
+constexpr size_t REPETITIONS = 4u;
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+// returns the rays of a camera at z = 5 looking at the origin, rows of neighboring pixels follow each other
+std::vector<Ray3df> camera_rays() {
+  std::vector<Ray3df> rays;
+  for (size_t y = 0u; y < IMAGE_SIZE; y++) {
+    for (size_t x = 0u; x < IMAGE_SIZE; x++) {
+      Vector3df target = { 4.0f * x / IMAGE_SIZE - 2.0f, 4.0f * y / IMAGE_SIZE - 2.0f, 0.0f };
+      rays.push_back( Ray3df{ {0.0f, 0.0f, 5.0f}, target - Vector3df{0.0f, 0.0f, 5.0f} } );
+    }
+  }
+  return rays;
+}
+
+// returns the closest t of each ray with all primitives, one ray at a time
+template <class PRIMITIVE, class INTERSECTS>
+float scalar_closest(const std::vector<Ray3df> & rays, const std::vector<PRIMITIVE> & primitives, INTERSECTS intersects) {
+  float sum = 0.0f;
+  for (const Ray3df & ray : rays) {
+    float closest = INFINITY;
+    for (const PRIMITIVE & primitive : primitives) {
+      float t;
+      if (intersects(primitive, ray, t) && t < closest) {
+        closest = t;
+      }
+    }
+    sum += closest < INFINITY ? closest : 0.0f;
+  }
+  return sum;
+}
+
+// the same with the packets of WIDTH rays
+template <size_t WIDTH, class PRIMITIVE>
+float packet_closest(const std::vector<RayPacket<float, 3u, WIDTH>> & packets, const std::vector<PRIMITIVE> & primitives) {
+  float sum = 0.0f;
+  for (const RayPacket<float, 3u, WIDTH> & packet : packets) {
+    std::array<float, WIDTH> closest, t;
+    closest.fill(INFINITY);
+    for (const PRIMITIVE & primitive : primitives) {
+      std::uint32_t hits = primitive.intersects(packet, t);
+      for (size_t lane = 0u; lane < WIDTH; lane++) {
+        closest[lane] = ((hits >> lane) & 1u) && t[lane] < closest[lane] ? t[lane] : closest[lane];
+      }
+    }
+    for (size_t lane = 0u; lane < WIDTH; lane++) {
+      sum += closest[lane] < INFINITY ? closest[lane] : 0.0f;
+    }
+  }
+  return sum;
+}
+
+template <size_t WIDTH>
+std::vector<RayPacket<float, 3u, WIDTH>> packets(const std::vector<Ray3df> & rays) {
+  std::vector<RayPacket<float, 3u, WIDTH>> packets;
+  for (size_t i = 0u; i < rays.size(); i += WIDTH) {
+    packets.emplace_back( std::span<const Ray3df>{ &rays[i], WIDTH } );
+  }
+  return packets;
+}
+
+// returns million rays per second of the measured function
+template <class FUNCTION>
+double measure(size_t rays, FUNCTION function) {
+  float sum = 0.0f;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < REPETITIONS; repetition++) {
+    sum += function();
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = sum;
+  return REPETITIONS * rays / std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+template <class PRIMITIVE, class INTERSECTS>
+void compare(const std::string & name, const std::vector<Ray3df> & rays, const std::vector<PRIMITIVE> & primitives, INTERSECTS intersects) {
+  std::vector<RayPacket<float, 3u, 4u>> packets4 = packets<4u>(rays);
+  std::vector<RayPacket<float, 3u, 8u>> packets8 = packets<8u>(rays);
+  double scalar = measure(rays.size(), [&]() { return scalar_closest(rays, primitives, intersects); });
+  double packet4 = measure(rays.size(), [&]() { return packet_closest<4u>(packets4, primitives); });
+  double packet8 = measure(rays.size(), [&]() { return packet_closest<8u>(packets8, primitives); });
+  std::cout << name << ": scalar " << scalar << " Mrays/s, packets of 4 " << packet4
+            << " Mrays/s, packets of 8 " << packet8 << " Mrays/s" << std::endl;
+}
+
+}
+
+int main() {
+  std::vector<Ray3df> rays = camera_rays();
+  VectorRandom3df random{5u};
+  std::vector<Vector3df> points(3u * PRIMITIVES, Vector3df{});
+  random.in_box({-2.0f, -2.0f, -2.0f}, {2.0f, 2.0f, 2.0f}, points);
+
+  std::vector<Sphere3df> spheres;
+  std::vector<AABB3df> boxes;
+  std::vector<PrecomputedTriangle3df> triangles;
+  for (size_t i = 0u; i < PRIMITIVES; i++) {
+    spheres.push_back( Sphere3df{ points[3u * i], 0.25f } );
+    boxes.push_back( AABB3df{ points[3u * i], {0.25f, 0.25f, 0.25f} } );
+    Vector3df a = points[3u * i];
+    triangles.push_back( PrecomputedTriangle3df{ Triangle3df{ a, a + 0.25f * points[3u * i + 1u], a + 0.25f * points[3u * i + 2u] } } );
+  }
+
+  compare("spheres", rays, spheres, [](const Sphere3df & sphere, const Ray3df & ray, float & t) {
+    t = sphere.intersects(ray);
+    return t > 0.0f;
+  });
+  compare("boxes", rays, boxes, [](const AABB3df & box, const Ray3df & ray, float & t) {
+    t = 0.0f;
+    return box.intersects(ray);
+  });
+  compare("triangles", rays, triangles, [](const PrecomputedTriangle3df & triangle, const Ray3df & ray, float & t) {
+    Intersection_Context<float, 3u> context;
+    bool hit = triangle.intersects(ray, context);
+    t = context.t;
+    return hit;
+  });
+  return 0;
+}
@@ -0,0 +1,276 @@
+#ifndef RAY_TRACER_TCC
+#define RAY_TRACER_TCC
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include "ray_tracer.h"
+
+template <class FLOAT>
+Image<FLOAT>::Image(size_t width, size_t height)
+  : width(width), height(height), values(3u * width * height, static_cast<FLOAT>(0.0)) { }
+
+template <class FLOAT>
+inline size_t Image<FLOAT>::get_width() const {
+  return width;
+}
+
+template <class FLOAT>
+inline size_t Image<FLOAT>::get_height() const {
+  return height;
+}
+
+template <class FLOAT>
+inline Vector<FLOAT, 3u> Image<FLOAT>::get_pixel(size_t x, size_t y) const {
+  const FLOAT * pixel = &values[3u * (y * width + x)];
+  return { pixel[0], pixel[1], pixel[2] };
+}
+
+template <class FLOAT>
+inline void Image<FLOAT>::set_pixel(size_t x, size_t y, Vector<FLOAT, 3u> color) {
+  FLOAT * pixel = &values[3u * (y * width + x)];
+  for (size_t channel = 0u; channel < 3u; channel++) {
+    pixel[channel] = color[channel];
+  }
+}
+
+template <class FLOAT>
+bool Image<FLOAT>::write_ppm(const std::string & path) const {
+  std::ofstream file{path, std::ios::binary};
+  file << "P6\n" << width << " " << height << "\n255\n";
+  std::vector<unsigned char> bytes(values.size());
+  for (size_t i = 0u; i < values.size(); i++) {
+    FLOAT value = std::clamp<FLOAT>(values[i], 0.0, 1.0);
+    bytes[i] = static_cast<unsigned char>(std::pow(value, static_cast<FLOAT>(1.0 / 2.2)) * 255.0 + 0.5);
+  }
+  file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  return file.good();
+}
+
+// the rows of a PFM go from the bottom to the top, the negative scale marks little endian values
+template <class FLOAT>
+bool Image<FLOAT>::write_pfm(const std::string & path) const {
+  std::ofstream file{path, std::ios::binary};
+  file << "PF\n" << width << " " << height << "\n-1.0\n";
+  std::vector<float> row(3u * width);
+  for (size_t y = height; y-- > 0u; ) {
+    std::copy(values.begin() + 3u * y * width, values.begin() + 3u * (y + 1u) * width, row.begin());
+    file.write(reinterpret_cast<const char *>(row.data()), row.size() * sizeof(float));
+  }
+  return file.good();
+}
+
+template <class FLOAT, size_t N>
+Camera<FLOAT, N>::Camera(Vector<FLOAT, N> position, Vector<FLOAT, N> look_at, Vector<FLOAT, N> up, FLOAT field_of_view)
+  : position(position), forward(look_at - position), right(up), up(up) {
+  forward.normalize();
+  // the cross products are written out, see PrecomputedTriangle::cross
+  right = { forward[1] * up[2] - forward[2] * up[1],
+            forward[2] * up[0] - forward[0] * up[2],
+            forward[0] * up[1] - forward[1] * up[0] };
+  right.normalize();
+  this->up = { right[1] * forward[2] - right[2] * forward[1],
+               right[2] * forward[0] - right[0] * forward[2],
+               right[0] * forward[1] - right[1] * forward[0] };
+  FLOAT scale = std::tan(static_cast<FLOAT>(0.5) * field_of_view);
+  right *= scale;
+  this->up *= scale;
+}
+
+template <class FLOAT, size_t N>
+inline Ray<FLOAT, N> Camera<FLOAT, N>::get_ray(FLOAT x, FLOAT y, size_t width, size_t height) const {
+  FLOAT horizontal = (static_cast<FLOAT>(2.0) * x / width - static_cast<FLOAT>(1.0)) * width / height;
+  FLOAT vertical = static_cast<FLOAT>(1.0) - static_cast<FLOAT>(2.0) * y / height;
+  Vector<FLOAT, N> direction = forward + horizontal * right + vertical * up;
+  direction.normalize();
+  return { position, direction };
+}
+
+template <class FLOAT, size_t N>
+void RayTracer<FLOAT, N>::add_sphere(const Sphere<FLOAT, N> & sphere, const Material<FLOAT> & material) {
+  spheres.push_back(sphere);
+  sphere_materials.push_back(material);
+}
+
+template <class FLOAT, size_t N>
+void RayTracer<FLOAT, N>::add_mesh(std::span<const Triangle<FLOAT, N>> triangles, const Material<FLOAT> & material) {
+  meshes.emplace_back(triangles);
+  mesh_materials.push_back(material);
+}
+
+template <class FLOAT, size_t N>
+void RayTracer<FLOAT, N>::add_light(const Light<FLOAT, N> & light) {
+  lights.push_back(light);
+}
+
+template <class FLOAT, size_t N>
+void RayTracer<FLOAT, N>::set_background(Vector<FLOAT, 3u> color) {
+  background = color;
+}
+
+template <class FLOAT, size_t N>
+void RayTracer<FLOAT, N>::set_max_depth(size_t depth) {
+  max_depth = depth;
+}
+
+template <class FLOAT, size_t N>
+bool RayTracer<FLOAT, N>::closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context, const Material<FLOAT> * & material) const {
+  Intersection_Context<FLOAT, N> candidate;
+  bool hit = false;
+  for (size_t i = 0u; i < spheres.size(); i++) {
+    if (spheres[i].intersects(ray, candidate) && (! hit || candidate.t < context.t)) {
+      context = candidate;
+      material = &sphere_materials[i];
+      hit = true;
+    }
+  }
+  for (size_t i = 0u; i < meshes.size(); i++) {
+    if (meshes[i].closest_hit(ray, candidate) && (! hit || candidate.t < context.t)) {
+      context = candidate;
+      material = &mesh_materials[i];
+      hit = true;
+    }
+  }
+  if (hit) {
+    // the triangle normals are neither normalized nor oriented towards the ray
+    context.normal.normalize();
+    if (context.normal * ray.direction > 0.0) {
+      context.normal = static_cast<FLOAT>(-1.0) * context.normal;
+    }
+  }
+  return hit;
+}
+
+template <class FLOAT, size_t N>
+bool RayTracer<FLOAT, N>::occluded(const Ray<FLOAT, N> & ray, FLOAT distance) const {
+  if (::occluded<FLOAT, N>(spheres, ray, distance)) { // the free function, not this member
+    return true;
+  }
+  for (const BoundingVolumeHierarchy<FLOAT, N> & mesh : meshes) {
+    if (mesh.occluded(ray, distance)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class FLOAT, size_t N>
+Vector<FLOAT, 3u> RayTracer<FLOAT, N>::trace(const Ray<FLOAT, N> & ray, size_t depth, bool inside, size_t & rays) const {
+  rays++;
+  Intersection_Context<FLOAT, N> context;
+  const Material<FLOAT> * material;
+  if (! closest_hit(ray, context, material)) {
+    return background;
+  }
+  const Vector<FLOAT, N> & normal = context.normal;
+  Vector<FLOAT, N> outside = context.intersection + OFFSET * normal;
+
+  FLOAT diffuse = static_cast<FLOAT>(1.0) - material->reflection - material->transparency;
+  Vector<FLOAT, 3u> color = AMBIENT * diffuse * material->color;
+  if (diffuse > 0.0) {
+    for (const Light<FLOAT, N> & light : lights) {
+      Vector<FLOAT, N> direction = light.position - context.intersection;
+      FLOAT distance = direction.length();
+      direction *= static_cast<FLOAT>(1.0) / distance;
+      FLOAT cosine = direction * normal;
+      if (cosine > 0.0) {
+        rays++;
+        if (! occluded(Ray<FLOAT, N>{ outside, direction }, distance)) {
+          for (size_t channel = 0u; channel < 3u; channel++) {
+            color[channel] += diffuse * cosine * material->color[channel] * light.color[channel];
+          }
+        }
+      }
+    }
+  }
+  if (depth >= max_depth) {
+    return color;
+  }
+
+  FLOAT reflection = material->reflection;
+  if (material->transparency > 0.0) {
+    // the ray leaves the object if it runs inside, refract expects the ratio of the indices outside and inside
+    FLOAT ratio = inside ? material->refraction_index : static_cast<FLOAT>(1.0) / material->refraction_index;
+    Vector<FLOAT, N> transmission = ray.direction;
+    if (refract(ratio, normal, ray.direction, transmission)) {
+      transmission.normalize();
+      Ray<FLOAT, N> refracted{ context.intersection - OFFSET * normal, transmission };
+      color += material->transparency * trace(refracted, depth + 1u, ! inside, rays);
+    } else {
+      reflection += material->transparency; // total internal reflection
+    }
+  }
+  if (reflection > 0.0) {
+    Vector<FLOAT, N> direction = ray.direction.get_reflective(normal);
+    direction.normalize();
+    color += reflection * trace(Ray<FLOAT, N>{ outside, direction }, depth + 1u, inside, rays);
+  }
+  return color;
+}
+
+template <class FLOAT, size_t N>
+size_t RayTracer<FLOAT, N>::render_tile(const Camera<FLOAT, N> & camera, Image<FLOAT> & image, size_t tile) const {
+  size_t columns = (image.get_width() + TILE_SIZE - 1u) / TILE_SIZE;
+  size_t x0 = tile % columns * TILE_SIZE;
+  size_t y0 = tile / columns * TILE_SIZE;
+  size_t rays = 0u;
+  for (size_t y = y0; y < std::min(y0 + TILE_SIZE, image.get_height()); y++) {
+    for (size_t x = x0; x < std::min(x0 + TILE_SIZE, image.get_width()); x++) {
+      Ray<FLOAT, N> ray = camera.get_ray(x + static_cast<FLOAT>(0.5), y + static_cast<FLOAT>(0.5), image.get_width(), image.get_height());
+      image.set_pixel(x, y, trace(ray, 0u, false, rays));
+    }
+  }
+  return rays;
+}
+
+// the tiles are dealt out in rows, so that each thread starts with a coherent part of the image,
+// a thread whose queue is empty steals single tiles from the back of the other queues,
+// since no tiles are added while rendering, the work is done when all queues are empty
+template <class FLOAT, size_t N>
+size_t RayTracer<FLOAT, N>::render(const Camera<FLOAT, N> & camera, Image<FLOAT> & image, size_t threads) const {
+  threads = std::max<size_t>(threads, 1u);
+  size_t tiles = ((image.get_width() + TILE_SIZE - 1u) / TILE_SIZE) * ((image.get_height() + TILE_SIZE - 1u) / TILE_SIZE);
+  std::vector<TileQueue> queues(threads);
+  for (size_t tile = 0u; tile < tiles; tile++) {
+    queues[tile * threads / tiles].tiles.push_back(tile);
+  }
+  std::vector<size_t> rays(threads, 0u);
+  auto work = [&](size_t thread) {
+    while (true) {
+      size_t tile = tiles;
+      for (size_t i = 0u; i < threads && tile == tiles; i++) {
+        TileQueue & queue = queues[(thread + i) % threads];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (! queue.tiles.empty()) {
+          if (i == 0u) {
+            tile = queue.tiles.front();
+            queue.tiles.pop_front();
+          } else {
+            tile = queue.tiles.back();
+            queue.tiles.pop_back();
+          }
+        }
+      }
+      if (tile == tiles) {
+        return;
+      }
+      rays[thread] += render_tile(camera, image, tile);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t thread = 1u; thread < threads; thread++) {
+    workers.emplace_back(work, thread);
+  }
+  work(0u);
+  for (std::thread & worker : workers) {
+    worker.join();
+  }
+  size_t sum = 0u;
+  for (size_t count : rays) {
+    sum += count;
+  }
+  return sum;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "ray_tracer.h"
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+// renders a scene with a mirror sphere, a glass sphere and a bumpy mesh on a floor with 1, 2, 4, ... threads
+// up to the number of cores, prints the traced rays per second and writes the image as PPM and PFM
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc geometry.cc ray_packet.cc bvh.cc ray_tracer.cc ray_tracer_benchmark.cc -o ray_tracer_benchmark -pthread
+// with one tile queue per thread the speedup stays close to the number of threads
+
+namespace {
+
+constexpr size_t WIDTH = 640u;
+constexpr size_t HEIGHT = 480u;
+
+// returns the point of a bumpy sphere around center with the given radius
+Vector3df bumpy_sphere(Vector3df center, float radius, float theta, float phi) {
+  radius *= 1.0f + 0.05f * std::sin(8.0f * theta) * std::sin(8.0f * phi);
+  return center + Vector3df{ radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi) };
+}
+
+std::vector<Triangle3df> mesh(Vector3df center, float radius, size_t rings) {
+  std::vector<Triangle3df> triangles;
+  for (size_t ring = 0u; ring < rings; ring++) {
+    float theta0 = PI * ring / rings;
+    float theta1 = PI * (ring + 1u) / rings;
+    for (size_t segment = 0u; segment < rings; segment++) {
+      float phi0 = 2.0f * PI * segment / rings;
+      float phi1 = 2.0f * PI * (segment + 1u) / rings;
+      triangles.push_back( Triangle3df{ bumpy_sphere(center, radius, theta0, phi0), bumpy_sphere(center, radius, theta1, phi0),
+                                        bumpy_sphere(center, radius, theta1, phi1) } );
+      triangles.push_back( Triangle3df{ bumpy_sphere(center, radius, theta0, phi0), bumpy_sphere(center, radius, theta1, phi1),
+                                        bumpy_sphere(center, radius, theta0, phi1) } );
+    }
+  }
+  return triangles;
+}
+
+}
+
+int main() {
+  RayTracer3df tracer;
+  std::vector<Triangle3df> floor = { Triangle3df{ {-20.0f, 0.0f, -20.0f}, {20.0f, 0.0f, -20.0f}, {20.0f, 0.0f, 20.0f} },
+                                     Triangle3df{ {-20.0f, 0.0f, -20.0f}, {20.0f, 0.0f, 20.0f}, {-20.0f, 0.0f, 20.0f} } };
+  tracer.add_mesh(floor, Material<float>{ {0.8f, 0.8f, 0.7f}, 0.1f });
+  std::vector<Triangle3df> bumpy = mesh({ 2.2f, 1.0f, -1.0f }, 1.0f, 100u);
+  tracer.add_mesh(bumpy, Material<float>{ {0.2f, 0.6f, 0.9f} });
+  tracer.add_sphere(Sphere3df{ { -2.2f, 1.0f, -1.0f }, 1.0f }, Material<float>{ {1.0f, 1.0f, 1.0f}, 0.9f });
+  tracer.add_sphere(Sphere3df{ { 0.0f, 1.0f, 0.5f }, 1.0f }, Material<float>{ {1.0f, 1.0f, 1.0f}, 0.05f, 0.9f, 1.5f });
+  for (size_t i = 0u; i < 8u; i++) {
+    float angle = 2.0f * PI * i / 8u;
+    tracer.add_sphere(Sphere3df{ { 4.0f * std::cos(angle), 0.3f, 4.0f * std::sin(angle) - 2.0f }, 0.3f },
+                      Material<float>{ { 0.5f + 0.5f * std::cos(angle), 0.5f, 0.5f - 0.5f * std::cos(angle) } });
+  }
+  tracer.add_light(Light<float, 3u>{ { -5.0f, 8.0f, 6.0f }, { 0.8f, 0.8f, 0.8f } });
+  tracer.add_light(Light<float, 3u>{ { 6.0f, 5.0f, 2.0f }, { 0.4f, 0.4f, 0.5f } });
+  tracer.set_background({ 0.5f, 0.7f, 1.0f });
+  Camera3df camera{ { 0.0f, 2.5f, 7.0f }, { 0.0f, 0.8f, -1.0f }, { 0.0f, 1.0f, 0.0f }, 0.9f };
+
+  Imagef image{WIDTH, HEIGHT};
+  double single = 0.0;
+  size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t threads = 1u; threads <= cores; threads *= 2u) {
+    auto start = std::chrono::steady_clock::now();
+    size_t rays = tracer.render(camera, image, threads);
+    auto end = std::chrono::steady_clock::now();
+    double rays_per_second = rays / std::chrono::duration<double>(end - start).count();
+    single = threads == 1u ? rays_per_second : single;
+    std::cout << threads << " threads: " << rays << " rays, " << rays_per_second / 1.0e6 << " M rays/s, speedup "
+              << rays_per_second / single << std::endl;
+  }
+  std::filesystem::path directory = std::filesystem::temp_directory_path();
+  image.write_ppm((directory / "ray_tracer_benchmark.ppm").string());
+  image.write_pfm((directory / "ray_tracer_benchmark.pfm").string());
+  std::cout << "image written to " << (directory / "ray_tracer_benchmark.ppm").string() << std::endl;
+  return 0;
+}
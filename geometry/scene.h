@@ -0,0 +1,66 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "math.h"
+#include "geometry.h"
+#include "bvh.h"
+
+// a set of spheres and triangles, which are intersected with rays as one:
+// each type is kept in its own contiguous array and intersected with its own loop, so that no virtual
+// functions are called, and the hits of the types are reduced to the closest one
+// each primitive gets an id when it is added, the ids of all types count up together,
+// so that the caller maps a hit to its object, e.g. the material or the game object
+// after build, the rays are intersected with one BoundingVolumeHierarchy per type instead of with each primitive,
+// which pays off for more than a few dozen primitives
+// the triangles are kept only once, before build each one is intersected with Triangle::intersects,
+// after build the hierarchy intersects its own PrecomputedTriangle copies
+template <class FLOAT, size_t N>
+class Scene {
+  static_assert(N == 3u); // the triangles and the hierarchies need three dimensions
+
+  std::vector<Sphere<FLOAT, N>> spheres;
+  std::vector<std::uint32_t> sphere_ids;
+  std::vector<Triangle<FLOAT, N>> triangles;
+  std::vector<std::uint32_t> triangle_ids;
+  std::uint32_t next_id = 0u;
+
+  bool built = false;
+  BoundingVolumeHierarchy<FLOAT, N, Sphere<FLOAT, N>> sphere_hierarchy{ std::span<const Sphere<FLOAT, N>>{} };
+  BoundingVolumeHierarchy<FLOAT, N> triangle_hierarchy{ std::span<const Triangle<FLOAT, N>>{} };
+public:
+  // adds a copy of the sphere, returns its id
+  std::uint32_t add(const Sphere<FLOAT, N> & sphere);
+
+  // adds a copy of the triangle, returns its id
+  std::uint32_t add(const Triangle<FLOAT, N> & triangle);
+
+  // adds copies of the triangles, e.g. a mesh, which get consecutive ids, returns the id of the first one
+  std::uint32_t add(std::span<const Triangle<FLOAT, N>> triangles);
+
+  // returns the number of primitives of all types
+  size_t size() const;
+
+  // builds the hierarchies, adding a primitive afterwards falls back to the loops over all primitives
+  // until build is called again
+  void build();
+
+  // returns true if build was called after the last primitive was added
+  bool is_built() const;
+
+  // returns true if the ray intersects any primitive,
+  // context is set to the intersection with the smallest t (see Sphere::intersects and Triangle::intersects)
+  // and id to the id of the intersected primitive
+  bool closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context, std::uint32_t & id) const;
+
+  // returns true if the ray intersects any primitive before tmax, id is set to the id of the first one found,
+  // which is not the closest one (see Sphere::occluded and Triangle::occluded)
+  bool any_hit(const Ray<FLOAT, N> & ray, FLOAT tmax, std::uint32_t & id) const;
+};
+
+typedef Scene<float, 3u> Scene3df;
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef SCENE_TCC
+#define SCENE_TCC
+
+#include <cassert>
+#include "scene.h"
+
+template <class FLOAT, size_t N>
+std::uint32_t Scene<FLOAT, N>::add(const Sphere<FLOAT, N> & sphere) {
+  assert(next_id < UINT32_MAX);
+  spheres.push_back(sphere);
+  sphere_ids.push_back(next_id);
+  built = false;
+  return next_id++;
+}
+
+template <class FLOAT, size_t N>
+std::uint32_t Scene<FLOAT, N>::add(const Triangle<FLOAT, N> & triangle) {
+  assert(next_id < UINT32_MAX);
+  triangles.push_back(triangle);
+  triangle_ids.push_back(next_id);
+  built = false;
+  return next_id++;
+}
+
+template <class FLOAT, size_t N>
+std::uint32_t Scene<FLOAT, N>::add(std::span<const Triangle<FLOAT, N>> triangles) {
+  std::uint32_t first = next_id;
+  this->triangles.reserve(this->triangles.size() + triangles.size());
+  triangle_ids.reserve(triangle_ids.size() + triangles.size());
+  for (const Triangle<FLOAT, N> & triangle : triangles) {
+    add(triangle);
+  }
+  return first;
+}
+
+template <class FLOAT, size_t N>
+inline size_t Scene<FLOAT, N>::size() const {
+  return next_id;
+}
+
+template <class FLOAT, size_t N>
+void Scene<FLOAT, N>::build() {
+  sphere_hierarchy = BoundingVolumeHierarchy<FLOAT, N, Sphere<FLOAT, N>>{ spheres };
+  triangle_hierarchy = BoundingVolumeHierarchy<FLOAT, N>{ triangles };
+  built = true;
+}
+
+template <class FLOAT, size_t N>
+inline bool Scene<FLOAT, N>::is_built() const {
+  return built;
+}
+
+// the ids of the hierarchies are indices into the array of their type
+template <class FLOAT, size_t N>
+bool Scene<FLOAT, N>::closest_hit(const Ray<FLOAT, N> & ray, Intersection_Context<FLOAT, N> & context, std::uint32_t & id) const {
+  Intersection_Context<FLOAT, N> candidate;
+  std::uint32_t index;
+  bool hit = false;
+  if (built) {
+    if (sphere_hierarchy.closest_hit(ray, candidate, index)) {
+      context = candidate;
+      id = sphere_ids[index];
+      hit = true;
+    }
+    if (triangle_hierarchy.closest_hit(ray, candidate, index) && (! hit || candidate.t < context.t)) {
+      context = candidate;
+      id = triangle_ids[index];
+      hit = true;
+    }
+    return hit;
+  }
+  for (size_t i = 0u; i < spheres.size(); i++) {
+    if (spheres[i].intersects(ray, candidate) && (! hit || candidate.t < context.t)) {
+      context = candidate;
+      id = sphere_ids[i];
+      hit = true;
+    }
+  }
+  for (size_t i = 0u; i < triangles.size(); i++) {
+    if (triangles[i].intersects(ray, candidate) && (! hit || candidate.t < context.t)) {
+      context = candidate;
+      id = triangle_ids[i];
+      hit = true;
+    }
+  }
+  return hit;
+}
+
+template <class FLOAT, size_t N>
+bool Scene<FLOAT, N>::any_hit(const Ray<FLOAT, N> & ray, FLOAT tmax, std::uint32_t & id) const {
+  std::uint32_t index;
+  if (built) {
+    if (sphere_hierarchy.occluded(ray, tmax, index)) {
+      id = sphere_ids[index];
+      return true;
+    }
+    if (triangle_hierarchy.occluded(ray, tmax, index)) {
+      id = triangle_ids[index];
+      return true;
+    }
+    return false;
+  }
+  for (size_t i = 0u; i < spheres.size(); i++) {
+    if (spheres[i].occluded(ray, tmax)) {
+      id = sphere_ids[i];
+      return true;
+    }
+  }
+  for (size_t i = 0u; i < triangles.size(); i++) {
+    if (triangles[i].occluded(ray, tmax)) {
+      id = triangle_ids[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif
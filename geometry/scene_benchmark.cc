@@ -0,0 +1,111 @@
+#include "scene.h"
+#include "vector_random.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// measures closest_hit and any_hit of scenes with mixed spheres and triangles, with a test of each primitive
+// and with the hierarchies after build: 8 spheres and 16 triangles, 1000 of both, and 10k spheres with a
+// mesh of 200k triangles, which is only measured with the hierarchies
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc vector_random.cc geometry.cc ray_packet.cc bvh.cc scene.cc scene_benchmark.cc -o scene_benchmark
+// the hierarchies are faster already for the smallest scene, since most rays miss its boxes,
+// and the time per ray hardly grows with the size of the scene
+
+namespace {
+
+constexpr size_t IMAGE_SIZE = 256u; // rays per axis
+
+volatile size_t sink; // keeps the compiler from removing the measured work
+
+// returns the rays of a camera at distance on the z axis looking at the origin, the image plane has the given size
+std::vector<Ray3df> camera_rays(float distance, float size) {
+  std::vector<Ray3df> rays;
+  for (size_t y = 0u; y < IMAGE_SIZE; y++) {
+    for (size_t x = 0u; x < IMAGE_SIZE; x++) {
+      Vector3df target = { size * x / IMAGE_SIZE - 0.5f * size, size * y / IMAGE_SIZE - 0.5f * size, 0.0f };
+      rays.push_back( Ray3df{ {0.0f, 0.0f, distance}, target - Vector3df{0.0f, 0.0f, distance} } );
+    }
+  }
+  return rays;
+}
+
+// prints the million rays per second of closest_hit and of any_hit up to the image plane
+void measure(const std::string & name, const Scene3df & scene, const std::vector<Ray3df> & rays) {
+  Intersection_Context<float, 3u> context;
+  std::uint32_t id;
+  size_t hits = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (const Ray3df & ray : rays) {
+    hits += scene.closest_hit(ray, context, id) ? id + 1u : 0u;
+  }
+  auto middle = std::chrono::steady_clock::now();
+  for (const Ray3df & ray : rays) {
+    hits += scene.any_hit(ray, 1.0f, id);
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = hits;
+  std::cout << "  " << name << ": closest hit " << rays.size() / std::chrono::duration<double, std::micro>(middle - start).count()
+            << " M rays/s, any hit " << rays.size() / std::chrono::duration<double, std::micro>(end - middle).count() << " M rays/s" << std::endl;
+}
+
+// adds spheres and small triangles at random points in a cube around the origin
+void add_random(Scene3df & scene, size_t spheres, size_t triangles, float size, float radius) {
+  VectorRandom3df random{11u};
+  std::vector<Vector3df> points(spheres + 3u * triangles, Vector3df{});
+  random.in_box({-size, -size, -size}, {size, size, size}, points);
+  for (size_t i = 0u; i < spheres; i++) {
+    scene.add(Sphere3df{ points[i], radius });
+  }
+  for (size_t i = spheres; i < points.size(); i += 3u) {
+    scene.add(Triangle3df{ points[i], points[i] + 0.1f * points[i + 1u], points[i] + 0.1f * points[i + 2u] });
+  }
+}
+
+Vector3df bumpy_sphere(float theta, float phi) {
+  float radius = 1.0f + 0.05f * std::sin(8.0f * theta) * std::sin(8.0f * phi);
+  return { radius * std::sin(theta) * std::cos(phi), radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta) };
+}
+
+std::vector<Triangle3df> mesh(size_t rings) {
+  std::vector<Triangle3df> triangles;
+  for (size_t ring = 0u; ring < rings; ring++) {
+    float theta0 = PI * ring / rings;
+    float theta1 = PI * (ring + 1u) / rings;
+    for (size_t segment = 0u; segment < rings; segment++) {
+      float phi0 = 2.0f * PI * segment / rings;
+      float phi1 = 2.0f * PI * (segment + 1u) / rings;
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0), bumpy_sphere(theta1, phi0), bumpy_sphere(theta1, phi1) } );
+      triangles.push_back( Triangle3df{ bumpy_sphere(theta0, phi0), bumpy_sphere(theta1, phi1), bumpy_sphere(theta0, phi1) } );
+    }
+  }
+  return triangles;
+}
+
+}
+
+int main() {
+  std::vector<Ray3df> rays = camera_rays(10.0f, 6.0f);
+  Scene3df small;
+  add_random(small, 8u, 16u, 2.0f, 0.3f);
+  std::cout << "8 spheres, 16 triangles" << std::endl;
+  measure("each primitive", small, rays);
+  small.build();
+  measure("hierarchies   ", small, rays);
+
+  Scene3df medium;
+  add_random(medium, 1000u, 1000u, 2.0f, 0.05f);
+  std::cout << "1000 spheres, 1000 triangles" << std::endl;
+  measure("each primitive", medium, rays);
+  medium.build();
+  measure("hierarchies   ", medium, rays);
+
+  Scene3df large;
+  add_random(large, 10000u, 0u, 2.0f, 0.02f);
+  large.add(mesh(316u));
+  large.build();
+  std::cout << "10k spheres, 200k triangles" << std::endl;
+  measure("hierarchies   ", large, rays);
+  return 0;
+}
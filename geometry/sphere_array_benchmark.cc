@@ -0,0 +1,102 @@
+#include "sphere_array.h"
+#include "vector_random.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// measures the overlap tests of 2d and 3d spheres: all pairs of 1024 spheres like the physics engine
+// and 4096 x 4096 spheres of two arrays, once with Sphere::intersects(Sphere) per pair and once with the kernels
+// of SphereArray, and prints the time per tested pair
+//   g++ -std=c++20 -O2 -DNDEBUG math.cc vector_array.cc vector_random.cc geometry.cc ray_packet.cc sphere_array.cc sphere_array_benchmark.cc -o sphere_array_benchmark
+// add -mavx to test 8 spheres with one AVX register instead of two SSE registers
+// the kernels are 4 to 6 times faster than the test per pair, in 2d and 3d
+
+namespace {
+
+volatile size_t sink; // keeps the compiler from removing the measured work
+
+// returns count spheres in a box, which are as dense as asteroids in the game: a few overlap each
+template <size_t N>
+std::vector<Sphere<float, N>> spheres(size_t count, unsigned seed) {
+  VectorRandom<float, N> random{seed};
+  std::vector<Vector<float, N>> centers(count, Vector<float, N>{});
+  Vector<float, N> maximum{};
+  for (size_t axis = 0u; axis < N; axis++) {
+    maximum[axis] = N == 2u ? 1024.0f : 256.0f;
+  }
+  random.in_box(Vector<float, N>{}, maximum, centers);
+  std::vector<Sphere<float, N>> result;
+  for (size_t i = 0u; i < count; i++) {
+    result.push_back( Sphere<float, N>{ centers[i], 5.0f + 2.0f * (i % 7) } );
+  }
+  return result;
+}
+
+// repeats test, which returns the number of overlaps, and prints the time per pair
+template <class TEST>
+double measure(const std::string & name, double pairs, size_t repetitions, TEST test) {
+  size_t overlaps = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < repetitions; repetition++) {
+    overlaps = test();
+  }
+  auto end = std::chrono::steady_clock::now();
+  sink = overlaps;
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / (repetitions * pairs);
+  std::cout << "  " << name << ": " << nanoseconds << " ns/pair (" << overlaps << " overlaps)" << std::endl;
+  return nanoseconds;
+}
+
+template <size_t N>
+void compare() {
+  std::cout << N << "d spheres" << std::endl;
+  std::vector<Sphere<float, N>> few = spheres<N>(1024u, 1u);
+  SphereArray<float, N> few_array{few};
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+  double pair_count = few.size() * (few.size() - 1u) / 2.0;
+  double single = measure("1024 spheres, each pair with intersects", pair_count, 200u, [&]() {
+    pairs.clear();
+    for (size_t i = 0u; i < few.size(); i++) {
+      for (size_t j = i + 1u; j < few.size(); j++) {
+        if (few[i].intersects(few[j])) {
+          pairs.emplace_back(i, j);
+        }
+      }
+    }
+    return pairs.size();
+  });
+  double batched = measure("1024 spheres, SphereArray::overlaps    ", pair_count, 200u, [&]() {
+    pairs.clear();
+    return few_array.overlaps(pairs);
+  });
+  std::cout << "  speedup " << single / batched << std::endl;
+
+  std::vector<Sphere<float, N>> many = spheres<N>(4096u, 2u), others = spheres<N>(4096u, 3u);
+  SphereArray<float, N> many_array{many}, others_array{others};
+  pair_count = static_cast<double>(many.size()) * others.size();
+  single = measure("4096 x 4096 spheres, intersects      ", pair_count, 4u, [&]() {
+    pairs.clear();
+    for (size_t i = 0u; i < many.size(); i++) {
+      for (size_t j = 0u; j < others.size(); j++) {
+        if (many[i].intersects(others[j])) {
+          pairs.emplace_back(i, j);
+        }
+      }
+    }
+    return pairs.size();
+  });
+  batched = measure("4096 x 4096 spheres, tiled overlaps  ", pair_count, 4u, [&]() {
+    pairs.clear();
+    return many_array.overlaps(others_array, pairs);
+  });
+  std::cout << "  speedup " << single / batched << std::endl;
+}
+
+}
+
+int main() {
+  compare<2u>();
+  compare<3u>();
+  return 0;
+}
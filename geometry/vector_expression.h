@@ -0,0 +1,121 @@
+#ifndef VECTOR_EXPRESSION_H
+#define VECTOR_EXPRESSION_H
+
+#include <concepts>
+#include <cstddef>
+#include "math.h"
+
+// opt-in expression templates for Vector arithmetic
+// lazy(v) wraps a Vector; +, - and scalar * on wrapped operands build an expression
+// instead of Vector temporaries. The whole expression is evaluated in a single loop
+// when it is converted to a Vector, e.g.
+//   Vector3df p = lazy(ray.origin) + t * lazy(ray.direction);
+// expressions only reference their operands, so they must not outlive them:
+// convert them to a Vector within the same statement instead of storing them with auto
+
+
+// base of all expressions, evaluates the DERIVED expression component by component
+template <class FLOAT_TYPE, size_t N, class DERIVED>
+struct VectorExpression {
+  using value_type = FLOAT_TYPE;
+  static constexpr size_t size = N;
+
+  constexpr operator Vector<FLOAT_TYPE, N>() const {
+    const DERIVED & expression = static_cast<const DERIVED &>(*this);
+    Vector<FLOAT_TYPE, N> result = {};
+    for (size_t i = 0u; i < N; i++) {
+      result[i] = expression[i];
+    }
+    return result;
+  }
+};
+
+template <class E>
+concept VectorExpressionType = std::derived_from<E, VectorExpression<typename E::value_type, E::size, E>>;
+
+template <class E1, class E2>
+concept MatchingVectorExpressions = VectorExpressionType<E1> && VectorExpressionType<E2>
+                                      && std::same_as<typename E1::value_type, typename E2::value_type>
+                                      && E1::size == E2::size;
+
+// a Vector operand of an expression
+template <class FLOAT_TYPE, size_t N>
+struct LazyVector : VectorExpression<FLOAT_TYPE, N, LazyVector<FLOAT_TYPE, N>> {
+  const Vector<FLOAT_TYPE, N> & vector;
+
+  constexpr explicit LazyVector(const Vector<FLOAT_TYPE, N> & vector) : vector(vector) { }
+
+  constexpr FLOAT_TYPE operator[](size_t i) const {
+    return vector[i];
+  }
+};
+
+template <class E1, class E2>
+struct VectorSum : VectorExpression<typename E1::value_type, E1::size, VectorSum<E1, E2>> {
+  E1 value;
+  E2 addend;
+
+  constexpr VectorSum(E1 value, E2 addend) : value(value), addend(addend) { }
+
+  constexpr typename E1::value_type operator[](size_t i) const {
+    return value[i] + addend[i];
+  }
+};
+
+template <class E1, class E2>
+struct VectorDifference : VectorExpression<typename E1::value_type, E1::size, VectorDifference<E1, E2>> {
+  E1 value;
+  E2 minuend;
+
+  constexpr VectorDifference(E1 value, E2 minuend) : value(value), minuend(minuend) { }
+
+  constexpr typename E1::value_type operator[](size_t i) const {
+    return value[i] - minuend[i];
+  }
+};
+
+template <class E>
+struct ScaledVector : VectorExpression<typename E::value_type, E::size, ScaledVector<E>> {
+  typename E::value_type scalar;
+  E value;
+
+  constexpr ScaledVector(typename E::value_type scalar, E value) : scalar(scalar), value(value) { }
+
+  constexpr typename E::value_type operator[](size_t i) const {
+    return scalar * value[i];
+  }
+};
+
+
+// wraps vector to be used as operand of an expression
+template <class FLOAT_TYPE, size_t N>
+constexpr LazyVector<FLOAT_TYPE, N> lazy(const Vector<FLOAT_TYPE, N> & vector) {
+  return LazyVector<FLOAT_TYPE, N>(vector);
+}
+
+template <class E1, class E2> requires MatchingVectorExpressions<E1, E2>
+constexpr VectorSum<E1, E2> operator+(const E1 value, const E2 addend) {
+  return VectorSum<E1, E2>(value, addend);
+}
+
+template <class E1, class E2> requires MatchingVectorExpressions<E1, E2>
+constexpr VectorDifference<E1, E2> operator-(const E1 value, const E2 minuend) {
+  return VectorDifference<E1, E2>(value, minuend);
+}
+
+template <VectorExpressionType E>
+constexpr ScaledVector<E> operator*(const typename E::value_type scalar, const E value) {
+  return ScaledVector<E>(scalar, value);
+}
+
+// the scalar (inner) product is evaluated immediately
+template <class E1, class E2> requires MatchingVectorExpressions<E1, E2>
+constexpr typename E1::value_type operator*(const E1 vector1, const E2 vector2) {
+  typename E1::value_type sc_product = 0.0;
+  for (size_t i = 0u; i < E1::size; i++) {
+    sc_product += vector1[i] * vector2[i];
+  }
+  return sc_product;
+}
+
+#endif
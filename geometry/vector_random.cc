@@ -0,0 +1,7 @@
+#include "vector_random.h"
+
+// template instantiations for the 2- and 3-dimensional float and double cases
+template class VectorRandom<float, 2u>;
+template class VectorRandom<float, 3u>;
+template class VectorRandom<double, 2u>;
+template class VectorRandom<double, 3u>;
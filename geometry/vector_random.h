@@ -0,0 +1,63 @@
+#ifndef VECTOR_RANDOM_H
+#define VECTOR_RANDOM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "math.h"
+
+// the counter-based random number generator Philox2x32-10
+// (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+// returns the two random 32 bit words for the given counter and key,
+// each counter value is computed independently of all others
+constexpr std::array<std::uint32_t, 2u> philox_2x32(std::uint64_t counter, std::uint32_t key);
+
+// generates batches of random Vectors with Philox2x32-10, reproducible from a seed:
+// the same seed and the same sequence of calls give the same samples on every platform
+// the batches are generated in chunks by loops without branches, which the compiler vectorizes
+// (build with -O3 -fno-math-errno to vectorize the square roots of in_annulus and in_disk, too)
+template<class FLOAT_TYPE, size_t N>
+class VectorRandom {
+  static_assert(std::is_floating_point_v<FLOAT_TYPE>);
+
+  // the number of samples generated at once, their random numbers are kept on the stack
+  static constexpr size_t CHUNK_SIZE = 256u;
+
+  std::uint32_t seed;
+  std::uint64_t counter;
+
+  // fills values with numbers uniformly distributed in [0, 1)
+  void unit_uniform(std::span<FLOAT_TYPE> values);
+public:
+  // starts the stream of random numbers of seed at the given counter value
+  explicit VectorRandom(std::uint32_t seed, std::uint64_t counter = 0u);
+
+  // returns the next unused counter value of the stream
+  std::uint64_t get_counter() const;
+
+  // fills values with numbers uniformly distributed in [minimum, maximum)
+  void uniform(FLOAT_TYPE minimum, FLOAT_TYPE maximum, std::span<FLOAT_TYPE> values);
+
+  // fills samples with Vectors uniformly distributed in the box [minimum, maximum) (component wise)
+  void in_box(const Vector<FLOAT_TYPE, N> minimum, const Vector<FLOAT_TYPE, N> maximum, std::span<Vector<FLOAT_TYPE, N>> samples);
+
+  // fills samples with points uniformly distributed on the circle with the given radius around the origin
+  void on_circle(FLOAT_TYPE radius, std::span<Vector<FLOAT_TYPE, N>> samples) requires (N == 2u);
+
+  // fills samples with points uniformly distributed over the area between the circles
+  // with inner_radius and outer_radius around the origin
+  void in_annulus(FLOAT_TYPE inner_radius, FLOAT_TYPE outer_radius, std::span<Vector<FLOAT_TYPE, N>> samples) requires (N == 2u);
+
+  // fills samples with points uniformly distributed over the disk with the given radius around the origin
+  void in_disk(FLOAT_TYPE radius, std::span<Vector<FLOAT_TYPE, N>> samples) requires (N == 2u);
+};
+
+typedef VectorRandom<float, 2u> VectorRandom2df;
+typedef VectorRandom<float, 3u> VectorRandom3df;
+
+// the definitions are needed in every translation unit for constant expressions
+#include "vector_random.tcc"
+
+#endif
@@ -0,0 +1,10 @@
+#include "vector_view.h"
+
+// template instantiations for the 2-, 3- and 4-dimensional float cases
+template class VectorRef<float, 2u>;
+template class VectorRef<float, 3u>;
+template class VectorRef<float, 4u>;
+
+template class VectorView<float, 2u>;
+template class VectorView<float, 3u>;
+template class VectorView<float, 4u>;
@@ -0,0 +1,109 @@
+#ifndef VECTOR_VIEW_H
+#define VECTOR_VIEW_H
+
+#include <cstddef>
+#include <span>
+#include "math.h"
+
+// a non-owning reference to the N scalar values of a Vector stored in external memory,
+// e.g. in a vertex buffer, an array of SDL_Points or a mapped file
+// the i-th value is stored at values[i * stride], so that interleaved (stride 1)
+// and structure of arrays layouts (stride = number of vectors) can be referenced
+// the referenced memory must outlive the VectorRef
+template<class FLOAT_TYPE, size_t N>
+class VectorRef {
+  static_assert(N > 0u); // no zero length vectors allowed
+
+  FLOAT_TYPE * values;
+  std::ptrdiff_t stride;
+public:
+  // refers to values[0], values[stride], ..., values[(N - 1) * stride]
+  constexpr VectorRef(FLOAT_TYPE * values, std::ptrdiff_t stride = 1);
+
+  // refers to the scalar values of vector
+  constexpr VectorRef(Vector<FLOAT_TYPE, N> & vector);
+
+  // a copy refers to the same memory
+  constexpr VectorRef(const VectorRef & ref) = default;
+
+  // assignments copy the values into the referenced memory
+  constexpr VectorRef & operator=(const VectorRef & ref);
+  constexpr VectorRef & operator=(const Vector<FLOAT_TYPE, N> vector);
+
+  // returns a copy of the referenced values
+  constexpr operator Vector<FLOAT_TYPE, N>() const;
+
+  // returns the reference of the i-th scalar component
+  constexpr FLOAT_TYPE & operator[](std::size_t i) const;
+
+  // the same in place operations as for Vector
+  constexpr VectorRef & operator+=(const Vector<FLOAT_TYPE, N> addend);
+  constexpr VectorRef & operator-=(const Vector<FLOAT_TYPE, N> minuend);
+  constexpr VectorRef & operator*=(const FLOAT_TYPE factor);
+  constexpr VectorRef & operator/=(const FLOAT_TYPE factor);
+  constexpr void normalize();
+
+  constexpr FLOAT_TYPE length() const;
+  constexpr FLOAT_TYPE square_of_length() const;
+
+  // the arithmetic operators of Vector, found by argument dependent lookup if an operand is a VectorRef
+  // (the Vector operators are templates, which do not convert their arguments)
+  friend constexpr Vector<FLOAT_TYPE, N> operator+(Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> addend) { return value += addend; }
+  friend constexpr Vector<FLOAT_TYPE, N> operator-(Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> minuend) { return value -= minuend; }
+  friend constexpr Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value) { return value *= scalar; }
+  friend constexpr FLOAT_TYPE operator*(const Vector<FLOAT_TYPE, N> vector1, const Vector<FLOAT_TYPE, N> vector2) { return vector1 * vector2; }
+};
+
+// a non-owning view of size Vectors in external memory
+// the i-th Vector starts at values[i * vector_stride] and its components are component_stride values apart,
+// e.g. vector_stride 6 and component_stride 1 for the positions of interleaved position/normal vertices
+// the referenced memory must outlive the VectorView
+template<class FLOAT_TYPE, size_t N>
+class VectorView {
+  FLOAT_TYPE * values;
+  size_t count;
+  std::ptrdiff_t vector_stride;
+  std::ptrdiff_t component_stride;
+public:
+  class iterator;
+
+  // views size Vectors starting at values
+  constexpr VectorView(FLOAT_TYPE * values, size_t size, std::ptrdiff_t vector_stride = N, std::ptrdiff_t component_stride = 1);
+
+  // views the scalar values of the given Vectors
+  VectorView(std::span<Vector<FLOAT_TYPE, N>> vectors);
+
+  // returns the number of Vectors in this view
+  constexpr size_t size() const;
+
+  // returns a reference to the i-th Vector
+  constexpr VectorRef<FLOAT_TYPE, N> operator[](size_t i) const;
+
+  constexpr iterator begin() const;
+  constexpr iterator end() const;
+};
+
+// iterates over the VectorRefs of a VectorView
+template<class FLOAT_TYPE, size_t N>
+class VectorView<FLOAT_TYPE, N>::iterator {
+  const VectorView * view;
+  size_t i;
+public:
+  constexpr iterator(const VectorView * view, size_t i) : view(view), i(i) { }
+  constexpr VectorRef<FLOAT_TYPE, N> operator*() const { return (*view)[i]; }
+  constexpr iterator & operator++() { i++; return *this; }
+  constexpr bool operator==(const iterator & other) const = default;
+};
+
+typedef VectorRef<float, 2u> VectorRef2df;
+typedef VectorRef<float, 3u> VectorRef3df;
+typedef VectorRef<float, 4u> VectorRef4df;
+
+typedef VectorView<float, 2u> VectorView2df;
+typedef VectorView<float, 3u> VectorView3df;
+typedef VectorView<float, 4u> VectorView4df;
+
+// the definitions are needed in every translation unit, so that the accesses inline into the loops using them
+#include "vector_view.tcc"
+
+#endif
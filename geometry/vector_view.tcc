@@ -0,0 +1,113 @@
+#ifndef VECTOR_VIEW_TCC
+#define VECTOR_VIEW_TCC
+
+#include "vector_view.h"
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N>::VectorRef(FLOAT_TYPE * values, std::ptrdiff_t stride) : values(values), stride(stride) {
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N>::VectorRef(Vector<FLOAT_TYPE, N> & vector) : values(vector.vector.data()), stride(1) {
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N> & VectorRef<FLOAT_TYPE, N>::operator=(const VectorRef<FLOAT_TYPE, N> & ref) {
+  return *this = static_cast<Vector<FLOAT_TYPE, N>>(ref);
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N> & VectorRef<FLOAT_TYPE, N>::operator=(const Vector<FLOAT_TYPE, N> vector) {
+  for (size_t i = 0u; i < N; i++) {
+    (*this)[i] = vector[i];
+  }
+  return *this;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N>::operator Vector<FLOAT_TYPE, N>() const {
+  Vector<FLOAT_TYPE, N> vector = {};
+  for (size_t i = 0u; i < N; i++) {
+    vector[i] = (*this)[i];
+  }
+  return vector;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE & VectorRef<FLOAT_TYPE, N>::operator[](std::size_t i) const {
+  return values[static_cast<std::ptrdiff_t>(i) * stride];
+}
+
+// the operations gather the values into a Vector, so that the Vector kernels can be used,
+// and scatter the result back
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N> & VectorRef<FLOAT_TYPE, N>::operator+=(const Vector<FLOAT_TYPE, N> addend) {
+  return *this = static_cast<Vector<FLOAT_TYPE, N>>(*this) += addend;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N> & VectorRef<FLOAT_TYPE, N>::operator-=(const Vector<FLOAT_TYPE, N> minuend) {
+  return *this = static_cast<Vector<FLOAT_TYPE, N>>(*this) -= minuend;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N> & VectorRef<FLOAT_TYPE, N>::operator*=(const FLOAT_TYPE factor) {
+  return *this = static_cast<Vector<FLOAT_TYPE, N>>(*this) *= factor;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N> & VectorRef<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE factor) {
+  return *this = static_cast<Vector<FLOAT_TYPE, N>>(*this) /= factor;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr void VectorRef<FLOAT_TYPE, N>::normalize() {
+  Vector<FLOAT_TYPE, N> vector = *this;
+  vector.normalize();
+  *this = vector;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE VectorRef<FLOAT_TYPE, N>::length() const {
+  return static_cast<Vector<FLOAT_TYPE, N>>(*this).length();
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE VectorRef<FLOAT_TYPE, N>::square_of_length() const {
+  return static_cast<Vector<FLOAT_TYPE, N>>(*this).square_of_length();
+}
+
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorView<FLOAT_TYPE, N>::VectorView(FLOAT_TYPE * values, size_t size, std::ptrdiff_t vector_stride, std::ptrdiff_t component_stride)
+  : values(values), count(size), vector_stride(vector_stride), component_stride(component_stride) {
+}
+
+template <class FLOAT_TYPE, size_t N>
+VectorView<FLOAT_TYPE, N>::VectorView(std::span<Vector<FLOAT_TYPE, N>> vectors)
+  : VectorView(vectors.empty() ? nullptr : vectors.front().vector.data(), vectors.size(),
+               sizeof(Vector<FLOAT_TYPE, N>) / sizeof(FLOAT_TYPE)) {
+  static_assert(sizeof(Vector<FLOAT_TYPE, N>) % sizeof(FLOAT_TYPE) == 0u); // padded Vectors are skipped by the stride
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr size_t VectorView<FLOAT_TYPE, N>::size() const {
+  return count;
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr VectorRef<FLOAT_TYPE, N> VectorView<FLOAT_TYPE, N>::operator[](size_t i) const {
+  return VectorRef<FLOAT_TYPE, N>{ values + static_cast<std::ptrdiff_t>(i) * vector_stride, component_stride };
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr typename VectorView<FLOAT_TYPE, N>::iterator VectorView<FLOAT_TYPE, N>::begin() const {
+  return iterator{ this, 0u };
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr typename VectorView<FLOAT_TYPE, N>::iterator VectorView<FLOAT_TYPE, N>::end() const {
+  return iterator{ this, count };
+}
+
+#endif
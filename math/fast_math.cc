@@ -0,0 +1,9 @@
+#include "fast_math.h"
+
+// template instantiations of all accuracy tiers for float and double
+template struct FastMath<float, Accuracy::exact>;
+template struct FastMath<float, Accuracy::accurate>;
+template struct FastMath<float, Accuracy::fast>;
+template struct FastMath<double, Accuracy::exact>;
+template struct FastMath<double, Accuracy::accurate>;
+template struct FastMath<double, Accuracy::fast>;
@@ -0,0 +1,45 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+// accuracy tiers of the FastMath approximations, chosen per call site
+// exact    forwards to the standard library (libm)
+// accurate polynomial approximations close to float precision
+// fast     shorter polynomials for visual or game logic purposes
+enum class Accuracy : short { exact, accurate, fast };
+
+// polynomial approximations of sin/cos, atan2 and 1/sqrt without branches,
+// so that the batched variants can be vectorized by the compiler
+// maximum errors measured against libm in double precision:
+//                      accurate (float)  accurate (double)  fast
+//   sincos (absolute)  1.0e-7            3.0e-9             3.0e-5    for |angle| <= 8192 (accurate), |angle| <= 256 (fast)
+//   atan2  (absolute)  3.0e-7            1.0e-8             1.6e-3    radians
+//   rsqrt  (relative)  1.5e-7            4.0e-16            1.8e-3    for positive normal values
+template<class FLOAT_TYPE, Accuracy ACCURACY = Accuracy::accurate>
+struct FastMath {
+  // other scalar types (e.g. Fixed) always use their own sin, cos, atan2 and sqrt functions
+  static constexpr bool APPROXIMATED = ACCURACY != Accuracy::exact && std::is_floating_point_v<FLOAT_TYPE>;
+
+  // stores sin(angle) and cos(angle) (angle in radians) in sine and cosine
+  static void sincos(FLOAT_TYPE angle, FLOAT_TYPE & sine, FLOAT_TYPE & cosine);
+
+  // returns the angle of the point (x, y) in the range [-PI, PI], atan2(0, 0) is 0
+  static FLOAT_TYPE atan2(FLOAT_TYPE y, FLOAT_TYPE x);
+
+  // returns 1 / sqrt(value)
+  static FLOAT_TYPE rsqrt(FLOAT_TYPE value);
+
+  // batched variants, the i-th result is stored at index i of the output spans,
+  // which must be at least as long as the inputs
+  static void sincos(std::span<const FLOAT_TYPE> angles, std::span<FLOAT_TYPE> sines, std::span<FLOAT_TYPE> cosines);
+  static void atan2(std::span<const FLOAT_TYPE> y, std::span<const FLOAT_TYPE> x, std::span<FLOAT_TYPE> angles);
+  static void rsqrt(std::span<const FLOAT_TYPE> values, std::span<FLOAT_TYPE> results);
+};
+
+// the definitions are needed in every translation unit, so the scalar approximations inline into their call sites
+#include "fast_math.tcc"
+
+#endif
@@ -0,0 +1,54 @@
+#include "fast_math.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// throughput of the FastMath accuracy tiers compared to libm (the exact tier),
+// measured with the batched variants over arrays of inputs
+//   g++ -std=c++20 -O3 -fno-math-errno fast_math.cc fast_math_benchmark.cc -o fast_math_benchmark
+
+namespace {
+
+constexpr size_t NO_OF_VALUES = 4096u;
+constexpr size_t REPETITIONS = 2000u;
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+// runs operation REPETITIONS times and prints the average time per value
+// in nanoseconds and the number of values processed per second
+template <class OPERATION>
+void measure(const char * name, const char * accuracy, OPERATION operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < REPETITIONS; repetition++) {
+    operation();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / (REPETITIONS * NO_OF_VALUES);
+  std::cout << name << " " << accuracy << ": " << nanoseconds << " ns/value, " << 1e3 / nanoseconds << " Mvalues/s" << std::endl;
+}
+
+template <Accuracy ACCURACY>
+void benchmark(const char * accuracy, const std::vector<float> & angles, const std::vector<float> & x,
+               const std::vector<float> & y, std::vector<float> & sines, std::vector<float> & cosines) {
+  measure("sincos", accuracy, [&]() { FastMath<float, ACCURACY>::sincos(angles, sines, cosines); sink = sines[7] + cosines[3]; });
+  measure("atan2 ", accuracy, [&]() { FastMath<float, ACCURACY>::atan2(y, x, sines); sink = sines[5]; });
+  measure("rsqrt ", accuracy, [&]() { FastMath<float, ACCURACY>::rsqrt(x, sines); sink = sines[9]; });
+}
+
+}
+
+int main() {
+  std::vector<float> angles, x, y;
+  for (size_t i = 0u; i < NO_OF_VALUES; i++) {
+    angles.push_back( -10.0f + 20.0f * i / NO_OF_VALUES );
+    x.push_back( 0.5f + i % 13 );
+    y.push_back( -3.0f + i % 7 );
+  }
+  std::vector<float> sines(NO_OF_VALUES), cosines(NO_OF_VALUES);
+
+  benchmark<Accuracy::exact>("exact   ", angles, x, y, sines, cosines);
+  benchmark<Accuracy::accurate>("accurate", angles, x, y, sines, cosines);
+  benchmark<Accuracy::fast>("fast    ", angles, x, y, sines, cosines);
+  return 0;
+}
@@ -0,0 +1,11 @@
+#include "fixed_point.h"
+
+// template instantiations of the Q16.16 and Q32.32 formats and their Vectors
+template class Fixed<std::int32_t, 16u>;
+template class Vector<Q16_16, 2u>;
+
+#if defined(__SIZEOF_INT128__)
+template class Fixed<std::int64_t, 32u>;
+template class Vector<Q32_32, 2u>;
+template class Vector<Q32_32, 3u>;
+#endif
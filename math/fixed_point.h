@@ -0,0 +1,138 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "math.h"
+
+// a signed fixed-point number with FRACTION_BITS binary digits after the point, stored in INTEGER
+// it can replace FLOAT_TYPE in Vector, Sphere, BoundingVolumeCircle, Body and Physics:
+// all operations are done with integers only, so results are bit-identical on every platform,
+// compiler and optimization level, which makes simulations reproducible
+//   +, -, * and / saturate at the smallest and largest representable value instead of overflowing,
+//   a division by zero saturates according to the sign of the dividend
+//   sqrt is exact (rounded down), sin and cos interpolate a table with an absolute error below 5e-6,
+//   atan2 uses CORDIC with an absolute error below 5e-9 plus the resolution of the type
+// floating point values are only converted when a Fixed is created from them, e.g. from literals
+// the wide intermediate type of a 64 bit INTEGER is the 128 bit integer of GCC and Clang, other compilers
+// support INTEGERs of up to 32 bits only, i.e. Q16_16 but not Q32_32
+template<class INTEGER, size_t FRACTION_BITS>
+class Fixed {
+  static_assert(std::is_signed_v<INTEGER> && std::is_integral_v<INTEGER>);
+  static_assert(FRACTION_BITS > 0u && FRACTION_BITS < 8u * sizeof(INTEGER) - 1u);
+public:
+  // integer types with twice the width of INTEGER used for intermediate results
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef std::conditional_t<sizeof(INTEGER) <= 4u, std::int64_t, __int128> WIDE;
+  __extension__ typedef std::conditional_t<sizeof(INTEGER) <= 4u, std::uint64_t, unsigned __int128> UNSIGNED_WIDE;
+#else
+  static_assert(sizeof(INTEGER) <= 4u, "a 64 bit INTEGER needs the 128 bit integer of GCC or Clang");
+  typedef std::int64_t WIDE;
+  typedef std::uint64_t UNSIGNED_WIDE;
+#endif
+
+  static constexpr WIDE ONE = WIDE(1) << FRACTION_BITS;
+
+  // creates zero
+  constexpr Fixed();
+
+  // creates the Fixed nearest to value, saturates values out of range, NaN becomes zero
+  constexpr Fixed(double value);
+
+  // creates a Fixed from its raw representation value * 2^FRACTION_BITS
+  static constexpr Fixed from_raw(INTEGER raw);
+
+  // returns the raw representation value * 2^FRACTION_BITS
+  constexpr INTEGER raw() const;
+
+  // returns the wide raw value clamped to the range of INTEGER
+  static constexpr Fixed saturate(WIDE raw);
+
+  explicit constexpr operator double() const;
+  explicit constexpr operator float() const;
+
+  constexpr Fixed operator-() const;
+  constexpr Fixed & operator+=(const Fixed addend);
+  constexpr Fixed & operator-=(const Fixed minuend);
+  constexpr Fixed & operator*=(const Fixed factor);
+  constexpr Fixed & operator/=(const Fixed divisor);
+
+  // the operators are friends found by argument dependent lookup only,
+  // so that literals like 0.5 * value are converted implicitly
+  friend constexpr Fixed operator+(Fixed value, const Fixed addend) { return value += addend; }
+  friend constexpr Fixed operator-(Fixed value, const Fixed minuend) { return value -= minuend; }
+  friend constexpr Fixed operator*(Fixed value, const Fixed factor) { return value *= factor; }
+  friend constexpr Fixed operator/(Fixed value, const Fixed divisor) { return value /= divisor; }
+  friend constexpr bool operator==(const Fixed & value1, const Fixed & value2) = default;
+  friend constexpr std::strong_ordering operator<=>(const Fixed & value1, const Fixed & value2) = default;
+
+private:
+  INTEGER value;
+};
+
+// returns the square root of value (rounded down), zero for negative values
+template<class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> sqrt(Fixed<INTEGER, FRACTION_BITS> value);
+
+// sine and cosine of angle (in radians)
+template<class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> sin(Fixed<INTEGER, FRACTION_BITS> angle);
+
+template<class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> cos(Fixed<INTEGER, FRACTION_BITS> angle);
+
+// returns the angle of the point (x, y) in the range [-PI, PI], atan2(0, 0) is 0
+template<class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> atan2(Fixed<INTEGER, FRACTION_BITS> y, Fixed<INTEGER, FRACTION_BITS> x);
+
+template<class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> fabs(Fixed<INTEGER, FRACTION_BITS> value);
+
+template<class INTEGER, size_t FRACTION_BITS>
+struct std::numeric_limits<Fixed<INTEGER, FRACTION_BITS>> {
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = true;
+  static constexpr bool has_infinity = false;
+  static constexpr bool has_quiet_NaN = false;
+  static constexpr int digits = std::numeric_limits<INTEGER>::digits;
+
+  // the smallest positive value, like for floating point types
+  static constexpr Fixed<INTEGER, FRACTION_BITS> min() { return Fixed<INTEGER, FRACTION_BITS>::from_raw(1); }
+  static constexpr Fixed<INTEGER, FRACTION_BITS> max() { return Fixed<INTEGER, FRACTION_BITS>::from_raw(std::numeric_limits<INTEGER>::max()); }
+  static constexpr Fixed<INTEGER, FRACTION_BITS> lowest() { return Fixed<INTEGER, FRACTION_BITS>::from_raw(std::numeric_limits<INTEGER>::min()); }
+  static constexpr Fixed<INTEGER, FRACTION_BITS> epsilon() { return Fixed<INTEGER, FRACTION_BITS>::from_raw(1); }
+  static constexpr Fixed<INTEGER, FRACTION_BITS> quiet_NaN() { return Fixed<INTEGER, FRACTION_BITS>(); }
+};
+
+// the scalar product accumulates the rounded products with the wide integer type
+// and saturates only once, so that intermediate sums do not saturate
+// the distance test of collisions sums the exact squares of the raw differences, see within below
+template <class INTEGER, size_t FRACTION_BITS, size_t N>
+struct VectorKernels<Fixed<INTEGER, FRACTION_BITS>, N> : ScalarVectorKernels<Fixed<INTEGER, FRACTION_BITS>, N> {
+  static constexpr Fixed<INTEGER, FRACTION_BITS> dot(const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values1,
+                                                     const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values2);
+
+  static constexpr bool within(const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values1,
+                               const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values2,
+                               const Fixed<INTEGER, FRACTION_BITS> distance);
+};
+
+// Q16.16 covers [-32768, 32768) with a resolution of 1.5e-5, squares saturate above 181
+// Q32.32 covers [-2^31, 2^31) with a resolution of 2.3e-10 and is the choice for simulations (GCC and Clang only)
+typedef Fixed<std::int32_t, 16u> Q16_16;
+typedef Fixed<std::int64_t, 32u> Q32_32;
+
+typedef Vector<Q16_16, 2u> Vector2dq16;
+typedef Vector<Q32_32, 2u> Vector2dq32;
+typedef Vector<Q32_32, 3u> Vector3dq32;
+
+// the definitions are needed in every translation unit for constant expressions
+#include "fixed_point.tcc"
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef FIXED_POINT_TCC
+#define FIXED_POINT_TCC
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include "fixed_point.h"
+
+// the tables below are computed by the compiler with double arithmetic (which is exact IEEE arithmetic
+// in constant expressions) and rounded to 30 fraction bits, so they are identical for every build
+
+// sine of x for |x| <= PI/2 by its Taylor series
+constexpr double taylor_sine(double x) {
+  double term = x;
+  double sine = x;
+  for (int i = 1; i < 30; i++) {
+    term *= -x * x / ((2 * i) * (2 * i + 1));
+    sine += term;
+  }
+  return sine;
+}
+
+// arc tangent of x for |x| <= 0.5 by its Taylor series
+constexpr double taylor_arc_tangent(double x) {
+  double power = x;
+  double arc_tangent = x;
+  for (int i = 1; i < 60; i++) {
+    power *= -x * x;
+    arc_tangent += power / (2 * i + 1);
+  }
+  return arc_tangent;
+}
+
+constexpr std::int64_t round_to_q30(double value) {
+  double scaled = value * 1073741824.0;
+  return static_cast<std::int64_t>(scaled + (scaled >= 0.0 ? 0.5 : -0.5));
+}
+
+// PI/2, PI and 2 ^ 32 / (2 * PI) with 30 fraction bits, 1 / (2 * PI) with 32 fraction bits
+constexpr std::int64_t Q30_HALF_PI = round_to_q30(1.57079632679489661923);
+constexpr std::int64_t Q30_PI = round_to_q30(3.14159265358979323846);
+constexpr std::int64_t Q32_TURNS_PER_RADIAN = 683565276;
+
+// sin(i * PI / 512) for a quarter wave in 256 steps
+constexpr std::array<std::int32_t, 257u> FIXED_SINE_TABLE = []() {
+  std::array<std::int32_t, 257u> table{};
+  for (size_t i = 0u; i < table.size(); i++) {
+    table[i] = static_cast<std::int32_t>( round_to_q30( taylor_sine(1.57079632679489661923 * i / 256.0) ) );
+  }
+  return table;
+}();
+
+// atan(2^-i) for the CORDIC iterations
+constexpr std::array<std::int64_t, 31u> FIXED_ARC_TANGENT_TABLE = []() {
+  std::array<std::int64_t, 31u> table{};
+  table[0] = round_to_q30(0.78539816339744830962);
+  for (size_t i = 1u; i < table.size(); i++) {
+    table[i] = round_to_q30( taylor_arc_tangent(1.0 / (std::int64_t(1) << i)) );
+  }
+  return table;
+}();
+
+// converts a value with 30 fraction bits to FRACTION_BITS fraction bits (rounding to nearest)
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> from_q30(typename Fixed<INTEGER, FRACTION_BITS>::WIDE value) {
+  if constexpr (FRACTION_BITS < 30u) {
+    constexpr size_t SHIFT = 30u - FRACTION_BITS;
+    return Fixed<INTEGER, FRACTION_BITS>::saturate( (value + (decltype(value)(1) << (SHIFT - 1u))) >> SHIFT );
+  } else {
+    return Fixed<INTEGER, FRACTION_BITS>::saturate( value << (FRACTION_BITS - 30u) );
+  }
+}
+
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS>::Fixed() : value(0) { }
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS>::Fixed(double value) : value(0) {
+  double scaled = value * static_cast<double>(ONE);
+  // the limits of INTEGER are powers of two and therefore exact doubles
+  constexpr double LIMIT = -static_cast<double>(std::numeric_limits<INTEGER>::min());
+  if (scaled >= LIMIT) {
+    this->value = std::numeric_limits<INTEGER>::max();
+  } else if (scaled <= -LIMIT) {
+    this->value = std::numeric_limits<INTEGER>::min();
+  } else if (scaled == scaled) {
+    this->value = static_cast<INTEGER>(scaled + (scaled >= 0.0 ? 0.5 : -0.5));
+  }
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> Fixed<INTEGER, FRACTION_BITS>::from_raw(INTEGER raw) {
+  Fixed<INTEGER, FRACTION_BITS> fixed;
+  fixed.value = raw;
+  return fixed;
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr INTEGER Fixed<INTEGER, FRACTION_BITS>::raw() const {
+  return value;
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> Fixed<INTEGER, FRACTION_BITS>::saturate(WIDE raw) {
+  if (raw > std::numeric_limits<INTEGER>::max()) {
+    return from_raw(std::numeric_limits<INTEGER>::max());
+  }
+  if (raw < std::numeric_limits<INTEGER>::min()) {
+    return from_raw(std::numeric_limits<INTEGER>::min());
+  }
+  return from_raw(static_cast<INTEGER>(raw));
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS>::operator double() const {
+  return static_cast<double>(value) / static_cast<double>(ONE);
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS>::operator float() const {
+  return static_cast<float>( static_cast<double>(*this) );
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> Fixed<INTEGER, FRACTION_BITS>::operator-() const {
+  return saturate( -static_cast<WIDE>(value) );
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> & Fixed<INTEGER, FRACTION_BITS>::operator+=(const Fixed addend) {
+  return *this = saturate( static_cast<WIDE>(value) + addend.value );
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> & Fixed<INTEGER, FRACTION_BITS>::operator-=(const Fixed minuend) {
+  return *this = saturate( static_cast<WIDE>(value) - minuend.value );
+}
+
+// the product is rounded to nearest (ties upwards)
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> & Fixed<INTEGER, FRACTION_BITS>::operator*=(const Fixed factor) {
+  WIDE product = static_cast<WIDE>(value) * factor.value;
+  return *this = saturate( (product + (ONE >> 1)) >> FRACTION_BITS );
+}
+
+// the quotient is rounded towards zero
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> & Fixed<INTEGER, FRACTION_BITS>::operator/=(const Fixed divisor) {
+  if (divisor.value == 0) {
+    return *this = from_raw( value > 0 ? std::numeric_limits<INTEGER>::max()
+                                       : (value < 0 ? std::numeric_limits<INTEGER>::min() : 0) );
+  }
+  return *this = saturate( (static_cast<WIDE>(value) << FRACTION_BITS) / divisor.value );
+}
+
+
+// digit by digit square root of an unsigned integer (rounded down)
+template <class UNSIGNED>
+constexpr UNSIGNED integer_sqrt(UNSIGNED value) {
+  UNSIGNED root = 0u;
+  UNSIGNED bit = UNSIGNED(1) << (8u * sizeof(UNSIGNED) - 2u);
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0u) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// sqrt(raw / 2^F) * 2^F = sqrt(raw * 2^F)
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> sqrt(Fixed<INTEGER, FRACTION_BITS> value) {
+  typedef typename Fixed<INTEGER, FRACTION_BITS>::UNSIGNED_WIDE UNSIGNED_WIDE;
+  if (value.raw() <= 0) {
+    return {};
+  }
+  UNSIGNED_WIDE root = integer_sqrt( static_cast<UNSIGNED_WIDE>(value.raw()) << FRACTION_BITS );
+  return Fixed<INTEGER, FRACTION_BITS>::saturate( static_cast<typename Fixed<INTEGER, FRACTION_BITS>::WIDE>(root) );
+}
+
+// sine of a phase in the first quarter, phase is given in units of (PI/2) / 2^30
+constexpr std::int64_t quarter_sine(std::uint32_t phase) {
+  if (phase >= (1u << 30)) {
+    return FIXED_SINE_TABLE[256];
+  }
+  std::uint32_t index = phase >> 22;
+  std::int64_t fraction = phase & ((1u << 22) - 1u);
+  std::int64_t lower = FIXED_SINE_TABLE[index];
+  return lower + (((FIXED_SINE_TABLE[index + 1u] - lower) * fraction) >> 22);
+}
+
+// sine of a full turn phase in units of (2 * PI) / 2^32, the two highest bits select the quadrant
+constexpr std::int64_t phase_sine(std::uint32_t phase) {
+  std::uint32_t quadrant = phase >> 30;
+  std::uint32_t position = phase & ((1u << 30) - 1u);
+  std::int64_t sine = quarter_sine( (quadrant & 1u) ? (1u << 30) - position : position );
+  return (quadrant & 2u) ? -sine : sine;
+}
+
+// converts angle to a phase in units of (2 * PI) / 2^32, the conversion to 32 bits is the modulo 2 * PI
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr std::uint32_t to_phase(Fixed<INTEGER, FRACTION_BITS> angle) {
+  typedef typename Fixed<INTEGER, FRACTION_BITS>::WIDE WIDE;
+  WIDE turns = static_cast<WIDE>(angle.raw()) * Q32_TURNS_PER_RADIAN;
+  return static_cast<std::uint32_t>( static_cast<std::uint64_t>(turns >> FRACTION_BITS) );
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> sin(Fixed<INTEGER, FRACTION_BITS> angle) {
+  return from_q30<INTEGER, FRACTION_BITS>( phase_sine(to_phase(angle)) );
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> cos(Fixed<INTEGER, FRACTION_BITS> angle) {
+  return from_q30<INTEGER, FRACTION_BITS>( phase_sine(to_phase(angle) + (1u << 30)) );
+}
+
+// CORDIC in vectoring mode: (x, y) is rotated by +/- atan(2^-i) towards the x-axis, the rotations add up to the angle
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> atan2(Fixed<INTEGER, FRACTION_BITS> y, Fixed<INTEGER, FRACTION_BITS> x) {
+  typedef typename Fixed<INTEGER, FRACTION_BITS>::WIDE WIDE;
+  WIDE x_value = x.raw();
+  WIDE y_value = y.raw();
+  if (x_value == 0 && y_value == 0) {
+    return {};
+  }
+  // the left half plane is mirrored to the right one
+  std::int64_t angle = 0;
+  if (x_value < 0) {
+    angle = y_value < 0 ? -Q30_PI : Q30_PI;
+    x_value = -x_value;
+    y_value = -y_value;
+  }
+  // small values are scaled up, so that the shifts keep enough digits
+  constexpr WIDE LIMIT = WIDE(1) << (8u * sizeof(WIDE) - 4u);
+  while (x_value < LIMIT && y_value < LIMIT && y_value > -LIMIT) {
+    x_value <<= 1;
+    y_value <<= 1;
+  }
+  x_value >>= 1; // the rotated vector grows by 1.65
+  y_value >>= 1;
+  for (size_t i = 0u; i < FIXED_ARC_TANGENT_TABLE.size(); i++) {
+    WIDE x_shifted = x_value >> i;
+    WIDE y_shifted = y_value >> i;
+    if (y_value > 0) {
+      x_value += y_shifted;
+      y_value -= x_shifted;
+      angle += FIXED_ARC_TANGENT_TABLE[i];
+    } else {
+      x_value -= y_shifted;
+      y_value += x_shifted;
+      angle -= FIXED_ARC_TANGENT_TABLE[i];
+    }
+  }
+  return from_q30<INTEGER, FRACTION_BITS>(angle);
+}
+
+template <class INTEGER, size_t FRACTION_BITS>
+constexpr Fixed<INTEGER, FRACTION_BITS> fabs(Fixed<INTEGER, FRACTION_BITS> value) {
+  return value < Fixed<INTEGER, FRACTION_BITS>() ? -value : value;
+}
+
+
+template <class INTEGER, size_t FRACTION_BITS, size_t N>
+constexpr Fixed<INTEGER, FRACTION_BITS>
+VectorKernels<Fixed<INTEGER, FRACTION_BITS>, N>::dot(const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values1,
+                                                     const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values2) {
+  typedef typename Fixed<INTEGER, FRACTION_BITS>::WIDE WIDE;
+  WIDE sc_product = 0;
+  for (size_t i = 0u; i < N; i++) {
+    WIDE product = static_cast<WIDE>(values1[i].raw()) * values2[i].raw();
+    sc_product += (product + (Fixed<INTEGER, FRACTION_BITS>::ONE >> 1)) >> FRACTION_BITS;
+  }
+  return Fixed<INTEGER, FRACTION_BITS>::saturate(sc_product);
+}
+
+// the raw differences and their squares are exact in the wide types: a difference of two INTEGERs has one bit more,
+// and its square fits into the unsigned wide type, only the sum of the squares can carry out of it,
+// which means the points are farther apart than any distance, so the test is exact without rounding or saturation
+// and costs one wide integer product per axis (one 64 bit multiplication for Q16.16)
+template <class INTEGER, size_t FRACTION_BITS, size_t N>
+constexpr bool VectorKernels<Fixed<INTEGER, FRACTION_BITS>, N>::within(const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values1,
+                                                                       const std::array<Fixed<INTEGER, FRACTION_BITS>, N> & values2,
+                                                                       const Fixed<INTEGER, FRACTION_BITS> distance) {
+  typedef typename Fixed<INTEGER, FRACTION_BITS>::WIDE WIDE;
+  typedef typename Fixed<INTEGER, FRACTION_BITS>::UNSIGNED_WIDE UNSIGNED_WIDE;
+  UNSIGNED_WIDE square = 0u;
+  bool carry = false;
+  for (size_t i = 0u; i < N; i++) {
+    WIDE difference = static_cast<WIDE>(values1[i].raw()) - values2[i].raw();
+    UNSIGNED_WIDE magnitude = difference < 0 ? -static_cast<UNSIGNED_WIDE>(difference) : static_cast<UNSIGNED_WIDE>(difference);
+    UNSIGNED_WIDE term = magnitude * magnitude;
+    square += term;
+    carry |= square < term; // the unsigned sum wrapped around
+  }
+  UNSIGNED_WIDE limit = distance.raw() < 0 ? -static_cast<UNSIGNED_WIDE>(distance.raw()) : static_cast<UNSIGNED_WIDE>(distance.raw());
+  return ! carry && square < limit * limit;
+}
+
+#endif
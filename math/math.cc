@@ -9,6 +9,10 @@ template class Vector<float, 2u>;
 template class Vector<float, 3u>; 
 template class Vector<float, 4u>;
 
+template class Matrix<float, 2u, 2u>;
+template class Matrix<float, 3u, 3u>;
+template class Matrix<float, 4u, 4u>;
+
 
 // instantiations of each template function
 template Vector<float, 2u> operator*(float scalar, Vector<float, 2u> value);
@@ -29,4 +33,8 @@ template Vector<float, 4u> operator-(Vector<float, 4u> value, const Vector<float
 
 template float operator*(Vector<float, 4u> value, const Vector<float, 4u> addend);
 
+template Matrix<float, 2u, 2u> rotation(float angle);
+template Matrix<float, 3u, 3u> affine_2d(Vector<float, 2u> direction, float scale, Vector<float, 2u> translation);
+template Matrix<float, 3u, 3u> affine_2d(float angle, float scale, Vector<float, 2u> translation);
+
 
@@ -1,8 +1,206 @@
+#ifndef MATH_TCC
+#define MATH_TCC
+
 #include <cassert>
+#include <limits>
+#include <type_traits>
 #include "math.h"
+#include "vector_expression.h"
+
+#if defined(__SSE__) && ! defined(MATH_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+// square root usable in constant expressions (Newton iteration starting above the root)
+template <class FLOAT_TYPE>
+constexpr FLOAT_TYPE constexpr_sqrt(FLOAT_TYPE value) {
+  if ( value < 0.0 || value != value ) {
+    return std::numeric_limits<FLOAT_TYPE>::quiet_NaN();
+  }
+  FLOAT_TYPE root = value > 1.0 ? value : 1.0;
+  FLOAT_TYPE next = 0.5 * (root + value / root);
+  while (next < root) {
+    root = next;
+    next = 0.5 * (root + value / root);
+  }
+  return value == 0.0 ? value : root;
+}
+
+// element wise loops used by the Vector operators
+// they work for every FLOAT_TYPE and N and in constant expressions
+template <class FLOAT_TYPE, size_t N>
+struct ScalarVectorKernels {
+  static constexpr void add(std::array<FLOAT_TYPE, N> & values, const std::array<FLOAT_TYPE, N> & addend) {
+    for (size_t i = 0u; i < N; i++) {
+      values[i] += addend[i];
+    }
+  }
+
+  static constexpr void subtract(std::array<FLOAT_TYPE, N> & values, const std::array<FLOAT_TYPE, N> & minuend) {
+    for (size_t i = 0u; i < N; i++) {
+      values[i] -= minuend[i];
+    }
+  }
+
+  static constexpr void multiply(std::array<FLOAT_TYPE, N> & values, const FLOAT_TYPE factor) {
+    for (size_t i = 0u; i < N; i++) {
+      values[i] *= factor;
+    }
+  }
+
+  static constexpr void divide(std::array<FLOAT_TYPE, N> & values, const FLOAT_TYPE factor) {
+    for (size_t i = 0u; i < N; i++) {
+      values[i] /= factor;
+    }
+  }
+
+  static constexpr FLOAT_TYPE dot(const std::array<FLOAT_TYPE, N> & values1, const std::array<FLOAT_TYPE, N> & values2) {
+    FLOAT_TYPE sc_product = 0.0;
+    for (size_t i = 0u; i < N; i++) {
+      sc_product += values1[i] * values2[i];
+    }
+    return sc_product;
+  }
+
+  // returns true iff the distance of the points values1 and values2 is below distance,
+  // compares the squares, which needs no square root
+  static constexpr bool within(const std::array<FLOAT_TYPE, N> & values1, const std::array<FLOAT_TYPE, N> & values2, const FLOAT_TYPE distance) {
+    std::array<FLOAT_TYPE, N> difference = values1;
+    subtract(difference, values2);
+    return dot(difference, difference) < distance * distance;
+  }
+
+  // values = values x factor in the orientation used by Vector::cross_product
+  static constexpr void cross_product(std::array<FLOAT_TYPE, N> & values, const std::array<FLOAT_TYPE, N> & factor) requires (N == 3u) {
+    values = { values[1] * factor[2] - values[2] * factor[1],
+               values[0] * factor[2] - values[2] * factor[0],
+               values[0] * factor[1] - values[1] * factor[0] };
+  }
+};
+
+// kernels used by the Vector operators, specialized below for SIMD capable types
+template <class FLOAT_TYPE, size_t N>
+struct VectorKernels : ScalarVectorKernels<FLOAT_TYPE, N> { };
+
+#if defined(__SSE__) && ! defined(MATH_NO_SIMD)
+// SSE kernels for float Vectors with 2, 3 or 4 components
+// all components fit into one 128 bit register, unused lanes are loaded as zero
+// compile with -DMATH_NO_SIMD to fall back to the generic loops
+// constant expressions always use the generic loops
+template <size_t N> requires (2u <= N && N <= 4u)
+struct VectorKernels<float, N> {
+  // padded Vectors (see VectorPadding) are loaded and stored as four aligned floats,
+  // as values is then the member of a Vector followed by the zero padding,
+  // otherwise it never reads or writes behind the N floats of values
+  static constexpr bool PADDED = VectorPadding<float, N>::PADDED;
+
+  static __m128 load(const std::array<float, N> & values) {
+    if constexpr (PADDED) {
+      return _mm_load_ps(values.data());
+    } else if constexpr (N == 4u) {
+      return _mm_loadu_ps(values.data());
+    } else {
+      __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(values.data()));
+      if constexpr (N == 3u) {
+        return _mm_movelh_ps(xy, _mm_load_ss(values.data() + 2));
+      }
+      return xy;
+    }
+  }
+
+  static void store(std::array<float, N> & values, __m128 lanes) {
+    if constexpr (PADDED) {
+      _mm_store_ps(values.data(), lanes);
+    } else if constexpr (N == 4u) {
+      _mm_storeu_ps(values.data(), lanes);
+    } else {
+      _mm_storel_pi(reinterpret_cast<__m64 *>(values.data()), lanes);
+      if constexpr (N == 3u) {
+        _mm_store_ss(values.data() + 2, _mm_movehl_ps(lanes, lanes));
+      }
+    }
+  }
+
+  // sums and differences of the zero padding stay zero, but 0 * infinity and 0 / 0 do not
+  static __m128 keep_padding_zero(__m128 lanes) {
+    if constexpr (PADDED) {
+      return _mm_movelh_ps(lanes, _mm_unpackhi_ps(lanes, _mm_setzero_ps())); // x y z 0
+    }
+    return lanes;
+  }
+
+  static constexpr void add(std::array<float, N> & values, const std::array<float, N> & addend) {
+    if (std::is_constant_evaluated()) {
+      ScalarVectorKernels<float, N>::add(values, addend);
+    } else {
+      store(values, _mm_add_ps(load(values), load(addend)));
+    }
+  }
+
+  static constexpr void subtract(std::array<float, N> & values, const std::array<float, N> & minuend) {
+    if (std::is_constant_evaluated()) {
+      ScalarVectorKernels<float, N>::subtract(values, minuend);
+    } else {
+      store(values, _mm_sub_ps(load(values), load(minuend)));
+    }
+  }
+
+  static constexpr void multiply(std::array<float, N> & values, const float factor) {
+    if (std::is_constant_evaluated()) {
+      ScalarVectorKernels<float, N>::multiply(values, factor);
+    } else {
+      store(values, keep_padding_zero(_mm_mul_ps(load(values), _mm_set1_ps(factor))));
+    }
+  }
+
+  static constexpr void divide(std::array<float, N> & values, const float factor) {
+    if (std::is_constant_evaluated()) {
+      ScalarVectorKernels<float, N>::divide(values, factor);
+    } else {
+      store(values, keep_padding_zero(_mm_div_ps(load(values), _mm_set1_ps(factor))));
+    }
+  }
+
+  // returns the sum of the four lanes
+  static float sum(__m128 lanes) {
+    __m128 swapped = _mm_shuffle_ps(lanes, lanes, _MM_SHUFFLE(2, 3, 0, 1)); // y x w z
+    __m128 sums = _mm_add_ps(lanes, swapped);                               // x+y x+y z+w z+w
+    return _mm_cvtss_f32(_mm_add_ss(sums, _mm_movehl_ps(swapped, sums)));
+  }
+
+  static constexpr float dot(const std::array<float, N> & values1, const std::array<float, N> & values2) {
+    if (std::is_constant_evaluated()) {
+      return ScalarVectorKernels<float, N>::dot(values1, values2);
+    }
+    return sum(_mm_mul_ps(load(values1), load(values2)));
+  }
+
+  static constexpr bool within(const std::array<float, N> & values1, const std::array<float, N> & values2, const float distance) {
+    if (std::is_constant_evaluated()) {
+      return ScalarVectorKernels<float, N>::within(values1, values2, distance);
+    }
+    __m128 difference = _mm_sub_ps(load(values1), load(values2));
+    return sum(_mm_mul_ps(difference, difference)) < distance * distance;
+  }
+
+  static constexpr void cross_product(std::array<float, N> & values, const std::array<float, N> & factor) requires (N == 3u) {
+    if (std::is_constant_evaluated()) {
+      ScalarVectorKernels<float, N>::cross_product(values, factor);
+    } else {
+      __m128 a = load(values);
+      __m128 b = load(factor);
+      __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+      __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+      __m128 zxy = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+      __m128 xyz = _mm_shuffle_ps(zxy, zxy, _MM_SHUFFLE(3, 0, 2, 1));
+      store(values, _mm_xor_ps(xyz, _mm_set_ps(0.0f, 0.0f, -0.0f, 0.0f))); // y has the opposite sign
+    }
+  }
+};
+#endif
 
 template <class FLOAT_TYPE, size_t N>
-Vector<FLOAT_TYPE, N>::Vector( std::initializer_list<FLOAT_TYPE> values ) {
+constexpr Vector<FLOAT_TYPE, N>::Vector( std::initializer_list<FLOAT_TYPE> values ) : vector{} {
   auto iterator = values.begin();
   for (size_t i = 0u; i < N; i++) {
     if ( iterator != values.end()) {
@@ -19,40 +217,32 @@ Vector<FLOAT_TYPE, N>::Vector(FLOAT_TYPE angle ) {
 }
 
 template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator+=(const Vector<FLOAT_TYPE, N> addend) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] += addend.vector[i];
-  }
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator+=(const Vector<FLOAT_TYPE, N> addend) {
+  VectorKernels<FLOAT_TYPE, N>::add(vector, addend.vector);
   return *this;
 }
 
 template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator-=(const Vector<FLOAT_TYPE, N> minuend) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] -= minuend.vector[i];
-  }
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator-=(const Vector<FLOAT_TYPE, N> minuend) {
+  VectorKernels<FLOAT_TYPE, N>::subtract(vector, minuend.vector);
   return *this;
 }
 
 template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator*=(const FLOAT_TYPE factor) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] *= factor;
-  }
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator*=(const FLOAT_TYPE factor) {
+  VectorKernels<FLOAT_TYPE, N>::multiply(vector, factor);
   return *this;
 }
 
 template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE factor) {
-  for (size_t i = 0u; i < N; i++) {
-    vector[i] /= factor;
-  }
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE factor) {
+  VectorKernels<FLOAT_TYPE, N>::divide(vector, factor);
   return *this;
 }
 
 
 template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value) {
+constexpr Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value) {
   Vector<FLOAT_TYPE, N> scalar_product = value;
 
   scalar_product *= scalar;
@@ -61,47 +251,52 @@ Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value)
 }
 
 template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator+(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> addend) {
+constexpr Vector<FLOAT_TYPE, N> operator+(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> addend) {
   Vector<FLOAT_TYPE, N> sum = value;
   sum += addend;
   return sum;
 }
 
 template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator-(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> minuend) {
+constexpr Vector<FLOAT_TYPE, N> operator-(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> minuend) {
   Vector<FLOAT_TYPE, N> difference = value;
   difference -= minuend;
   return difference;
 }
 
 template <class FLOAT_TYPE, size_t N>  
-FLOAT_TYPE & Vector<FLOAT_TYPE, N>::operator[](std::size_t i) {
+constexpr FLOAT_TYPE & Vector<FLOAT_TYPE, N>::operator[](std::size_t i) {
   return vector[i];
 }
 
 template <class FLOAT_TYPE, size_t N>  
-FLOAT_TYPE Vector<FLOAT_TYPE, N>::operator[](std::size_t i) const {
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::operator[](std::size_t i) const {
   return vector[i];
 }
 
 
 template <class FLOAT_TYPE, size_t N>
-Vector<FLOAT_TYPE, 3u> Vector<FLOAT_TYPE, N>::cross_product(const Vector<FLOAT_TYPE, 3u> v) const {
+constexpr Vector<FLOAT_TYPE, 3u> Vector<FLOAT_TYPE, N>::cross_product(const Vector<FLOAT_TYPE, 3u> v) const {
   assert(N >= 3u);
+  if constexpr (N == 3u) {
+    Vector<FLOAT_TYPE, 3u> product = *this;
+    VectorKernels<FLOAT_TYPE, 3u>::cross_product(product.vector, v.vector);
+    return product;
+  }
   return {this->vector[1] * v.vector[2] - this->vector[2] * v.vector[1],
           this->vector[0] * v.vector[2] - this->vector[2] * v.vector[0],
           this->vector[0] * v.vector[1] - this->vector[1] * v.vector[0] };
 }
 
 template <class FLOAT_TYPE, size_t N>  
-void Vector<FLOAT_TYPE, N>::normalize() {
+constexpr void Vector<FLOAT_TYPE, N>::normalize() {
   *this /= length(); //  +/- INFINITY if length is (near to) zero
 }
 
 template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> Vector<FLOAT_TYPE, N>::get_reflective(Vector<FLOAT_TYPE, N> normal) const {
+constexpr Vector<FLOAT_TYPE, N> Vector<FLOAT_TYPE, N>::get_reflective(Vector<FLOAT_TYPE, N> normal) const {
   assert(0.99999 < normal.square_of_length() && normal.square_of_length()  < 1.000001); 
-  return *this - static_cast<FLOAT_TYPE>(2.0) * (*this * normal ) * normal;
+  return lazy(*this) - static_cast<FLOAT_TYPE>(2.0) * (*this * normal ) * lazy(normal);
 }
 
 template <class FLOAT_TYPE, size_t N>
@@ -112,29 +307,130 @@ FLOAT_TYPE Vector<FLOAT_TYPE, N>::angle(size_t axis_1, size_t axis_2) const {
 
 // Vektorlänge
 template <class FLOAT_TYPE, size_t N>
-inline FLOAT_TYPE Vector<FLOAT_TYPE, N>::length() const
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::length() const
 {
+    if (std::is_constant_evaluated()) {
+      return constexpr_sqrt(square_of_length());
+    }
     return sqrt(square_of_length());
 }
 
 // Quadratische Vektorlänge
 template <class FLOAT_TYPE, size_t N>
-inline FLOAT_TYPE Vector<FLOAT_TYPE, N>::square_of_length() const
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::square_of_length() const
 {
-    FLOAT_TYPE length = 0.0;
-    for (size_t i = 0u; i < N; i++)
-    {
-        length += vector[i] * vector[i];
-    }
-    return length;
+    return VectorKernels<FLOAT_TYPE, N>::dot(vector, vector);
 }
 
 // Skalarprodukt
 template <class F, size_t K>
-F operator*(Vector<F, K> vector1, const Vector<F, K> vector2) {
-  F sc_product = 0.0;
-  for(int i = 0; i < K; i++) {
-    sc_product += vector1[i] * vector2[i];
+constexpr F operator*(Vector<F, K> vector1, const Vector<F, K> vector2) {
+  return VectorKernels<F, K>::dot(vector1.vector, vector2.vector);
+}
+
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Matrix<FLOAT_TYPE, R, C>::Matrix( std::initializer_list<Vector<FLOAT_TYPE, C>> rows )
+  : rows{} {
+  auto iterator = rows.begin();
+  for (size_t i = 0u; i < R; i++) {
+    this->rows[i] = ( iterator != rows.end() ? *iterator++ : Vector<FLOAT_TYPE, C>{} );
+  }
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Matrix<FLOAT_TYPE, R, C> Matrix<FLOAT_TYPE, R, C>::identity() {
+  Matrix<FLOAT_TYPE, R, C> identity = {};
+  for (size_t i = 0u; i < R && i < C; i++) {
+    identity.rows[i][i] = 1.0;
+  }
+  return identity;
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Vector<FLOAT_TYPE, C> & Matrix<FLOAT_TYPE, R, C>::operator[](std::size_t i) {
+  return rows[i];
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Vector<FLOAT_TYPE, C> Matrix<FLOAT_TYPE, R, C>::operator[](std::size_t i) const {
+  return rows[i];
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+constexpr Vector<FLOAT_TYPE, R> Matrix<FLOAT_TYPE, R, C>::operator*(const Vector<FLOAT_TYPE, C> vector) const {
+  Vector<FLOAT_TYPE, R> product = {};
+  for (size_t i = 0u; i < R; i++) {
+    product[i] = rows[i] * vector;
+  }
+  return product;
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+template <size_t K>
+constexpr Matrix<FLOAT_TYPE, R, K> Matrix<FLOAT_TYPE, R, C>::operator*(const Matrix<FLOAT_TYPE, C, K> & matrix) const {
+  Matrix<FLOAT_TYPE, R, K> product = {};
+  for (size_t i = 0u; i < R; i++) {
+    for (size_t j = 0u; j < C; j++) {
+      product.rows[i] += rows[i][j] * matrix.rows[j];
+    }
+  }
+  return product;
+}
+
+// the batched transformations copy the matrix and every input vector into locals
+// and spell out the products, so the loop bodies are free of aliasing and can be vectorized
+template <class FLOAT_TYPE, size_t R, size_t C>
+void Matrix<FLOAT_TYPE, R, C>::transform(std::span<const Vector<FLOAT_TYPE, C>> vectors, std::span<Vector<FLOAT_TYPE, R>> transformed) const {
+  assert(transformed.size() >= vectors.size());
+  const Matrix<FLOAT_TYPE, R, C> matrix = *this;
+  for (size_t k = 0u; k < vectors.size(); k++) {
+    const Vector<FLOAT_TYPE, C> vector = vectors[k];
+    for (size_t i = 0u; i < R; i++) {
+      FLOAT_TYPE value = 0.0;
+      for (size_t j = 0u; j < C; j++) {
+        value += matrix.rows[i][j] * vector[j];
+      }
+      transformed[k][i] = value;
+    }
   }
-  return sc_product;
-}
\ No newline at end of file
+}
+
+template <class FLOAT_TYPE, size_t R, size_t C>
+void Matrix<FLOAT_TYPE, R, C>::transform_points(std::span<const Vector<FLOAT_TYPE, C - 1>> points, std::span<Vector<FLOAT_TYPE, R - 1>> transformed) const {
+  static_assert(R == C);
+  assert(transformed.size() >= points.size());
+  const Matrix<FLOAT_TYPE, R, C> matrix = *this;
+  for (size_t k = 0u; k < points.size(); k++) {
+    const Vector<FLOAT_TYPE, C - 1> point = points[k];
+    for (size_t i = 0u; i < R - 1; i++) {
+      FLOAT_TYPE value = 0.0;
+      for (size_t j = 0u; j < C - 1; j++) {
+        value += matrix.rows[i][j] * point[j];
+      }
+      transformed[k][i] = value + matrix.rows[i][C - 1];
+    }
+  }
+}
+
+template <class FLOAT_TYPE>
+Matrix<FLOAT_TYPE, 2u, 2u> rotation(FLOAT_TYPE angle) {
+  FLOAT_TYPE cos_angle = std::cos(angle);
+  FLOAT_TYPE sin_angle = std::sin(angle);
+  return { {cos_angle, -sin_angle},
+           {sin_angle,  cos_angle} };
+}
+
+template <class FLOAT_TYPE>
+constexpr Matrix<FLOAT_TYPE, 3u, 3u> affine_2d(Vector<FLOAT_TYPE, 2u> direction, FLOAT_TYPE scale, Vector<FLOAT_TYPE, 2u> translation) {
+  return { {scale * direction[0], -scale * direction[1], translation[0]},
+           {scale * direction[1],  scale * direction[0], translation[1]},
+           {0.0, 0.0, 1.0} };
+}
+
+template <class FLOAT_TYPE>
+Matrix<FLOAT_TYPE, 3u, 3u> affine_2d(FLOAT_TYPE angle, FLOAT_TYPE scale, Vector<FLOAT_TYPE, 2u> translation) {
+  return affine_2d(Vector<FLOAT_TYPE, 2u>{ static_cast<FLOAT_TYPE>(std::cos(angle)), static_cast<FLOAT_TYPE>(std::sin(angle)) }, scale, translation);
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include "math.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// micro benchmark suite of all Vector operations for N = 2, 3, 4 and float/double
+// every operation is measured on a single Vector (each call depends on the previous one)
+// and on a large array of Vectors which does not fit into the caches
+// the results are printed as comma separated values, one line per measurement:
+//   operation,type,n,working_set,ns_per_op,gb_per_s
+// gb_per_s counts the bytes of the Vectors read and written by the operation
+// build it twice to compare the SSE kernels against the scalar loops:
+//   g++ -std=c++20 -O2 math.cc math_benchmark.cc -o math_benchmark
+//   g++ -std=c++20 -O2 -DMATH_NO_SIMD math.cc math_benchmark.cc -o math_benchmark_scalar
+
+namespace {
+
+constexpr size_t SINGLE_REPETITIONS = 2000000u;
+constexpr size_t NO_OF_VECTORS = 1u << 20;
+constexpr size_t ARRAY_REPETITIONS = 8u;
+
+volatile double sink; // keeps the compiler from removing the measured work
+
+// forces value to memory, so that the compiler can neither hoist the measured work out of the loop nor remove it
+template <class T>
+inline void escape(T & value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+template <class FLOAT_TYPE>
+const char * type_name() {
+  return sizeof(FLOAT_TYPE) == sizeof(float) ? "float" : "double";
+}
+
+// returns the i-th Vector of the working set, no Vector is a null vector
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> vector(size_t i) {
+  return Vector<FLOAT_TYPE, N>{ static_cast<FLOAT_TYPE>(1.0 + i % 7), static_cast<FLOAT_TYPE>(2.0 - i % 5),
+                                static_cast<FLOAT_TYPE>(0.5 * (i % 3)), static_cast<FLOAT_TYPE>(1.0) };
+}
+
+template <class FLOAT_TYPE, size_t N>
+void report(const char * operation, const char * working_set, double nanoseconds, double operations, size_t bytes_per_operation) {
+  std::cout << operation << "," << type_name<FLOAT_TYPE>() << "," << N << "," << working_set << ","
+            << nanoseconds / operations << "," << bytes_per_operation * operations / nanoseconds << std::endl;
+}
+
+// applies operation SINGLE_REPETITIONS times to the same Vector
+template <class FLOAT_TYPE, size_t N, class OPERATION>
+void measure_single(const char * name, size_t bytes_per_operation, OPERATION operation) {
+  Vector<FLOAT_TYPE, N> value = vector<FLOAT_TYPE, N>(1u);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < SINGLE_REPETITIONS; repetition++) {
+    operation(value);
+    escape(value);
+  }
+  auto end = std::chrono::steady_clock::now();
+  report<FLOAT_TYPE, N>(name, "single", std::chrono::duration<double, std::nano>(end - start).count(),
+                        SINGLE_REPETITIONS, bytes_per_operation);
+}
+
+// applies operation ARRAY_REPETITIONS times to every Vector of vectors
+template <class FLOAT_TYPE, size_t N, class OPERATION>
+void measure_array(const char * name, size_t bytes_per_operation, std::vector<Vector<FLOAT_TYPE, N>> & vectors, OPERATION operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < ARRAY_REPETITIONS; repetition++) {
+    for (auto & value : vectors) {
+      operation(value);
+    }
+    escape(vectors);
+  }
+  auto end = std::chrono::steady_clock::now();
+  report<FLOAT_TYPE, N>(name, "array", std::chrono::duration<double, std::nano>(end - start).count(),
+                        static_cast<double>(ARRAY_REPETITIONS) * vectors.size(), bytes_per_operation);
+}
+
+// measures operation on a single Vector and on the array
+template <class FLOAT_TYPE, size_t N, class OPERATION>
+void measure(const char * name, size_t bytes_per_operation, std::vector<Vector<FLOAT_TYPE, N>> & vectors, OPERATION operation) {
+  measure_single<FLOAT_TYPE, N>(name, bytes_per_operation, operation);
+  measure_array<FLOAT_TYPE, N>(name, bytes_per_operation, vectors, operation);
+}
+
+template <class FLOAT_TYPE, size_t N>
+void benchmark() {
+  constexpr size_t READ = N * sizeof(FLOAT_TYPE);   // the operation only reads the Vector
+  constexpr size_t UPDATE = 2u * READ;               // the operation reads and writes the Vector
+  std::vector<Vector<FLOAT_TYPE, N>> vectors;
+  for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+    vectors.push_back( vector<FLOAT_TYPE, N>(i) );
+  }
+  const Vector<FLOAT_TYPE, N> addend = { 0.25, -0.25, 0.125, 0.5 };
+  Vector<FLOAT_TYPE, N> normal = { 1.0, 1.0, 1.0, 1.0 };
+  normal.normalize();
+  FLOAT_TYPE sum = 0.0;
+
+  measure<FLOAT_TYPE, N>("operator+=", UPDATE, vectors, [&](Vector<FLOAT_TYPE, N> & v) { v += addend; });
+  measure<FLOAT_TYPE, N>("operator*=", UPDATE, vectors, [&](Vector<FLOAT_TYPE, N> & v) { v *= static_cast<FLOAT_TYPE>(-1.0); });
+  measure<FLOAT_TYPE, N>("dot", READ, vectors, [&](Vector<FLOAT_TYPE, N> & v) { sum += v * addend; });
+  measure<FLOAT_TYPE, N>("length", READ, vectors, [&](Vector<FLOAT_TYPE, N> & v) { sum += v.length(); });
+  measure<FLOAT_TYPE, N>("normalize", UPDATE, vectors, [&](Vector<FLOAT_TYPE, N> & v) { v.normalize(); });
+  measure<FLOAT_TYPE, N>("get_reflective", UPDATE, vectors, [&](Vector<FLOAT_TYPE, N> & v) { v = v.get_reflective(normal); });
+  if constexpr (N == 3u) {
+    const Vector<FLOAT_TYPE, 3u> axis = { 0.0, 0.0, 1.0 };
+    measure<FLOAT_TYPE, N>("cross_product", UPDATE, vectors, [&](Vector<FLOAT_TYPE, N> & v) { v = v.cross_product(axis); });
+  }
+  measure<FLOAT_TYPE, N>("angle", READ, vectors, [&](Vector<FLOAT_TYPE, N> & v) { sum += v.angle(0u, 1u); });
+  sink = sum;
+}
+
+}
+
+int main() {
+#if defined(__SSE__) && ! defined(MATH_NO_SIMD)
+  std::cout << "# kernels: SSE" << std::endl;
+#else
+  std::cout << "# kernels: scalar" << std::endl;
+#endif
+  std::cout << "operation,type,n,working_set,ns_per_op,gb_per_s" << std::endl;
+  benchmark<float, 2u>();
+  benchmark<float, 3u>();
+  benchmark<float, 4u>();
+  benchmark<double, 2u>();
+  benchmark<double, 3u>();
+  benchmark<double, 4u>();
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include "quantized_vector_array.h"
+#include "vector_array.h"
+#include <chrono>
+#include <iostream>
+
+// compares streaming over a large array of positions stored as floats (VectorArray)
+// against 16 bit quantized positions (QuantizedVectorArray), which need half the memory traffic
+//   g++ -std=c++20 -O3 vector_array.cc quantized_vector_array.cc quantized_vector_array_benchmark.cc -o quantized_vector_array_benchmark
+// run it with "perf stat -e cache-misses" to compare the cache misses
+
+namespace {
+
+constexpr size_t NO_OF_VECTORS = 1u << 22; // 48 MB as floats, 24 MB quantized
+constexpr size_t REPETITIONS = 20u;
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+// runs operation REPETITIONS times and prints the average time per Vector
+// and the bandwidth of reading bytes_per_vector per Vector
+template <class OPERATION>
+void measure(const char * name, size_t bytes_per_vector, OPERATION operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < REPETITIONS; repetition++) {
+    operation();
+  }
+  auto end = std::chrono::steady_clock::now();
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / (REPETITIONS * NO_OF_VECTORS);
+  std::cout << name << ": " << nanoseconds << " ns/vector, " << bytes_per_vector / nanoseconds << " GB/s" << std::endl;
+}
+
+// returns the number of positions within the box [lower, upper)
+size_t count_inside(const VectorArray3df & positions, const Vector3df lower, const Vector3df upper) {
+  const float * x = positions.axis(0u).data();
+  const float * y = positions.axis(1u).data();
+  const float * z = positions.axis(2u).data();
+  unsigned inside = 0u;
+  for (size_t i = 0u; i < positions.size(); i++) {
+    inside += (x[i] >= lower[0]) & (x[i] < upper[0]) & (y[i] >= lower[1]) & (y[i] < upper[1]) & (z[i] >= lower[2]) & (z[i] < upper[2]);
+  }
+  return inside;
+}
+
+// the same for quantized positions, which are compared with the quantized box
+size_t count_inside(const QuantizedVectorArray3df & positions, const Vector3df lower, const Vector3df upper) {
+  QuantizedVectorArray3df box{ positions.get_minimum(), positions.get_maximum(), 2u };
+  box.set(0u, lower);
+  box.set(1u, upper);
+  const std::uint16_t * x = positions.axis(0u).data();
+  const std::uint16_t * y = positions.axis(1u).data();
+  const std::uint16_t * z = positions.axis(2u).data();
+  const std::uint16_t x0 = box.axis(0u)[0], x1 = box.axis(0u)[1];
+  const std::uint16_t y0 = box.axis(1u)[0], y1 = box.axis(1u)[1];
+  const std::uint16_t z0 = box.axis(2u)[0], z1 = box.axis(2u)[1];
+  unsigned inside = 0u;
+  for (size_t i = 0u; i < positions.size(); i++) {
+    inside += (x[i] >= x0) & (x[i] < x1) & (y[i] >= y0) & (y[i] < y1) & (z[i] >= z0) & (z[i] < z1);
+  }
+  return inside;
+}
+
+}
+
+int main() {
+  VectorArray3df positions;
+  for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+    positions.push_back( Vector3df{ 1.0f * (i % 1024), 0.75f * (i % 1021), 0.5f * (i % 509) } );
+  }
+  QuantizedVectorArray3df quantized{ Vector3df{0.0f, 0.0f, 0.0f}, Vector3df{1024.0f, 768.0f, 256.0f} };
+  VectorArray3df unpacked;
+
+  measure("pack", 3u * sizeof(float), [&]() { quantized.pack(positions); });
+  measure("unpack", 3u * sizeof(std::uint16_t), [&]() { quantized.unpack(unpacked); });
+  const Vector3df lower = {100.0f, 100.0f, 10.0f};
+  const Vector3df upper = {500.0f, 400.0f, 200.0f};
+  std::cout << "inside: " << count_inside(positions, lower, upper) << " floats, "
+            << count_inside(quantized, lower, upper) << " quantized" << std::endl;
+  measure("count inside of floats", 3u * sizeof(float), [&]() { sink = count_inside(positions, lower, upper); });
+  measure("count inside of quantized", 3u * sizeof(std::uint16_t), [&]() { sink = count_inside(quantized, lower, upper); });
+  return 0;
+}
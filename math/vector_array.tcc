@@ -0,0 +1,163 @@
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "vector_array.h"
+
+template <class FLOAT_TYPE, size_t N>
+VectorArray<FLOAT_TYPE, N>::VectorArray(size_t size) {
+  resize(size);
+}
+
+template <class FLOAT_TYPE, size_t N>
+VectorArray<FLOAT_TYPE, N>::VectorArray(std::span<const Vector<FLOAT_TYPE, N>> vectors) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis].reserve(vectors.size());
+  }
+  for (const Vector<FLOAT_TYPE, N> & vector : vectors) {
+    push_back(vector);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+size_t VectorArray<FLOAT_TYPE, N>::size() const {
+  return axes[0].size();
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::resize(size_t size) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis].resize(size, static_cast<FLOAT_TYPE>(0.0));
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::push_back(const Vector<FLOAT_TYPE, N> vector) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis].push_back(vector[axis]);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> VectorArray<FLOAT_TYPE, N>::get(size_t i) const {
+  Vector<FLOAT_TYPE, N> vector = {};
+  for (size_t axis = 0u; axis < N; axis++) {
+    vector[axis] = axes[axis][i];
+  }
+  return vector;
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::set(size_t i, const Vector<FLOAT_TYPE, N> vector) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    axes[axis][i] = vector[axis];
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::span<FLOAT_TYPE> VectorArray<FLOAT_TYPE, N>::axis(size_t axis) {
+  return axes[axis];
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::span<const FLOAT_TYPE> VectorArray<FLOAT_TYPE, N>::axis(size_t axis) const {
+  return axes[axis];
+}
+
+// each kernel runs one plain loop per axis over contiguous values,
+// which the compiler turns into SIMD instructions
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::axpy(FLOAT_TYPE t, const VectorArray<FLOAT_TYPE, N> & vectors) {
+  assert(vectors.size() == size());
+  const size_t count = size();
+  for (size_t axis = 0u; axis < N; axis++) {
+    FLOAT_TYPE * values = axes[axis].data();
+    const FLOAT_TYPE * addends = vectors.axes[axis].data();
+    for (size_t i = 0u; i < count; i++) {
+      values[i] += t * addends[i];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::dot(const VectorArray<FLOAT_TYPE, N> & vectors, std::span<FLOAT_TYPE> products) const {
+  assert(vectors.size() == size() && products.size() >= size());
+  const size_t count = size();
+  for (size_t i = 0u; i < count; i++) {
+    products[i] = 0.0;
+  }
+  for (size_t axis = 0u; axis < N; axis++) {
+    const FLOAT_TYPE * values1 = axes[axis].data();
+    const FLOAT_TYPE * values2 = vectors.axes[axis].data();
+    for (size_t i = 0u; i < count; i++) {
+      products[i] += values1[i] * values2[i];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::dot(const Vector<FLOAT_TYPE, N> vector, std::span<FLOAT_TYPE> products) const {
+  assert(products.size() >= size());
+  const size_t count = size();
+  for (size_t i = 0u; i < count; i++) {
+    products[i] = 0.0;
+  }
+  for (size_t axis = 0u; axis < N; axis++) {
+    const FLOAT_TYPE * values = axes[axis].data();
+    const FLOAT_TYPE factor = vector[axis];
+    for (size_t i = 0u; i < count; i++) {
+      products[i] += values[i] * factor;
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::lengths(std::span<FLOAT_TYPE> lengths) const {
+  dot(*this, lengths);
+  const size_t count = size();
+  for (size_t i = 0u; i < count; i++) {
+    lengths[i] = std::sqrt(lengths[i]);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::normalize() {
+  const size_t count = size();
+  std::vector<FLOAT_TYPE> inverse_lengths(count);
+  lengths(inverse_lengths);
+  for (size_t i = 0u; i < count; i++) {
+    inverse_lengths[i] = static_cast<FLOAT_TYPE>(1.0) / inverse_lengths[i]; //  +/- INFINITY if length is (near to) zero
+  }
+  for (size_t axis = 0u; axis < N; axis++) {
+    FLOAT_TYPE * values = axes[axis].data();
+    for (size_t i = 0u; i < count; i++) {
+      values[i] *= inverse_lengths[i];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> VectorArray<FLOAT_TYPE, N>::minimum() const {
+  Vector<FLOAT_TYPE, N> minimum = { std::numeric_limits<FLOAT_TYPE>::infinity() };
+  for (size_t axis = 0u; axis < N; axis++) {
+    FLOAT_TYPE axis_minimum = minimum[axis];
+    for (FLOAT_TYPE value : axes[axis]) {
+      axis_minimum = value < axis_minimum ? value : axis_minimum;
+    }
+    minimum[axis] = axis_minimum;
+  }
+  return minimum;
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> VectorArray<FLOAT_TYPE, N>::maximum() const {
+  Vector<FLOAT_TYPE, N> maximum = { -std::numeric_limits<FLOAT_TYPE>::infinity() };
+  for (size_t axis = 0u; axis < N; axis++) {
+    FLOAT_TYPE axis_maximum = maximum[axis];
+    for (FLOAT_TYPE value : axes[axis]) {
+      axis_maximum = value > axis_maximum ? value : axis_maximum;
+    }
+    maximum[axis] = axis_maximum;
+  }
+  return maximum;
+}
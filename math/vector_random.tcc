@@ -0,0 +1,121 @@
+#ifndef VECTOR_RANDOM_TCC
+#define VECTOR_RANDOM_TCC
+
+#include <algorithm>
+#include <cmath>
+#include "vector_random.h"
+#include "fast_math.h"
+
+constexpr std::array<std::uint32_t, 2u> philox_2x32(std::uint64_t counter, std::uint32_t key) {
+  constexpr std::uint32_t MULTIPLIER = 0xD256D193u;
+  constexpr std::uint32_t KEY_INCREMENT = 0x9E3779B9u; // golden ratio
+  std::uint32_t x0 = static_cast<std::uint32_t>(counter);
+  std::uint32_t x1 = static_cast<std::uint32_t>(counter >> 32);
+  for (size_t round = 0u; round < 10u; round++) {
+    std::uint64_t product = static_cast<std::uint64_t>(MULTIPLIER) * x0;
+    x0 = static_cast<std::uint32_t>(product >> 32) ^ key ^ x1;
+    x1 = static_cast<std::uint32_t>(product);
+    key += KEY_INCREMENT;
+  }
+  return { x0, x1 };
+}
+
+template <class FLOAT_TYPE, size_t N>
+VectorRandom<FLOAT_TYPE, N>::VectorRandom(std::uint32_t seed, std::uint64_t counter) : seed(seed), counter(counter) {
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::uint64_t VectorRandom<FLOAT_TYPE, N>::get_counter() const {
+  return counter;
+}
+
+// a float uses the upper 24 bits of one word, so each counter value gives two floats,
+// a double uses the upper 53 bits of both words
+template <class FLOAT_TYPE, size_t N>
+void VectorRandom<FLOAT_TYPE, N>::unit_uniform(std::span<FLOAT_TYPE> values) {
+  if constexpr (sizeof(FLOAT_TYPE) <= sizeof(std::uint32_t)) {
+    const size_t pairs = values.size() / 2u;
+    for (size_t i = 0u; i < pairs; i++) {
+      std::array<std::uint32_t, 2u> bits = philox_2x32(counter + i, seed);
+      values[2u * i] = static_cast<FLOAT_TYPE>(bits[0] >> 8) * static_cast<FLOAT_TYPE>(0x1.0p-24);
+      values[2u * i + 1u] = static_cast<FLOAT_TYPE>(bits[1] >> 8) * static_cast<FLOAT_TYPE>(0x1.0p-24);
+    }
+    counter += pairs;
+    if (values.size() % 2u != 0u) {
+      values.back() = static_cast<FLOAT_TYPE>(philox_2x32(counter++, seed)[0] >> 8) * static_cast<FLOAT_TYPE>(0x1.0p-24);
+    }
+  } else {
+    for (size_t i = 0u; i < values.size(); i++) {
+      std::array<std::uint32_t, 2u> bits = philox_2x32(counter + i, seed);
+      std::uint64_t word = (static_cast<std::uint64_t>(bits[0]) << 32) | bits[1];
+      values[i] = static_cast<FLOAT_TYPE>(word >> 11) * static_cast<FLOAT_TYPE>(0x1.0p-53);
+    }
+    counter += values.size();
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorRandom<FLOAT_TYPE, N>::uniform(FLOAT_TYPE minimum, FLOAT_TYPE maximum, std::span<FLOAT_TYPE> values) {
+  unit_uniform(values);
+  const FLOAT_TYPE range = maximum - minimum;
+  for (FLOAT_TYPE & value : values) {
+    value = minimum + range * value;
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorRandom<FLOAT_TYPE, N>::in_box(const Vector<FLOAT_TYPE, N> minimum, const Vector<FLOAT_TYPE, N> maximum,
+                                         std::span<Vector<FLOAT_TYPE, N>> samples) {
+  const Vector<FLOAT_TYPE, N> range = maximum - minimum;
+  std::array<FLOAT_TYPE, CHUNK_SIZE * N> values;
+  for (size_t start = 0u; start < samples.size(); start += CHUNK_SIZE) {
+    const size_t size = std::min(CHUNK_SIZE, samples.size() - start);
+    unit_uniform(std::span<FLOAT_TYPE>(values.data(), size * N));
+    for (size_t i = 0u; i < size; i++) {
+      for (size_t axis = 0u; axis < N; axis++) {
+        samples[start + i][axis] = minimum[axis] + range[axis] * values[i * N + axis];
+      }
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorRandom<FLOAT_TYPE, N>::on_circle(FLOAT_TYPE radius, std::span<Vector<FLOAT_TYPE, N>> samples) requires (N == 2u) {
+  std::array<FLOAT_TYPE, CHUNK_SIZE> angles, sines, cosines;
+  for (size_t start = 0u; start < samples.size(); start += CHUNK_SIZE) {
+    const size_t size = std::min(CHUNK_SIZE, samples.size() - start);
+    uniform(static_cast<FLOAT_TYPE>(-PI), static_cast<FLOAT_TYPE>(PI), std::span<FLOAT_TYPE>(angles.data(), size));
+    FastMath<FLOAT_TYPE>::sincos(std::span<const FLOAT_TYPE>(angles.data(), size), sines, cosines);
+    for (size_t i = 0u; i < size; i++) {
+      samples[start + i] = { radius * cosines[i], radius * sines[i] };
+    }
+  }
+}
+
+// the radius of a point uniformly distributed over the area grows with the square root of a uniform number
+template <class FLOAT_TYPE, size_t N>
+void VectorRandom<FLOAT_TYPE, N>::in_annulus(FLOAT_TYPE inner_radius, FLOAT_TYPE outer_radius,
+                                             std::span<Vector<FLOAT_TYPE, N>> samples) requires (N == 2u) {
+  const FLOAT_TYPE inner_square = inner_radius * inner_radius;
+  const FLOAT_TYPE range = outer_radius * outer_radius - inner_square;
+  std::array<FLOAT_TYPE, CHUNK_SIZE> radii;
+  for (size_t start = 0u; start < samples.size(); start += CHUNK_SIZE) {
+    const size_t size = std::min(CHUNK_SIZE, samples.size() - start);
+    std::span<Vector<FLOAT_TYPE, N>> chunk = samples.subspan(start, size);
+    on_circle(static_cast<FLOAT_TYPE>(1.0), chunk);
+    unit_uniform(std::span<FLOAT_TYPE>(radii.data(), size));
+    for (size_t i = 0u; i < size; i++) {
+      radii[i] = std::sqrt(inner_square + range * radii[i]);
+    }
+    for (size_t i = 0u; i < size; i++) {
+      chunk[i] *= radii[i];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorRandom<FLOAT_TYPE, N>::in_disk(FLOAT_TYPE radius, std::span<Vector<FLOAT_TYPE, N>> samples) requires (N == 2u) {
+  in_annulus(static_cast<FLOAT_TYPE>(0.0), radius, samples);
+}
+
+#endif
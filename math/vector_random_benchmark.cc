@@ -0,0 +1,67 @@
+#include "vector_random.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// compares drawing random Vectors one scalar at a time from std::mt19937 and
+// std::uniform_real_distribution (as the game does) against the batched VectorRandom
+//   g++ -std=c++20 -O3 -fno-math-errno fast_math.cc vector_random.cc vector_random_benchmark.cc -o vector_random_benchmark
+
+namespace {
+
+constexpr size_t NO_OF_SAMPLES = 4096u;
+constexpr size_t REPETITIONS = 2000u;
+
+volatile float sink; // keeps the compiler from removing the measured work
+
+// runs operation REPETITIONS times and prints the average time per sample
+template <class OPERATION>
+void measure(const char * name, std::vector<Vector2df> & samples, OPERATION operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t repetition = 0u; repetition < REPETITIONS; repetition++) {
+    operation();
+    sink = samples[repetition % NO_OF_SAMPLES][0];
+  }
+  auto end = std::chrono::steady_clock::now();
+  double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / (REPETITIONS * NO_OF_SAMPLES);
+  std::cout << name << ": " << nanoseconds << " ns/sample" << std::endl;
+}
+
+}
+
+int main() {
+  std::vector<Vector2df> samples(NO_OF_SAMPLES, Vector2df{});
+  std::mt19937 generator{42u};
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+  VectorRandom2df random{42u};
+
+  measure("box with mt19937", samples, [&]() {
+    for (Vector2df & sample : samples) {
+      sample = { 1024.0f * distribution(generator), 768.0f * distribution(generator) };
+    }
+  });
+  measure("box with VectorRandom", samples, [&]() {
+    random.in_box(Vector2df{0.0f, 0.0f}, Vector2df{1024.0f, 768.0f}, samples);
+  });
+  measure("circle with mt19937", samples, [&]() {
+    for (Vector2df & sample : samples) {
+      float angle = static_cast<float>(2.0 * PI) * distribution(generator);
+      sample = { std::cos(angle), std::sin(angle) };
+    }
+  });
+  measure("circle with VectorRandom", samples, [&]() {
+    random.on_circle(1.0f, samples);
+  });
+  measure("disk with mt19937", samples, [&]() {
+    for (Vector2df & sample : samples) {
+      float angle = static_cast<float>(2.0 * PI) * distribution(generator);
+      float radius = std::sqrt(distribution(generator));
+      sample = { radius * std::cos(angle), radius * std::sin(angle) };
+    }
+  });
+  measure("disk with VectorRandom", samples, [&]() {
+    random.in_disk(1.0f, samples);
+  });
+  return 0;
+}